@@ -30,6 +30,21 @@ class EOS {
   virtual double DMolarDensityDT(std::vector<double>& params) = 0;
   virtual double DMolarDensityDp(std::vector<double>& params) = 0;
 
+  // Density and its derivatives in one call.  EOSs that differentiate
+  // automatically override these to share work between the three.
+  virtual double MassDensityAndDerivatives(std::vector<double>& params,
+          double* dT, double* dp) {
+    *dT = DMassDensityDT(params);
+    *dp = DMassDensityDp(params);
+    return MassDensity(params);
+  }
+  virtual double MolarDensityAndDerivatives(std::vector<double>& params,
+          double* dT, double* dp) {
+    *dT = DMolarDensityDT(params);
+    *dp = DMolarDensityDp(params);
+    return MolarDensity(params);
+  }
+
   // If molar mass is constant, we can take some shortcuts if we need both
   // molar and mass densities.  MolarMass() is undefined if
   // !IsConstantMolarMass()
@@ -55,6 +55,14 @@ class EOSConstantMolarMass : public EOS {
     return DMolarDensityDp(params) * M_;
   }
 
+  virtual double MolarDensityAndDerivatives(std::vector<double>& params,
+          double* dT, double* dp) {
+    double rho = MassDensityAndDerivatives(params, dT, dp) / M_;
+    *dT /= M_;
+    *dp /= M_;
+    return rho;
+  }
+
   virtual bool IsConstantMolarMass() { return true; }
   virtual double MolarMass() { return M_; }
 
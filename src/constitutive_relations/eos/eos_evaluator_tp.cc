@@ -49,7 +49,8 @@ EOSEvaluatorTP::EOSEvaluatorTP(Teuchos::ParameterList& plist) :
 EOSEvaluatorTP::EOSEvaluatorTP(const EOSEvaluatorTP& other) :
     EOSEvaluator(other),
     temp_key_(other.temp_key_),
-    pres_key_(other.pres_key_)
+    pres_key_(other.pres_key_),
+    partials_(other.partials_)
  {}
 
 
@@ -59,204 +60,144 @@ Teuchos::RCP<FieldEvaluator> EOSEvaluatorTP::Clone() const {
 
 
 void EOSEvaluatorTP::EvaluateField_(const Teuchos::Ptr<State>& S,
-                         const std::vector<Teuchos::Ptr<CompositeVector> >& results) {
+                         const std::vector<Teuchos::Ptr<CompositeVector> >& results, bool partials) {
+  EvaluateFieldAndPartials_(S, results, partials_.TakeRequest());
+}
+
+  
+void EOSEvaluatorTP::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
+                                                   Key wrt_key, const std::vector<Teuchos::Ptr<CompositeVector> >& results) {
+  int k = 0;
+  if (wrt_key == temp_key_) {
+    k = 0;
+  } else if (wrt_key == pres_key_) {
+    k = 1;
+  } else {
+    AMANZI_ASSERT(0);
+  }
+
+  partials_.Request();
+  if (!partials_.IsCurrent(Dependencies_(S))) {
+    EvaluateFieldAndPartials_(S, std::vector<Teuchos::Ptr<CompositeVector> >(results.size()), true);
+  }
+  for (int i=0; i!=results.size(); ++i) {
+    *results[i] = *partials_[2*i + k];
+  }
+}
+
+
+std::vector<Teuchos::RCP<const CompositeVector> >
+EOSEvaluatorTP::Dependencies_(const Teuchos::Ptr<State>& S) {
+  std::vector<Teuchos::RCP<const CompositeVector> > deps;
+  deps.push_back(S->GetFieldData(temp_key_));
+  deps.push_back(S->GetFieldData(pres_key_));
+  return deps;
+}
+
+
+void EOSEvaluatorTP::EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+        const std::vector<Teuchos::Ptr<CompositeVector> >& results, bool partials) {
   
   int num_dep = dependencies_.size();  
   std::vector<double> eos_params(num_dep);
 
-  Teuchos::RCP<const CompositeVector> temp = S->GetFieldData(temp_key_);
-  Teuchos::RCP<const CompositeVector> pres = S->GetFieldData(pres_key_);
-
   // Pull dependencies out of state.  
+  std::vector<Teuchos::RCP<const CompositeVector> > deps = Dependencies_(S);
+  const CompositeVector& temp = *deps[0];
+  const CompositeVector& pres = *deps[1];
+
+  // Partials are d/dT and d/dp of each of my_keys_, in that order.
+  std::vector<Teuchos::Ptr<const CompositeVector> > spaces;
+  for (int i=0; i!=my_keys_.size(); ++i) {
+    Teuchos::Ptr<const CompositeVector> space = results[i] != Teuchos::null ?
+        Teuchos::ptr<const CompositeVector>(results[i].get()) : S->GetFieldData(my_keys_[i]).ptr();
+    spaces.push_back(space);
+    spaces.push_back(space);
+  }
+  if (partials) partials_.Record(deps, spaces);
 
-  Teuchos::Ptr<CompositeVector> molar_dens, mass_dens;
+  int molar = -1, mass = -1;
   if (mode_ == EOS_MODE_MOLAR) {
-    molar_dens = results[0];
+    molar = 0;
   } else if (mode_ == EOS_MODE_MASS) {
-    mass_dens = results[0];
+    mass = 0;
   } else {
-    molar_dens = results[0];
-    mass_dens = results[1];
+    molar = 0;
+    mass = 1;
   }
 
-
-  if (molar_dens != Teuchos::null) {
+  if (molar >= 0) {
     // evaluate MolarDensity()
-    for (CompositeVector::name_iterator comp=molar_dens->begin();
-         comp!=molar_dens->end(); ++comp) {
-
-
-      const Epetra_MultiVector& temp_v = *(temp->ViewComponent(*comp,false));
-      const Epetra_MultiVector& pres_v = *(pres->ViewComponent(*comp,false));
-      Epetra_MultiVector& dens_v = *(molar_dens->ViewComponent(*comp,false));
-
-      int count = dens_v.MyLength();
+    for (CompositeVector::name_iterator comp=spaces[2*molar]->begin();
+         comp!=spaces[2*molar]->end(); ++comp) {
+      const Epetra_MultiVector& temp_v = *(temp.ViewComponent(*comp,false));
+      const Epetra_MultiVector& pres_v = *(pres.ViewComponent(*comp,false));
+      double* dT_v = partials ? (*partials_[2*molar]->ViewComponent(*comp,false))[0] : NULL;
+      double* dp_v = partials ? (*partials_[2*molar+1]->ViewComponent(*comp,false))[0] : NULL;
+      Epetra_MultiVector* dens_v = results[molar] != Teuchos::null ?
+          results[molar]->ViewComponent(*comp,false).get() : NULL;
+
+      int count = temp_v.MyLength();
       for (int id=0; id!=count; ++id) {
         
         eos_params[0] = temp_v[0][id];
         eos_params[1] = pres_v[0][id];
        
-        dens_v[0][id] = eos_->MolarDensity(eos_params);
+        double dens = partials ? eos_->MolarDensityAndDerivatives(eos_params,
+                &dT_v[id], &dp_v[id]) : eos_->MolarDensity(eos_params);
                   
-        if (dens_v[0][id] < 0.){
+        if (dens < 0.){
           Errors::Message msg;
           msg<<"Values of pressure and temperature result in negative density\n"<<
             "Pressure: "<< pres_key_ <<", value : "<<pres_v[0][id]<<"\n"<<
             "Temperature: "<< temp_key_ <<", value : "<<temp_v[0][id]<<"\n"<<
-            "Density "<< dens_v[0][id]<<"\n";
+            "Density "<< dens<<"\n";
           Exceptions::amanzi_throw(msg);
         }
-        
+        if (dens_v) (*dens_v)[0][id] = dens;
       }
     }
   }
 
-  if (mass_dens != Teuchos::null) {
-    for (CompositeVector::name_iterator comp=mass_dens->begin();
-         comp!=mass_dens->end(); ++comp) {
+  if (mass >= 0) {
+    for (CompositeVector::name_iterator comp=spaces[2*mass]->begin();
+         comp!=spaces[2*mass]->end(); ++comp) {
       if (mode_ == EOS_MODE_BOTH && eos_->IsConstantMolarMass() &&
-          molar_dens->HasComponent(*comp)) {
+          spaces[2*molar]->HasComponent(*comp)) {
         // calculate MassDensity from MolarDensity and molar mass.
         double M = eos_->MolarMass();
 
-        mass_dens->ViewComponent(*comp,false)->Update(M,
-                *molar_dens->ViewComponent(*comp,false), 0.);
+        if (results[mass] != Teuchos::null) {
+          results[mass]->ViewComponent(*comp,false)->Update(M,
+                  *results[molar]->ViewComponent(*comp,false), 0.);
+        }
+        for (int k=0; partials && k!=2; ++k) {
+          partials_[2*mass+k]->ViewComponent(*comp,false)->Update(M,
+                  *partials_[2*molar+k]->ViewComponent(*comp,false), 0.);
+        }
       } else {
         // evaluate MassDensity() directly
-
-        const Epetra_MultiVector& temp_v = *(temp->ViewComponent(*comp,false));
-        const Epetra_MultiVector& pres_v = *(pres->ViewComponent(*comp,false));
-        Epetra_MultiVector& dens_v = *(mass_dens->ViewComponent(*comp,false));
-
-        int count = dens_v.MyLength();
+        const Epetra_MultiVector& temp_v = *(temp.ViewComponent(*comp,false));
+        const Epetra_MultiVector& pres_v = *(pres.ViewComponent(*comp,false));
+        double* dT_v = partials ? (*partials_[2*mass]->ViewComponent(*comp,false))[0] : NULL;
+        double* dp_v = partials ? (*partials_[2*mass+1]->ViewComponent(*comp,false))[0] : NULL;
+        Epetra_MultiVector* dens_v = results[mass] != Teuchos::null ?
+            results[mass]->ViewComponent(*comp,false).get() : NULL;
+
+        int count = temp_v.MyLength();
         for (int id=0; id!=count; ++id) {
           
           eos_params[0] = temp_v[0][id];
           eos_params[1] = pres_v[0][id];          
-          dens_v[0][id] = eos_->MassDensity(eos_params);
-          AMANZI_ASSERT(dens_v[0][id] > 0.);
+          double dens = partials ? eos_->MassDensityAndDerivatives(eos_params,
+                  &dT_v[id], &dp_v[id]) : eos_->MassDensity(eos_params);
+          AMANZI_ASSERT(dens > 0.);
+          if (dens_v) (*dens_v)[0][id] = dens;
         }
       }
     }
   }
 }
 
-  
-void EOSEvaluatorTP::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
-                                                   Key wrt_key, const std::vector<Teuchos::Ptr<CompositeVector> >& results) {
-  
-  int num_dep = dependencies_.size();  
-  std::vector<double> eos_params(num_dep);
-   
-  // Pull dependencies out of state.  
-  Teuchos::RCP<const CompositeVector> temp = S->GetFieldData(temp_key_);
-  Teuchos::RCP<const CompositeVector> pres = S->GetFieldData(pres_key_);  
-
-  
-  Teuchos::Ptr<CompositeVector> molar_dens, mass_dens;
-  if (mode_ == EOS_MODE_MOLAR) {
-    molar_dens = results[0];
-  } else if (mode_ == EOS_MODE_MASS) {
-    mass_dens = results[0];
-  } else {
-    molar_dens = results[0];
-    mass_dens = results[1];
-  }
-
-  if (wrt_key == pres_key_) {
-    if (molar_dens != Teuchos::null) {
-      // evaluate MolarDensity()
-      for (CompositeVector::name_iterator comp=molar_dens->begin();
-           comp!=molar_dens->end(); ++comp) {
-        const Epetra_MultiVector& temp_v = *(temp->ViewComponent(*comp,false));
-        const Epetra_MultiVector& pres_v = *(pres->ViewComponent(*comp,false));
-        Epetra_MultiVector& dens_v = *(molar_dens->ViewComponent(*comp,false));
-
-        int count = dens_v.MyLength();
-        for (int i=0; i!=count; ++i) {
-          eos_params[0] = temp_v[0][i];
-          eos_params[1] = pres_v[0][i];
-            
-          dens_v[0][i] = eos_->DMolarDensityDp(eos_params);
-        }
-      }
-    }
-
-    if (mass_dens != Teuchos::null) {
-      for (CompositeVector::name_iterator comp=mass_dens->begin();
-           comp!=mass_dens->end(); ++comp) {
-        if (mode_ == EOS_MODE_BOTH && eos_->IsConstantMolarMass() &&
-            molar_dens->HasComponent(*comp)) {
-          // calculate MassDensity from MolarDensity and molar mass.
-          double M = eos_->MolarMass();
-
-          mass_dens->ViewComponent(*comp,false)->Update(M,
-                  *molar_dens->ViewComponent(*comp,false), 0.);
-        } else {
-          // evaluate MassDensity() directly
-          const Epetra_MultiVector& temp_v = *(temp->ViewComponent(*comp,false));
-          const Epetra_MultiVector& pres_v = *(pres->ViewComponent(*comp,false));
-          Epetra_MultiVector& dens_v = *(mass_dens->ViewComponent(*comp,false));
-
-          int count = dens_v.MyLength();
-          for (int i=0; i!=count; ++i) {
-            eos_params[0] = temp_v[0][i];
-            eos_params[1] = pres_v[0][i];            
-            dens_v[0][i] = eos_->DMassDensityDp(eos_params);
-          }
-        }
-      }
-    }
-
-  } else if (wrt_key == temp_key_) {
-
-    if (molar_dens != Teuchos::null) {
-      // evaluate MolarDensity()
-      for (CompositeVector::name_iterator comp=molar_dens->begin();
-           comp!=molar_dens->end(); ++comp) {
-        const Epetra_MultiVector& temp_v = *(temp->ViewComponent(*comp,false));
-        const Epetra_MultiVector& pres_v = *(pres->ViewComponent(*comp,false));
-        Epetra_MultiVector& dens_v = *(molar_dens->ViewComponent(*comp,false));
-
-        int count = dens_v.MyLength();
-        for (int i=0; i!=count; ++i) {
-          eos_params[0] = temp_v[0][i];
-          eos_params[1] = pres_v[0][i];          
-          dens_v[0][i] = eos_->DMolarDensityDT(eos_params);
-        }
-      }
-    }
-
-    if (mass_dens != Teuchos::null) {
-      for (CompositeVector::name_iterator comp=mass_dens->begin();
-           comp!=mass_dens->end(); ++comp) {
-        if (mode_ == EOS_MODE_BOTH && eos_->IsConstantMolarMass() &&
-            molar_dens->HasComponent(*comp)) {
-          // calculate MassDensity from MolarDensity and molar mass.
-          double M = eos_->MolarMass();
-
-          mass_dens->ViewComponent(*comp,false)->Update(M,
-                  *molar_dens->ViewComponent(*comp,false), 0.);
-        } else {
-          // evaluate MassDensity() directly
-          const Epetra_MultiVector& temp_v = *(temp->ViewComponent(*comp,false));
-          const Epetra_MultiVector& pres_v = *(pres->ViewComponent(*comp,false));
-          Epetra_MultiVector& dens_v = *(mass_dens->ViewComponent(*comp,false));
-
-          int count = dens_v.MyLength();
-          for (int i=0; i!=count; ++i) {
-            eos_params[0] = temp_v[0][i];
-            eos_params[1] = pres_v[0][i];            
-            dens_v[0][i] = eos_->DMassDensityDT(eos_params);
-          }
-        }
-      }
-    }
-
-  } else {
-    AMANZI_ASSERT(0);
-  }
-  } 
-
 } // namespace
 } // namespace
@@ -13,6 +13,7 @@
 #include "eos.hh"
 #include "Factory.hh"
 #include "eos_evaluator.hh"
+#include "partials_cache.hh"
 
 namespace Amanzi {
 namespace Relations {
@@ -45,6 +46,15 @@ class EOSEvaluatorTP : public EOSEvaluator {
   Key temp_key_;
   Key pres_key_;
 
+  // Densities, where results are non-null, and, if partials is true, their
+  // derivatives with respect to temperature and pressure, which are kept for
+  // the next derivative request.
+  void EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+          const std::vector<Teuchos::Ptr<CompositeVector> >& results, bool partials);
+  std::vector<Teuchos::RCP<const CompositeVector> > Dependencies_(const Teuchos::Ptr<State>& S);
+
+  PartialsCache partials_;
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,EOSEvaluatorTP> factory_;
 };
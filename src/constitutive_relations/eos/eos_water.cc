@@ -11,6 +11,7 @@
   Authors: Ethan Coon (ecoon@lanl.gov)
 */
 
+#include "dual.hh"
 #include "eos_water.hh"
 
 namespace Amanzi {
@@ -32,15 +33,19 @@ EOSWater::EOSWater(Teuchos::ParameterList& eos_plist) :
 
 
 
+template<class T>
+T EOSWater::MassDensity_(const T& temp, T p) const {
+  if (p < 101325.) p = 101325.;
+
+  T dT = temp - kT0_;
+  T rho1bar = ka_ + (kb_ + (kc_ + kd_*dT)*dT)*dT;
+  return rho1bar * (1.0 + kalpha_*(p - kp0_));
+}
+
+
 double EOSWater::MassDensity(std::vector<double>& params) {
   //AMANZI_ASSERT (params.size() >= 2);
-  double T = params[0];
-  double p = params[1];  
-  p = std::max(p, 101325.);
-  
-  double dT = T - kT0_;
-  double rho1bar = ka_ + (kb_ + (kc_ + kd_*dT)*dT)*dT;
-  return rho1bar * (1.0 + kalpha_*(p - kp0_));
+  return MassDensity_(params[0], params[1]);
 };
 
 
@@ -73,5 +78,16 @@ double EOSWater::DMassDensityDp(std::vector<double>& params) {
 
 };
 
+
+
+double EOSWater::MassDensityAndDerivatives(std::vector<double>& params,
+        double* dT, double* dp) {
+  Dual<2> rho = MassDensity_(Dual<2>::Variable(params[0], 0),
+                             Dual<2>::Variable(params[1], 1));
+  *dT = rho.d(0);
+  *dp = rho.d(1);
+  return rho.value();
+};
+
 } // namespace
 } // namespace
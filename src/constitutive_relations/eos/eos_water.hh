@@ -32,7 +32,13 @@ public:
   virtual double DMassDensityDT(std::vector<double>& params) override;
   virtual double DMassDensityDp(std::vector<double>& params) override;
 
+  virtual double MassDensityAndDerivatives(std::vector<double>& params,
+          double* dT, double* dp) override;
+
 private:
+  // density, on double or Dual
+  template<class T> T MassDensity_(const T& temp, T p) const;
+
   Teuchos::ParameterList eos_plist_;
 
   // constants for water, hard-coded because it would be crazy to try to come
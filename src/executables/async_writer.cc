@@ -0,0 +1,198 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of the AsyncWriter, which moves HDF5 output for visualization
+and checkpointing off of the timestep loop.
+------------------------------------------------------------------------- */
+
+#include <chrono>
+
+#include "errors.hh"
+#include "Visualization.hh"
+#include "Checkpoint.hh"
+#include "State.hh"
+
+#include "async_writer.hh"
+
+namespace ATS {
+
+AsyncWriter::AsyncWriter(const Teuchos::RCP<Amanzi::State>& S,
+                         const Amanzi::Comm_ptr_type& comm,
+                         int queue_size) :
+    async_(true),
+    staging_(queue_size),
+    busy_(false),
+    done_(false),
+    checkpoint_cost_(0.)
+{
+  if (queue_size < 1) {
+    Errors::Message msg("AsyncWriter: \"asynchronous output queue size\" must be positive.");
+    Exceptions::amanzi_throw(msg);
+  }
+
+  // Serial only.  The writer thread makes the collective HDF5 calls of a vis
+  // or checkpoint write on the communicator of the mesh or checkpoint, which
+  // is the one the timestep loop uses.  Concurrent collectives on one
+  // communicator are erroneous even with MPI_THREAD_MULTIPLE.
+  if (comm->NumProc() > 1) async_ = false;
+
+  // The staged states share meshes with S, so both threads touch their
+  // reference counts.
+#ifndef HAVE_TEUCHOS_THREAD_SAFE
+  async_ = false;
+#endif
+
+  // the writer must not read mesh coordinates while they change
+  for (Amanzi::State::mesh_iterator mesh=S->mesh_begin(); mesh!=S->mesh_end(); ++mesh) {
+    if (S->IsDeformableMesh(mesh->first)) async_ = false;
+  }
+
+  if (async_) {
+    for (int i=0; i!=queue_size; ++i) free_slots_.push_back(i);
+    writer_ = std::thread(&AsyncWriter::WriterLoop_, this);
+  }
+}
+
+
+AsyncWriter::~AsyncWriter() {
+  if (async_) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]{ return queue_.empty() && !busy_; });
+      done_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+  }
+}
+
+
+void AsyncWriter::QueueVis(const Teuchos::RCP<Amanzi::Visualization>& vis,
+                           const Amanzi::State& S) {
+  if (!async_) {
+    WriteVis(*vis, S);
+  } else {
+    Job job;
+    job.slot = Snapshot_(S, true);
+    job.vis = vis;
+    job.dt = 0.;
+    Submit_(job);
+  }
+}
+
+
+void AsyncWriter::QueueCheckpoint(const Teuchos::RCP<Amanzi::Checkpoint>& chkp,
+                                  const Amanzi::State& S, double dt) {
+  if (!async_) {
+    auto start = std::chrono::steady_clock::now();
+    WriteCheckpoint(*chkp, S, dt);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    checkpoint_cost_ = elapsed.count();
+  } else {
+    Job job;
+    job.slot = Snapshot_(S, false);
+    job.chkp = chkp;
+    job.dt = dt;
+    Submit_(job);
+  }
+}
+
+
+void AsyncWriter::Drain() {
+  if (async_) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]{ return queue_.empty() && !busy_; });
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Copy the fields to be written into a free staging state.  This blocks if
+// all staging states are in use.
+// -----------------------------------------------------------------------------
+int AsyncWriter::Snapshot_(const Amanzi::State& S, bool vis) {
+  int slot;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]{ return !free_slots_.empty(); });
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+
+  // The slot is now owned by this thread until submitted.
+  if (staging_[slot] == Teuchos::null) {
+    // first use, the copy constructor copies the data
+    staging_[slot] = Teuchos::rcp(new Amanzi::State(S));
+
+  } else {
+    Amanzi::State& staged = *staging_[slot];
+    for (Amanzi::State::field_iterator field=S.field_begin(); field!=S.field_end(); ++field) {
+      const std::string& key = field->first;
+      const std::string& owner = field->second->owner();
+
+      // incremental checkpoints change which fields are written
+      if (!vis) staged.GetField(key, owner)->set_io_checkpoint(field->second->io_checkpoint());
+      if (vis ? !field->second->io_vis() : !field->second->io_checkpoint()) continue;
+
+      if (field->second->type() == Amanzi::COMPOSITE_VECTOR_FIELD) {
+        *staged.GetFieldData(key, owner) = *S.GetFieldData(key);
+      } else if (field->second->type() == Amanzi::CONSTANT_SCALAR) {
+        *staged.GetScalarData(key, owner) = *S.GetScalarData(key);
+      } else if (field->second->type() == Amanzi::CONSTANT_VECTOR) {
+        *staged.GetConstantVectorData(key, owner) = *S.GetConstantVectorData(key);
+      }
+    }
+    staged.set_time(S.time());
+    staged.set_cycle(S.cycle());
+  }
+  return slot;
+}
+
+
+void AsyncWriter::Submit_(const Job& job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(job);
+  }
+  cv_.notify_all();
+}
+
+
+// -----------------------------------------------------------------------------
+// The writer thread: write jobs in the order they were submitted.
+// -----------------------------------------------------------------------------
+void AsyncWriter::WriterLoop_() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]{ return done_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      job = queue_.front();
+      queue_.pop_front();
+      busy_ = true;
+    }
+
+    if (job.vis != Teuchos::null) {
+      WriteVis(*job.vis, *staging_[job.slot]);
+    } else {
+      auto start = std::chrono::steady_clock::now();
+      WriteCheckpoint(*job.chkp, *staging_[job.slot], job.dt);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      checkpoint_cost_ = elapsed.count();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_slots_.push_back(job.slot);
+      busy_ = false;
+    }
+    cv_.notify_all();
+  }
+}
+
+} // namespace ATS
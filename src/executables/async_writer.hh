@@ -0,0 +1,106 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Writes visualization and checkpoint files on a background thread.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+The AsyncWriter takes a snapshot of the fields that are to be written into one
+of a fixed number of staging states, and hands that state to a writer thread.
+The timestep loop continues while the file is being written.  If all staging
+states are in use, submitting blocks until one is free, so the memory used is
+bounded by the queue size.
+
+The AsyncWriter is serial only: in parallel it writes synchronously.  A
+write makes collective calls on the communicator of the mesh's maps, the one
+the timestep loop uses, and giving the writer thread a duplicate of it is not
+enough, as the Visualization and Checkpoint objects and the vectors they write
+would all need to be built on the duplicate.  It also writes synchronously if
+Trilinos was built without thread safe reference counting
+(Teuchos_ENABLE_THREAD_SAFE), as the staged states share their meshes with the
+simulation, or if any mesh is deformable (the writer would read coordinates
+that the timestep loop is changing).
+
+*/
+
+#ifndef ATS_ASYNC_WRITER_HH_
+#define ATS_ASYNC_WRITER_HH_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "AmanziComm.hh"
+
+namespace Amanzi {
+class Visualization;
+class Checkpoint;
+class State;
+};
+
+
+namespace ATS {
+
+class AsyncWriter {
+
+ public:
+  AsyncWriter(const Teuchos::RCP<Amanzi::State>& S,
+              const Amanzi::Comm_ptr_type& comm,
+              int queue_size);
+  ~AsyncWriter();
+
+  // Snapshot S and write it at some point in the future.
+  void QueueVis(const Teuchos::RCP<Amanzi::Visualization>& vis,
+                const Amanzi::State& S);
+  void QueueCheckpoint(const Teuchos::RCP<Amanzi::Checkpoint>& chkp,
+                       const Amanzi::State& S, double dt);
+
+  // Blocks until all submitted writes are complete.
+  void Drain();
+
+  // Is output actually done on a thread?
+  bool asynchronous() const { return async_; }
+
+  // Wallclock time of the most recent checkpoint write, in seconds.
+  double checkpoint_cost() const { return checkpoint_cost_; }
+
+ private:
+  struct Job {
+    int slot;
+    Teuchos::RCP<Amanzi::Visualization> vis;
+    Teuchos::RCP<Amanzi::Checkpoint> chkp;
+    double dt;
+  };
+
+  int Snapshot_(const Amanzi::State& S, bool vis);
+  void Submit_(const Job& job);
+  void WriterLoop_();
+
+ private:
+  bool async_;
+
+  std::vector<Teuchos::RCP<Amanzi::State> > staging_;
+  std::vector<int> free_slots_;
+  std::deque<Job> queue_;
+  bool busy_;
+  bool done_;
+  std::atomic<double> checkpoint_cost_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread writer_;
+};
+
+} // namespace ATS
+
+#endif
@@ -383,4 +383,40 @@ createMeshes(Teuchos::ParameterList& global_list,
   
 
 }
+
+
+void
+shareMeshes(Teuchos::ParameterList& global_list,
+            Amanzi::State& S_from,
+            Amanzi::State& S_to)
+{
+  // meshes first, then aliases, which must find their targets
+  for (auto mesh=S_from.mesh_begin(); mesh!=S_from.mesh_end(); ++mesh) {
+    if (!S_from.IsAliasedMesh(mesh->first))
+      S_to.RegisterMesh(mesh->first, mesh->second.first, mesh->second.second);
+  }
+  for (auto mesh=S_from.mesh_begin(); mesh!=S_from.mesh_end(); ++mesh) {
+    if (S_from.IsAliasedMesh(mesh->first)) {
+      for (auto target=S_from.mesh_begin(); target!=S_from.mesh_end(); ++target) {
+        if (!S_from.IsAliasedMesh(target->first) &&
+            target->second.first.get() == mesh->second.first.get()) {
+          S_to.AliasMesh(target->first, mesh->first);
+          break;
+        }
+      }
+    }
+  }
+
+  // domain sets
+  Teuchos::ParameterList& meshes_list = global_list.sublist("mesh");
+  for (auto sublist : meshes_list) {
+    if (meshes_list.isSublist(sublist.first) &&
+        meshes_list.sublist(sublist.first).get<std::string>("mesh type") == "domain set") {
+      std::string ds_name = Amanzi::Keys::cleanPListName(sublist.first);
+      if (Amanzi::Keys::ends_with(ds_name, "_*")) ds_name = ds_name.substr(0,ds_name.length()-2);
+      S_to.RegisterDomainSet(ds_name, S_from.GetDomainSet(ds_name));
+    }
+  }
+}
+
 } // namespace ATS
@@ -299,6 +299,14 @@ createMeshes(Teuchos::ParameterList& plist,
              const Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel>& gm,
              Amanzi::State& s);
 
+// Registers, without copying, the meshes, aliases, and domain sets created
+// by createMeshes() on S_from with S_to.  Used by ensembles of simulations
+// that run on the same meshes.
+void
+shareMeshes(Teuchos::ParameterList& plist,
+            Amanzi::State& S_from,
+            Amanzi::State& S_to);
+
 
 } // namespace ATS
 
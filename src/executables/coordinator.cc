@@ -12,7 +12,11 @@ including Vis and restart/checkpoint dumps.  It contains one and only one PK
 -- most likely this PK is an MPC of some type -- to do the actual work.
 ------------------------------------------------------------------------- */
 
+#include <algorithm>
+#include <csignal>
 #include <iostream>
+#include <map>
+#include <set>
 #include <unistd.h>
 #include <sys/resource.h>
 #include "errors.hh"
@@ -32,23 +36,72 @@ including Vis and restart/checkpoint dumps.  It contains one and only one PK
 #include "Checkpoint.hh"
 #include "UnstructuredObservations.hh"
 #include "State.hh"
+#include "primary_variable_field_evaluator.hh"
+#include "independent_variable_field_evaluator.hh"
 #include "PK.hh"
 #include "TreeVector.hh"
 #include "PK_Factory.hh"
-
+#include "mpc.hh"
+#include "pk_bdf_default.hh"
+#include "pk_physical_bdf_default.hh"
+#include "timer_tree.hh"
+
+#include "async_writer.hh"
+#include "incremental_checkpoint.hh"
+#include "timestep_history.hh"
 #include "coordinator.hh"
 
 #define DEBUG_MODE 1
 
 namespace ATS {
 
+// set by the signal handler, checked at the end of each cycle
+static volatile std::sig_atomic_t signal_received_ = 0;
+
+extern "C" void coordinator_signal_handler(int signal) { signal_received_ = signal; }
+
+bool Coordinator::signal_received() { return signal_received_ != 0; }
+
+namespace {
+
+// Installs the signal handler for the life of a time step loop and restores
+// the previous handlers after it, so that a later simulation in the same
+// process that does not ask for it is not left ignoring SIGTERM.
+struct SignalHandlerScope {
+  explicit SignalHandlerScope(bool install) : installed(install) {
+    if (installed) {
+      prev_term = std::signal(SIGTERM, coordinator_signal_handler);
+      prev_usr1 = std::signal(SIGUSR1, coordinator_signal_handler);
+    }
+  }
+  ~SignalHandlerScope() {
+    if (installed) {
+      std::signal(SIGTERM, prev_term);
+      std::signal(SIGUSR1, prev_usr1);
+    }
+  }
+
+  bool installed;
+  void (*prev_term)(int);
+  void (*prev_usr1)(int);
+};
+
+} // namespace
+
+
 Coordinator::Coordinator(Teuchos::ParameterList& parameter_list,
                          Teuchos::RCP<Amanzi::State>& S,
                          Amanzi::Comm_ptr_type comm ) :
     parameter_list_(Teuchos::rcp(new Teuchos::ParameterList(parameter_list))),
     S_(S),
     comm_(comm),
-    restart_(false) {
+    restart_(false),
+    copy_modified_fields_only_(false),
+    copied_bytes_(0.),
+    skipped_bytes_(0.),
+    n_state_copies_(0),
+    cycle_cost_(0.),
+    checkpoint_cost_(0.) {
 
   // create and start the global timer
   timer_ = Teuchos::rcp(new Teuchos::Time("wallclock_monitor",true));
@@ -83,6 +136,8 @@ void Coordinator::coordinator_init() {
   // create the checkpointing
   Teuchos::ParameterList& chkp_plist = parameter_list_->sublist("checkpoint");
   checkpoint_ = Teuchos::rcp(new Amanzi::Checkpoint(chkp_plist, comm_));
+  checkpoint_event_ = Teuchos::rcp(new Amanzi::IOEvent(chkp_plist));
+  incremental_checkpoint_ = Teuchos::rcp(new IncrementalCheckpoint(chkp_plist, checkpoint_, comm_));
 
   // create the observations
   Teuchos::ParameterList& observation_plist = parameter_list_->sublist("observations");
@@ -130,22 +185,16 @@ void Coordinator::setup() {
 void Coordinator::initialize() {
   // Restart from checkpoint, part 1.
 
-  // This is crufty -- blame the BDF1 time integrator, whose solution history
-  // needs to be updated to accept the new time as its initial time.
-
-  // Note that if this is so, we can probably ignore some of the above
-  // initialize() calls and the commit_state() call, but I'm afraid to try
-  // that and break all the PKs.
-  // Currently not a true restart -- for a true restart this should also get:
-  // -- timestep size dt
-  // -- BDF history to allow projection to continue correctly.
+  // The timestep size and the BDF history (as a time derivative of the
+  // solution) are checkpointed by the BDF PKs, and are restored in their
+  // Initialize() from the fields read here.
   Teuchos::OSTab tab = vo_->getOSTab();
   int size = comm_->NumProc();
   int rank = comm_->MyPID();
 
   // Restart from checkpoint, part 2.
   if (restart_) {
-    ReadCheckpoint(comm_, *S_, restart_filename_);
+    IncrementalCheckpoint::Read(comm_, *S_, restart_filename_);
     t0_ = S_->time();
     cycle0_ = S_->cycle();
 
@@ -209,6 +258,7 @@ void Coordinator::initialize() {
       vis->CreateFiles();
 
       visualization_.push_back(vis);
+      visualization_events_.push_back(Teuchos::rcp(new Amanzi::IOEvent(*sublist_p)));
 
     } else if (boost::ends_with(domain_name, "_*")) {
       // visualize domain set
@@ -217,12 +267,14 @@ void Coordinator::initialize() {
         if (boost::starts_with(m->first, domain_set_name)) {
           // visualize each subdomain
           Teuchos::ParameterList sublist = vis_list->sublist(domain_name);
-          sublist.set<std::string>("file name base", std::string("ats_vis_")+m->first);
+          std::string base = sublist.get<std::string>("file name base", "ats_vis");
+          sublist.set<std::string>("file name base", base+"_"+m->first);
           auto vis = Teuchos::rcp(new Amanzi::Visualization(sublist));
           vis->set_name(m->first);
           vis->set_mesh(m->second.first);
           vis->CreateFiles();
           visualization_.push_back(vis);
+          visualization_events_.push_back(Teuchos::rcp(new Amanzi::IOEvent(sublist)));
         }
       }
 
@@ -269,6 +321,23 @@ void Coordinator::initialize() {
     S_inter_ = S_;
   }
 
+  // determine which fields must be copied between states
+  classify_state_fields();
+
+  // create the output writer
+  if (coordinator_list_->get<bool>("asynchronous output", false)) {
+    writer_ = Teuchos::rcp(new AsyncWriter(S_next_, comm_,
+            coordinator_list_->get<int>("asynchronous output queue size", 2)));
+    if (!writer_->asynchronous() && vo_->os_OK(Teuchos::VERB_LOW)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      if (comm_->NumProc() > 1) {
+        *vo_->os() << "WARNING: asynchronous output is only supported in serial runs; writing synchronously." << std::endl;
+      } else {
+        *vo_->os() << "WARNING: asynchronous output requires thread safe Teuchos reference counting and non-deformable meshes; writing synchronously." << std::endl;
+      }
+    }
+  }
+
   // set the states in the PKs Passing null for S_ allows for safer subcycling
   // -- PKs can't use it, so it is guaranteed to be pristinely the old
   // timestep.  This comes at the expense of an increase in memory footprint.
@@ -277,9 +346,13 @@ void Coordinator::initialize() {
 }
 
 void Coordinator::finalize() {
+  // Finish any pending output.
+  if (writer_ != Teuchos::null) writer_->Drain();
+
   // Force checkpoint at the end of simulation, and copy to checkpoint_final
   pk_->CalculateDiagnostics(S_next_);
   WriteCheckpoint(*checkpoint_, *S_next_, 0.0, true);
+  if (incremental_checkpoint_->enabled()) incremental_checkpoint_->FullWritten(S_next_->cycle());
 
   // flush observations to make sure they are saved
   observations_->Flush();
@@ -368,6 +441,149 @@ void Coordinator::report_memory() {
              << min_doubles_count*8/1024/1024 << " MBytes" << std::endl;
   *vo_->os() << "  Total:              " << std::setw(7)
              << global_doubles_count*8/1024/1024 << " MBytes" << std::endl;
+
+  if (detailed_memory_report_) report_field_memory();
+}
+
+// -----------------------------------------------------------------------------
+// Walk the PK tree, collecting storage used by operators.
+// -----------------------------------------------------------------------------
+void collect_operator_memory(const Teuchos::RCP<Amanzi::PK>& pk,
+                             std::map<std::string,double>& bytes);
+
+template<class PK_t>
+bool collect_sub_pk_operator_memory(const Teuchos::RCP<Amanzi::PK>& pk,
+        std::map<std::string,double>& bytes) {
+  Teuchos::RCP<Amanzi::MPC<PK_t> > mpc = Teuchos::rcp_dynamic_cast<Amanzi::MPC<PK_t> >(pk);
+  if (mpc == Teuchos::null) return false;
+  for (int i=0; mpc->get_subpk(i) != Teuchos::null; ++i) {
+    collect_operator_memory(mpc->get_subpk(i), bytes);
+  }
+  return true;
+}
+
+void collect_operator_memory(const Teuchos::RCP<Amanzi::PK>& pk,
+                             std::map<std::string,double>& bytes) {
+  Teuchos::RCP<Amanzi::PK_PhysicalBDF_Default> pk_bdf =
+      Teuchos::rcp_dynamic_cast<Amanzi::PK_PhysicalBDF_Default>(pk);
+  if (pk_bdf != Teuchos::null) pk_bdf->OperatorMemory(bytes);
+
+  if (!collect_sub_pk_operator_memory<Amanzi::PK>(pk, bytes))
+    if (!collect_sub_pk_operator_memory<Amanzi::PK_BDF_Default>(pk, bytes))
+      collect_sub_pk_operator_memory<Amanzi::PK_PhysicalBDF_Default>(pk, bytes);
+}
+
+
+// -----------------------------------------------------------------------------
+// Memory used by each field and by PK operators, largest first.
+// -----------------------------------------------------------------------------
+void Coordinator::report_field_memory() {
+  // -- owned and ghost bytes of each field
+  std::vector<std::string> keys;
+  std::vector<double> bytes;
+  for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+    const std::string& key = field->first;
+    double owned(0.), ghost(0.);
+    if (field->second->type() == Amanzi::COMPOSITE_VECTOR_FIELD) {
+      Teuchos::RCP<const Amanzi::CompositeVector> cv = S_->GetFieldData(key);
+      for (Amanzi::CompositeVector::name_iterator comp=cv->begin(); comp!=cv->end(); ++comp) {
+        const Epetra_MultiVector& vec = *cv->ViewComponent(*comp, false);
+        double n_owned = static_cast<double>(vec.MyLength()) * vec.NumVectors();
+        owned += n_owned * sizeof(double);
+        if (cv->Ghosted()) {
+          const Epetra_MultiVector& vec_g = *cv->ViewComponent(*comp, true);
+          ghost += (static_cast<double>(vec_g.MyLength()) * vec_g.NumVectors() - n_owned) * sizeof(double);
+        }
+      }
+    } else if (field->second->type() == Amanzi::CONSTANT_SCALAR) {
+      owned = sizeof(double);
+    } else if (field->second->type() == Amanzi::CONSTANT_VECTOR) {
+      owned = S_->GetConstantVectorData(key)->MyLength() * sizeof(double);
+    }
+    keys.push_back(key);
+    bytes.push_back(owned);
+    bytes.push_back(ghost);
+  }
+
+  std::vector<double> global_bytes(bytes.size(), 0.);
+  if (bytes.size() > 0) comm_->SumAll(&bytes[0], &global_bytes[0], bytes.size());
+
+  // -- operators owned by PKs
+  std::map<std::string,double> op_bytes;
+  collect_operator_memory(pk_, op_bytes);
+  std::vector<std::string> op_names;
+  std::vector<double> op_local;
+  for (const auto& op : op_bytes) {
+    op_names.push_back(op.first);
+    op_local.push_back(op.second);
+  }
+  std::vector<double> op_global(op_local.size(), 0.);
+  if (op_local.size() > 0) comm_->SumAll(&op_local[0], &op_global[0], op_local.size());
+
+  // -- Fields that are allocated but possibly never read: not written to
+  //    vis or checkpoint files, and not a dependency of any evaluator.  PKs
+  //    may still read these directly, so they are only candidates.
+  std::set<std::string> unused;
+  for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+    const std::string& key = field->first;
+    if (field->second->io_vis() || field->second->io_checkpoint()) continue;
+    if (!S_->HasFieldEvaluator(key)) continue;
+    if (Teuchos::rcp_dynamic_cast<Amanzi::PrimaryVariableFieldEvaluator>(
+            S_->GetFieldEvaluator(key)) != Teuchos::null) continue;
+
+    bool is_dependency = false;
+    for (Amanzi::State::evaluator_iterator fe=S_->field_evaluator_begin();
+         fe!=S_->field_evaluator_end(); ++fe) {
+      if (fe->second->IsDependency(S_.ptr(), key)) {
+        is_dependency = true;
+        break;
+      }
+    }
+    if (!is_dependency) unused.insert(key);
+  }
+
+  if (!vo_->os_OK(Teuchos::VERB_HIGH)) return;
+
+  // -- sort and write
+  std::vector<int> order(keys.size());
+  for (int i=0; i!=order.size(); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+      return global_bytes[2*a] + global_bytes[2*a+1] > global_bytes[2*b] + global_bytes[2*b+1]; });
+
+  Teuchos::OSTab tab = vo_->getOSTab();
+  std::ostream& os = *vo_->os();
+  os << std::fixed << std::setprecision(2);
+  os << "Memory in state fields, all ranks (* possibly unused):" << std::endl
+     << "  " << std::setw(50) << std::left << "field" << std::right
+     << std::setw(12) << "owned [MB]" << std::setw(12) << "ghost [MB]"
+     << "  type" << std::endl;
+  for (int i : order) {
+    const std::string& key = keys[i];
+    std::string type;
+    if (S_->HasFieldEvaluator(key)) {
+      type = "evaluated";
+    } else {
+      const std::string& owner = S_->GetField(key)->owner();
+      type = (owner != key && S_->HasFieldEvaluator(owner)) ? "derivative" : "PK";
+    }
+    os << (unused.count(key) ? "* " : "  ") << std::setw(50) << std::left << key << std::right
+       << std::setw(12) << global_bytes[2*i]/1024/1024
+       << std::setw(12) << global_bytes[2*i+1]/1024/1024
+       << "  " << type << std::endl;
+  }
+
+  if (op_names.size() > 0) {
+    std::vector<int> op_order(op_names.size());
+    for (int i=0; i!=op_order.size(); ++i) op_order[i] = i;
+    std::sort(op_order.begin(), op_order.end(),
+              [&](int a, int b) { return op_global[a] > op_global[b]; });
+
+    os << "Memory in PK operators, all ranks:" << std::endl;
+    for (int i : op_order) {
+      os << "  " << std::setw(50) << std::left << op_names[i] << std::right
+         << std::setw(12) << op_global[i]/1024/1024 << std::endl;
+    }
+  }
 }
 
 
@@ -398,12 +614,181 @@ void Coordinator::read_parameter_list() {
   cycle0_ = coordinator_list_->get<int>("start cycle",0);
   cycle1_ = coordinator_list_->get<int>("end cycle",-1);
   duration_ = coordinator_list_->get<double>("wallclock duration [hrs]", -1.0);
+  wallclock_safety_factor_ = coordinator_list_->get<double>("wallclock safety factor", 1.5);
+  checkpoint_on_signal_ = coordinator_list_->get<bool>("checkpoint on signal", false);
+  error_checkpoint_base_ = coordinator_list_->get<std::string>("error checkpoint file name base", "error_checkpoint");
+  last_good_checkpoint_base_ = coordinator_list_->get<std::string>("last good checkpoint file name base", "last_good_checkpoint");
 
   // restart control
   restart_ = coordinator_list_->isParameter("restart from checkpoint file");
   if (restart_) restart_filename_ = coordinator_list_->get<std::string>("restart from checkpoint file");
+
+  // state copy control
+  std::string copy_strategy = coordinator_list_->get<std::string>("state copy strategy", "full");
+  if (copy_strategy == "full") {
+    copy_modified_fields_only_ = false;
+  } else if (copy_strategy == "modified fields") {
+    copy_modified_fields_only_ = true;
+  } else {
+    Errors::Message msg;
+    msg << "Coordinator: unknown \"state copy strategy\": \"" << copy_strategy
+        << "\"  Valid are: \"full\", \"modified fields\"";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  // memory reporting
+  detailed_memory_report_ = coordinator_list_->get<bool>("detailed memory report", false);
+
+  // timer tree control -- the tree is static, so start it empty in case an
+  // earlier run in this process filled it
+  Amanzi::TimerTree::Reset();
+  Amanzi::TimerTree::Enable(coordinator_list_->get<bool>("timer tree", false));
+  timer_tree_filename_ = coordinator_list_->get<std::string>("timer tree filename", "ats_timer_tree.json");
+
+  // history-based time step control
+  if (coordinator_list_->isSublist("time step history")) {
+    dt_history_ = Teuchos::rcp(new TimestepHistory(coordinator_list_->sublist("time step history"), comm_));
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Determine which fields can change in time, and so must be copied between
+// states.  Fields that cannot change were set identically in all states at
+// initialization.
+// -----------------------------------------------------------------------------
+void Coordinator::classify_state_fields() {
+  copied_fields_.clear();
+  if (!copy_modified_fields_only_) return;
+
+  Teuchos::ParameterList& fe_list = parameter_list_->sublist("state").sublist("field evaluators");
+
+  // -- fields that are modified by PKs or that are functions of time.  These
+  //    are the roots of everything that changes.
+  std::set<std::string> varying;
+  for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+    const std::string& key = field->first;
+    bool is_static = false;
+    if (S_->HasFieldEvaluator(key)) {
+      auto fe = S_->GetFieldEvaluator(key);
+      bool is_primary = Teuchos::rcp_dynamic_cast<Amanzi::PrimaryVariableFieldEvaluator>(fe) != Teuchos::null;
+      bool is_independent = Teuchos::rcp_dynamic_cast<Amanzi::IndependentVariableFieldEvaluator>(fe) != Teuchos::null;
+      if (!is_primary && !is_independent) continue; // secondary variables are classified below
+
+      if (is_independent) {
+        is_static = fe_list.isSublist(key) &&
+            fe_list.sublist(key).get<bool>("constant in time", false);
+      }
+    }
+
+    std::string domain = Amanzi::Keys::getDomain(key);
+    if (domain.empty()) domain = "domain";
+    if (S_->HasMesh(domain) && S_->IsDeformableMesh(domain)) is_static = false;
+    if (!is_static) varying.insert(key);
+  }
+
+  // -- copy everything that is varying or depends upon something varying
+  for (Amanzi::State::field_iterator field=S_->field_begin(); field!=S_->field_end(); ++field) {
+    const std::string& key = field->first;
+    bool copy = varying.count(key) > 0;
+    if (!copy && S_->HasFieldEvaluator(key)) {
+      auto fe = S_->GetFieldEvaluator(key);
+      for (const auto& root : varying) {
+        if (fe->IsDependency(S_.ptr(), root)) {
+          copy = true;
+          break;
+        }
+      }
+    }
+    if (copy) copied_fields_.insert(key);
+  }
+
+  if (vo_->os_OK(Teuchos::VERB_HIGH)) {
+    Teuchos::OSTab tab = vo_->getOSTab();
+    *vo_->os() << "State copies will include " << copied_fields_.size() << " of "
+               << std::distance(S_->field_begin(), S_->field_end()) << " fields." << std::endl;
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Copy state, possibly only the fields that can have changed.
+// -----------------------------------------------------------------------------
+void Coordinator::copy_state(Amanzi::State& from, Amanzi::State& to) {
+  if (&from == &to) return;
+  n_state_copies_++;
+
+  if (!copy_modified_fields_only_) {
+    to = from;
+    for (Amanzi::State::field_iterator field=from.field_begin(); field!=from.field_end(); ++field) {
+      copied_bytes_ += 8. * field->second->GetLocalElementCount();
+    }
+    return;
+  }
+
+  // copy data
+  for (Amanzi::State::field_iterator field=from.field_begin(); field!=from.field_end(); ++field) {
+    const std::string& key = field->first;
+    double bytes = 8. * field->second->GetLocalElementCount();
+    if (!copied_fields_.count(key)) {
+      skipped_bytes_ += bytes;
+      continue;
+    }
+
+    const std::string& owner = field->second->owner();
+    if (field->second->type() == Amanzi::COMPOSITE_VECTOR_FIELD) {
+      *to.GetFieldData(key, owner) = *from.GetFieldData(key);
+    } else if (field->second->type() == Amanzi::CONSTANT_SCALAR) {
+      *to.GetScalarData(key, owner) = *from.GetScalarData(key);
+    } else if (field->second->type() == Amanzi::CONSTANT_VECTOR) {
+      *to.GetConstantVectorData(key, owner) = *from.GetConstantVectorData(key);
+    }
+    copied_bytes_ += bytes;
+  }
+
+  // copy evaluator status, which is cheap, so that change-tracking is
+  // consistent with the copied data
+  for (Amanzi::State::evaluator_iterator fe=from.field_evaluator_begin();
+       fe!=from.field_evaluator_end(); ++fe) {
+    *to.GetFieldEvaluator(fe->first) = *fe->second;
+  }
+
+  to.set_time(from.time());
+  to.set_cycle(from.cycle());
+  to.set_initial_time(from.initial_time());
+  to.set_final_time(from.final_time());
+}
+
+
+
+// -----------------------------------------------------------------------------
+// Nonlinear iterations of the most recent step: those of the PK that owns the
+// time integrator, or the most taken by any sub-PK that owns one.
+// -----------------------------------------------------------------------------
+int nonlinear_iterations(const Teuchos::RCP<Amanzi::PK>& pk);
+
+template<class PK_t>
+bool sub_pk_nonlinear_iterations(const Teuchos::RCP<Amanzi::PK>& pk, int& iterations) {
+  Teuchos::RCP<Amanzi::MPC<PK_t> > mpc = Teuchos::rcp_dynamic_cast<Amanzi::MPC<PK_t> >(pk);
+  if (mpc == Teuchos::null) return false;
+  for (int i=0; mpc->get_subpk(i) != Teuchos::null; ++i) {
+    iterations = std::max(iterations, nonlinear_iterations(mpc->get_subpk(i)));
+  }
+  return true;
 }
 
+int nonlinear_iterations(const Teuchos::RCP<Amanzi::PK>& pk) {
+  int iterations = -1;
+  Teuchos::RCP<Amanzi::PK_BDF_Default> pk_bdf =
+      Teuchos::rcp_dynamic_cast<Amanzi::PK_BDF_Default>(pk);
+  if (pk_bdf != Teuchos::null) iterations = pk_bdf->number_nonlinear_steps();
+  if (iterations >= 0) return iterations;
+
+  if (!sub_pk_nonlinear_iterations<Amanzi::PK>(pk, iterations))
+    if (!sub_pk_nonlinear_iterations<Amanzi::PK_BDF_Default>(pk, iterations))
+      sub_pk_nonlinear_iterations<Amanzi::PK_PhysicalBDF_Default>(pk, iterations);
+  return iterations;
+}
 
 
 // -----------------------------------------------------------------------------
@@ -428,6 +813,17 @@ double Coordinator::get_dt(bool after_fail) {
     dt = max_dt_;
   }
 
+  // limit by the history of recent steps
+  if (dt_history_ != Teuchos::null) {
+    double dt_limited = std::max(dt_history_->Limit(dt), min_dt_);
+    if (dt_limited < dt && vo_->os_OK(Teuchos::VERB_HIGH)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      *vo_->os() << "Time step history limits dt from " << dt << " to " << dt_limited
+                 << " [s]" << std::endl;
+    }
+    dt = dt_limited;
+  }
+
   // ask the step manager if this step is ok
   dt = tsm_->TimeStep(S_next_->time(), dt, after_fail);
   return dt;
@@ -454,20 +850,21 @@ bool Coordinator::advance(double t_old, double t_new) {
     checkpoint(dt);
 
     // we're done with this time step, copy the state
-    *S_ = *S_next_;
-    *S_inter_ = *S_next_;
+    copy_state(*S_next_, *S_);
+    if (S_inter_ != S_) copy_state(*S_next_, *S_inter_);
 
   } else {
     // Failed the timestep.
     // Potentially write out failed timestep for debugging
+    if (writer_ != Teuchos::null && !failed_visualization_.empty()) writer_->Drain();
     for (std::vector<Teuchos::RCP<Amanzi::Visualization> >::iterator vis=failed_visualization_.begin();
          vis!=failed_visualization_.end(); ++vis) {
       WriteVis(*(*vis), *S_next_);
     }
 
     // The timestep sizes have been updated, so copy back old soln and try again.
-    *S_next_ = *S_;
-    *S_inter_ = *S_;
+    copy_state(*S_, *S_next_);
+    if (S_inter_ != S_) copy_state(*S_, *S_inter_);
 
     // check whether meshes are deformable, and if so, recover the old coordinates
     for (Amanzi::State::mesh_iterator mesh=S_->mesh_begin();
@@ -508,9 +905,8 @@ void Coordinator::visualize(bool force) {
   // write visualization if requested
   bool dump = force;
   if (!dump) {
-    for (std::vector<Teuchos::RCP<Amanzi::Visualization> >::iterator vis=visualization_.begin();
-         vis!=visualization_.end(); ++vis) {
-      if ((*vis)->DumpRequested(S_next_->cycle(), S_next_->time())) {
+    for (const auto& event : visualization_events_) {
+      if (event->DumpRequested(S_next_->cycle(), S_next_->time())) {
         dump = true;
       }
     }
@@ -520,21 +916,70 @@ void Coordinator::visualize(bool force) {
     pk_->CalculateDiagnostics(S_next_);
   }
 
-  for (std::vector<Teuchos::RCP<Amanzi::Visualization> >::iterator vis=visualization_.begin();
-       vis!=visualization_.end(); ++vis) {
-    if (force || (*vis)->DumpRequested(S_next_->cycle(), S_next_->time())) {
-      WriteVis(*(*vis), *S_next_);
+  for (int i=0; i!=visualization_.size(); ++i) {
+    if (force || visualization_events_[i]->DumpRequested(S_next_->cycle(), S_next_->time())) {
+      if (writer_ != Teuchos::null) {
+        writer_->QueueVis(visualization_[i], *S_next_);
+      } else {
+        WriteVis(*visualization_[i], *S_next_);
+      }
     }
   }
 }
 
 void Coordinator::checkpoint(double dt, bool force) {
-  if (force || checkpoint_->DumpRequested(S_next_->cycle(), S_next_->time())) {
-    WriteCheckpoint(*checkpoint_, *S_next_, dt);
+  if (force || checkpoint_event_->DumpRequested(S_next_->cycle(), S_next_->time())) {
+    double start = timer_->totalElapsedTime(true);
+    if (incremental_checkpoint_->enabled()) incremental_checkpoint_->Select(*S_next_);
+    if (writer_ != Teuchos::null) {
+      writer_->QueueCheckpoint(checkpoint_, *S_next_, dt);
+    } else {
+      WriteCheckpoint(*checkpoint_, *S_next_, dt);
+    }
+    if (incremental_checkpoint_->enabled()) incremental_checkpoint_->Finish(*S_next_);
+
+    // the final checkpoint is written synchronously, so estimate its cost
+    // from the time to write, not the time to queue
+    double cost = writer_ != Teuchos::null ? writer_->checkpoint_cost() :
+        timer_->totalElapsedTime(true) - start;
+    if (cost > 0.)
+      checkpoint_cost_ = checkpoint_cost_ > 0. ? 0.5*(checkpoint_cost_ + cost) : cost;
   }
 }
 
 
+// -----------------------------------------------------------------------------
+// Decide, on all ranks together, whether to end the timestep loop early:
+// either a signal was received, or there is not enough wallclock time left
+// for another cycle plus the final checkpoint.
+// -----------------------------------------------------------------------------
+bool Coordinator::stop_requested(double duration) {
+  if (duration < 0. && !checkpoint_on_signal_) return false;
+
+  int reason[2] = {0, 0};
+  if (signal_received_) reason[0] = 1;
+  if (duration >= 0.) {
+    double remaining = duration - timer_->totalElapsedTime(true);
+    if (remaining < wallclock_safety_factor_ * (cycle_cost_ + checkpoint_cost_)) reason[1] = 1;
+  }
+
+  int global_reason[2] = {0, 0};
+  comm_->MaxAll(reason, global_reason, 2);
+
+  if (vo_->os_OK(Teuchos::VERB_LOW)) {
+    Teuchos::OSTab tab = vo_->getOSTab();
+    if (global_reason[0]) {
+      *vo_->os() << "Signal received: writing final checkpoint and ending the simulation." << std::endl;
+    } else if (global_reason[1]) {
+      *vo_->os() << "Wallclock duration nearly expired (cycle cost " << cycle_cost_
+                 << " s, checkpoint cost " << checkpoint_cost_
+                 << " s): writing final checkpoint and ending the simulation." << std::endl;
+    }
+  }
+  return global_reason[0] || global_reason[1];
+}
+
+
 // -----------------------------------------------------------------------------
 // timestep loop
 // -----------------------------------------------------------------------------
@@ -552,13 +997,16 @@ void Coordinator::cycle_driver() {
 
   ////exit(0);
 
-  // get the intial timestep -- note, this would have to be fixed for a true restart
+  // get the intial timestep -- on restart, this is the PK's checkpointed step size
   double dt = get_dt(false);
 
   // visualization at IC
   visualize();
   checkpoint(dt);
 
+  // end early, with a checkpoint, on request of the batch system
+  SignalHandlerScope signal_handlers(checkpoint_on_signal_);
+
 
 
   // iterate process kernels
@@ -570,8 +1018,8 @@ void Coordinator::cycle_driver() {
     bool fail = false;
     while ((S_->time() < t1_) &&
            ((cycle1_ == -1) || (S_->cycle() <= cycle1_)) &&
-           (duration_ < 0 || timer_->totalElapsedTime(true) < duration) &&
-           dt > 0.) {
+           dt > 0. &&
+           !stop_requested(duration)) {
       if (vo_->os_OK(Teuchos::VERB_MEDIUM)) {
         Teuchos::OSTab tab = vo_->getOSTab();
         *vo_->os() << "======================================================================"
@@ -591,9 +1039,16 @@ void Coordinator::cycle_driver() {
       S_->set_final_time(S_->time() + dt);
       S_->set_intermediate_time(S_->time());
 
+      double cycle_start = timer_->totalElapsedTime(true);
       fail = advance(S_->time(), S_->time() + dt);
+      if (dt_history_ != Teuchos::null)
+        dt_history_->Record(*S_, dt, fail, nonlinear_iterations(pk_));
       dt = get_dt(fail);
 
+      // moving average of the wallclock cost of a cycle
+      double cost = timer_->totalElapsedTime(true) - cycle_start;
+      cycle_cost_ = cycle_cost_ > 0. ? 0.8*cycle_cost_ + 0.2*cost : cost;
+
     } // while not finished
 
 
@@ -601,6 +1056,8 @@ void Coordinator::cycle_driver() {
   }
 
   catch (Amanzi::Exceptions::Amanzi_exception &e) {
+    if (writer_ != Teuchos::null) writer_->Drain();
+
     // write one more vis for help debugging
     S_next_->advance_cycle();
     visualize(true); // force vis
@@ -610,9 +1067,9 @@ void Coordinator::cycle_driver() {
 
     // catch errors to dump two checkpoints -- one as a "last good" checkpoint
     // and one as a "debugging data" checkpoint.
-    checkpoint_->set_filebasename("last_good_checkpoint");
+    checkpoint_->set_filebasename(last_good_checkpoint_base_);
     WriteCheckpoint(checkpoint_.ptr(), *S_, dt);
-    checkpoint_->set_filebasename("error_checkpoint");
+    checkpoint_->set_filebasename(error_checkpoint_base_);
     WriteCheckpoint(checkpoint_.ptr(), *S_next_, dt);
     throw e;
   }
@@ -625,6 +1082,32 @@ void Coordinator::cycle_driver() {
   report_memory();
   Teuchos::TimeMonitor::summarize(*vo_->os());
 
+  // report on PK and evaluator timers
+  if (Amanzi::TimerTree::enabled()) {
+    Amanzi::TimerTree::Report(*vo_->os(), comm_);
+    Amanzi::TimerTree::WriteJSON(timer_tree_filename_, comm_);
+  }
+
+  // report on state copies
+  if (vo_->os_OK(Teuchos::VERB_MEDIUM) && n_state_copies_ > 0) {
+    double copied(0.), skipped(0.);
+    comm_->SumAll(&copied_bytes_, &copied, 1);
+    comm_->SumAll(&skipped_bytes_, &skipped, 1);
+    Teuchos::OSTab tab = vo_->getOSTab();
+    *vo_->os() << "State copies: " << n_state_copies_ << std::endl
+               << "  Copied:             " << std::setw(7) << copied/1024/1024 << " MBytes,  per copy: "
+               << std::setw(7) << copied/n_state_copies_/1024/1024 << " MBytes" << std::endl
+               << "  Skipped:            " << std::setw(7) << skipped/1024/1024 << " MBytes,  per copy: "
+               << std::setw(7) << skipped/n_state_copies_/1024/1024 << " MBytes" << std::endl;
+  }
+
+  // report on time step limiting
+  if (vo_->os_OK(Teuchos::VERB_MEDIUM) && dt_history_ != Teuchos::null) {
+    Teuchos::OSTab tab = vo_->getOSTab();
+    *vo_->os() << "Time step history limited " << dt_history_->limited_count() << " of "
+               << dt_history_->proposed_count() << " proposed time steps." << std::endl;
+  }
+
   finalize();
 
 } // cycle driver
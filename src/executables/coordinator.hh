@@ -35,7 +35,24 @@ simulation, including starting and ending times and restart options.
     * `"restart from checkpoint file`" ``[string]`` **optional** If provided,
       specifies a path to the checkpoint file to continue a stopped simulation.
     * `"wallclock duration [hrs]`" ``[double]`` **optional** After this time, the
-      simulation will checkpoint and end.
+      simulation will checkpoint and end.  The coordinator keeps moving averages
+      of the wallclock cost of a cycle and of writing a checkpoint, and ends
+      the simulation early enough that the final checkpoint is complete before
+      this time.
+    * `"wallclock safety factor`" ``[double]`` **1.5** The simulation ends once
+      the remaining wallclock time is less than this factor times the cost of
+      one more cycle plus the final checkpoint.
+    * `"checkpoint on signal`" ``[bool]`` **false** If true, on receiving
+      SIGTERM or SIGUSR1 the simulation finishes the current cycle, writes the
+      final checkpoint, and ends.  Batch schedulers can typically be asked to
+      send such a signal some time before a job's wallclock limit.  The
+      handlers are installed for the time step loop only; previous handlers
+      are restored after it.
+    * `"error checkpoint file name base`" ``[string]`` **error_checkpoint**
+      Checkpoint of the failed step, written if the simulation fails.
+    * `"last good checkpoint file name base`" ``[string]``
+      **last_good_checkpoint** Checkpoint of the last successful step,
+      written if the simulation fails.
     * `"required times`" ``[io-event-spec]`` **optional** An IOEvent_ spec that
       sets a collection of times/cycles at which the simulation is guaranteed to
       hit exactly.  This is useful for situations such as where data is provided at
@@ -43,6 +60,38 @@ simulation, including starting and ending times and restart options.
       minimized.
     * `"PK tree`" ``[pk-typed-spec-list]`` List of length one, the top level
       PK_ spec.
+    * `"state copy strategy`" ``[string]`` **full** Controls how the
+      coordinator copies state between the old and new time levels after a
+      successful or failed timestep.  One of:
+
+      - `"full`" Every field is copied on every step.
+      - `"modified fields`" Fields that cannot change in time (independent
+        variables that are `"constant in time`" and everything computed only
+        from them, on non-deforming meshes) are identical in all states after
+        initialization, and are never copied.  All other fields are copied.
+
+    * `"asynchronous output`" ``[bool]`` **false** If true, visualization and
+      checkpoint files are written on a background thread while the timestep
+      loop continues.  Serial runs only: in parallel, files are written
+      synchronously, with a warning.  See AsyncWriter.
+    * `"asynchronous output queue size`" ``[int]`` **2** Maximum number of
+      snapshots of state waiting to be written.  Each costs roughly the memory
+      of one State.
+    * `"detailed memory report`" ``[bool]`` **false** If true, the memory
+      report at the end of the simulation also lists the memory used by each
+      field (owned and ghost entries, including derivatives) and by each PK's
+      operators, largest first.  Fields that are not written to vis or
+      checkpoint files and that no evaluator depends upon are marked as
+      possibly unused.  Written at a verbosity of high or above.
+    * `"timer tree`" ``[bool]`` **false** If true, time PK methods
+      (AdvanceStep, FunctionalResidual, UpdatePreconditioner,
+      ApplyPreconditioner, ErrorNorm) and some evaluators, nested by the PK
+      tree, and report them at the end of the simulation.  See TimerTree.
+    * `"timer tree filename`" ``[string]`` **ats_timer_tree.json** File to
+      which the timer tree is written, in a flamegraph-compatible JSON format.
+    * `"time step history`" ``[time-step-history-spec]`` **optional** If
+      provided, the step size chosen by the PKs is further limited using the
+      history of recent steps.  See TimestepHistory.
 
 Note: Either `"end cycle`" or `"end time`" are required, and if
 both are present, the simulation will stop with whichever arrives
@@ -74,6 +123,8 @@ Example:
 #ifndef ATS_COORDINATOR_HH_
 #define ATS_COORDINATOR_HH_
 
+#include <set>
+
 #include "Teuchos_Time.hpp"
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_ParameterList.hpp"
@@ -85,6 +136,7 @@ Example:
 
 namespace Amanzi {
 class TimeStepManager;
+class IOEvent;
 class Visualization;
 class Checkpoint;
 class State;
@@ -97,6 +149,10 @@ class UnstructuredObservations;
 
 namespace ATS {
 
+class AsyncWriter;
+class IncrementalCheckpoint;
+class TimestepHistory;
+
 class Coordinator {
 
 public:
@@ -119,10 +175,24 @@ public:
   // one stop shopping
   void cycle_driver();
 
+  // True if SIGTERM or SIGUSR1 was received while a simulation handled them,
+  // in which case the job is ending.
+  static bool signal_received();
+
 private:
   void coordinator_init();
   void read_parameter_list();
 
+  // collective check on ending the simulation early
+  bool stop_requested(double duration);
+
+  // memory reporting
+  void report_field_memory();
+
+  // selective copies of state
+  void classify_state_fields();
+  void copy_state(Amanzi::State& from, Amanzi::State& to);
+
   // PK container and factory
   Teuchos::RCP<Amanzi::PK> pk_;
 
@@ -132,8 +202,15 @@ private:
   Teuchos::RCP<Amanzi::State> S_next_;
   Teuchos::RCP<Amanzi::TreeVector> soln_;
 
+  // state copies
+  bool copy_modified_fields_only_;
+  std::set<std::string> copied_fields_;
+  double copied_bytes_, skipped_bytes_;
+  int n_state_copies_;
+
   // time step manager
   Teuchos::RCP<Amanzi::TimeStepManager> tsm_;
+  Teuchos::RCP<TimestepHistory> dt_history_;
 
   // misc setup information
   Teuchos::RCP<Teuchos::ParameterList> parameter_list_;
@@ -154,8 +231,15 @@ private:
   std::vector<Teuchos::RCP<Amanzi::Visualization> > visualization_;
   std::vector<Teuchos::RCP<Amanzi::Visualization> > failed_visualization_;
   Teuchos::RCP<Amanzi::Checkpoint> checkpoint_;
+
+  // Output schedules, asked in place of the writers above, which may be in
+  // use by the AsyncWriter's thread.
+  std::vector<Teuchos::RCP<Amanzi::IOEvent> > visualization_events_;
+  Teuchos::RCP<Amanzi::IOEvent> checkpoint_event_;
+  Teuchos::RCP<IncrementalCheckpoint> incremental_checkpoint_;
   bool restart_;
   std::string restart_filename_;
+  Teuchos::RCP<AsyncWriter> writer_;
 
   // observations
   Teuchos::RCP<Amanzi::UnstructuredObservations> observations_;
@@ -165,6 +249,12 @@ private:
   Teuchos::RCP<Teuchos::Time> cycle_timer_;
   Teuchos::RCP<Teuchos::Time> timer_;
   double duration_;
+  double wallclock_safety_factor_;
+  double cycle_cost_, checkpoint_cost_;
+  bool checkpoint_on_signal_;
+  std::string error_checkpoint_base_, last_good_checkpoint_base_;
+  std::string timer_tree_filename_;
+  bool detailed_memory_report_;
   
   // fancy OS
   Teuchos::RCP<Amanzi::VerboseObject> vo_;
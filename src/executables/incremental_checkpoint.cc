@@ -0,0 +1,212 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of IncrementalCheckpoint, which writes full checkpoints
+periodically and, in between, only the fields that have changed.
+------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "errors.hh"
+#include "Checkpoint.hh"
+#include "State.hh"
+
+#include "incremental_checkpoint.hh"
+
+namespace ATS {
+
+IncrementalCheckpoint::IncrementalCheckpoint(Teuchos::ParameterList& plist,
+        const Teuchos::RCP<const Amanzi::Checkpoint>& chkp,
+        const Amanzi::Comm_ptr_type& comm) :
+    comm_(comm),
+    chkp_(chkp),
+    n_since_full_(-1)
+{
+  enabled_ = plist.get<bool>("incremental checkpoints", false);
+  full_interval_ = plist.get<int>("full checkpoint interval", 10);
+
+  if (full_interval_ < 1) {
+    Errors::Message msg("Checkpoint: \"full checkpoint interval\" must be positive.");
+    Exceptions::amanzi_throw(msg);
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Choose the fields to write.
+// -----------------------------------------------------------------------------
+void IncrementalCheckpoint::Select(Amanzi::State& S)
+{
+  written_.clear();
+  skipped_.clear();
+
+  bool full = n_since_full_ < 0 || n_since_full_ + 1 >= full_interval_;
+  if (full) {
+    // a new base: remember what everything looks like now
+    full_hashes_.clear();
+    for (Amanzi::State::field_iterator field=S.field_begin(); field!=S.field_end(); ++field) {
+      if (field->second->io_checkpoint())
+        full_hashes_[field->first] = Hash_(S, field->first);
+    }
+    full_filename_ = Filename_(S.cycle());
+    n_since_full_ = 0;
+    return;
+  }
+
+  // a delta: write fields that changed on any rank
+  std::vector<std::string> keys;
+  std::vector<int> changed;
+  for (const auto& entry : full_hashes_) {
+    keys.push_back(entry.first);
+    changed.push_back(Hash_(S, entry.first) != entry.second);
+  }
+  std::vector<int> global_changed(changed.size(), 0);
+  if (changed.size() > 0)
+    comm_->MaxAll(&changed[0], &global_changed[0], changed.size());
+
+  for (int i=0; i!=keys.size(); ++i) {
+    if (global_changed[i]) {
+      written_.insert(keys[i]);
+    } else {
+      skipped_.insert(keys[i]);
+      S.GetField(keys[i], S.GetField(keys[i])->owner())->set_io_checkpoint(false);
+    }
+  }
+
+  // fields checkpointed now but not at the base must be written too
+  for (Amanzi::State::field_iterator field=S.field_begin(); field!=S.field_end(); ++field) {
+    if (field->second->io_checkpoint()) written_.insert(field->first);
+  }
+  n_since_full_++;
+}
+
+
+void IncrementalCheckpoint::Finish(Amanzi::State& S)
+{
+  for (const auto& key : skipped_)
+    S.GetField(key, S.GetField(key)->owner())->set_io_checkpoint(true);
+
+  // only deltas are described
+  if (n_since_full_ > 0 && comm_->MyPID() == 0) {
+    std::ofstream delta((Filename_(S.cycle()) + ".delta").c_str());
+    delta << "base " << Basename_(full_filename_) << std::endl;
+    for (const auto& key : written_) delta << key << std::endl;
+  }
+  written_.clear();
+  skipped_.clear();
+}
+
+
+void IncrementalCheckpoint::FullWritten(int cycle)
+{
+  if (comm_->MyPID() == 0) std::remove((Filename_(cycle) + ".delta").c_str());
+}
+
+
+// -----------------------------------------------------------------------------
+// Restart from a full or delta checkpoint.
+// -----------------------------------------------------------------------------
+void IncrementalCheckpoint::Read(const Amanzi::Comm_ptr_type& comm, Amanzi::State& S,
+                                 const std::string& filename)
+{
+  std::ifstream delta((filename + ".delta").c_str());
+  if (!delta.good()) {
+    ReadCheckpoint(comm, S, filename);
+    return;
+  }
+
+  std::string word, base;
+  delta >> word >> base;
+  if (word != "base") {
+    Errors::Message msg;
+    msg << "Checkpoint: malformed delta description \"" << filename << ".delta\".";
+    Exceptions::amanzi_throw(msg);
+  }
+  std::set<std::string> in_delta;
+  std::string key;
+  while (delta >> key) in_delta.insert(key);
+
+  // The base is relative to the delta's directory.  Deltas written before
+  // that named it relative to the working directory.
+  if (base[0] != '/') {
+    std::string dir = Dirname_(filename);
+    if (!dir.empty() && std::ifstream((dir + base).c_str()).good()) base = dir + base;
+  }
+
+  // everything from the base, then what changed
+  ReadCheckpoint(comm, S, base);
+
+  std::vector<std::string> skipped;
+  for (Amanzi::State::field_iterator field=S.field_begin(); field!=S.field_end(); ++field) {
+    if (field->second->io_checkpoint() && !in_delta.count(field->first)) {
+      field->second->set_io_checkpoint(false);
+      skipped.push_back(field->first);
+    }
+  }
+  ReadCheckpoint(comm, S, filename);
+  for (const auto& key : skipped)
+    S.GetField(key, S.GetField(key)->owner())->set_io_checkpoint(true);
+}
+
+
+// -----------------------------------------------------------------------------
+// File names
+// -----------------------------------------------------------------------------
+std::string IncrementalCheckpoint::Filename_(int cycle) const
+{
+  return chkp_->Filename(cycle);
+}
+
+// the directory part, including the trailing slash, or empty
+std::string IncrementalCheckpoint::Dirname_(const std::string& filename)
+{
+  std::size_t slash = filename.rfind('/');
+  return slash == std::string::npos ? std::string() : filename.substr(0, slash+1);
+}
+
+std::string IncrementalCheckpoint::Basename_(const std::string& filename)
+{
+  return filename.substr(Dirname_(filename).size());
+}
+
+
+// -----------------------------------------------------------------------------
+// FNV-1a hash, one double at a time, of the owned data of a field on this
+// rank.
+// -----------------------------------------------------------------------------
+std::uint64_t IncrementalCheckpoint::Hash_(const Amanzi::State& S, const std::string& key)
+{
+  std::uint64_t hash = 14695981039346656037ull;
+  auto hash_doubles = [&hash](const double* data, int n) {
+    for (int i=0; i!=n; ++i) {
+      std::uint64_t word;
+      std::memcpy(&word, &data[i], sizeof(double));
+      hash ^= word;
+      hash *= 1099511628211ull;
+    }
+  };
+
+  Teuchos::RCP<const Amanzi::Field> field = S.GetField(key);
+  if (field->type() == Amanzi::COMPOSITE_VECTOR_FIELD) {
+    Teuchos::RCP<const Amanzi::CompositeVector> cv = S.GetFieldData(key);
+    for (Amanzi::CompositeVector::name_iterator comp=cv->begin(); comp!=cv->end(); ++comp) {
+      const Epetra_MultiVector& vec = *cv->ViewComponent(*comp, false);
+      for (int j=0; j!=vec.NumVectors(); ++j) hash_doubles(vec[j], vec.MyLength());
+    }
+  } else if (field->type() == Amanzi::CONSTANT_SCALAR) {
+    hash_doubles(S.GetScalarData(key).get(), 1);
+  } else if (field->type() == Amanzi::CONSTANT_VECTOR) {
+    const Epetra_Vector& vec = *S.GetConstantVectorData(key);
+    hash_doubles(vec.Values(), vec.MyLength());
+  }
+  return hash;
+}
+
+} // namespace ATS
@@ -0,0 +1,106 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Writes checkpoints that contain only fields changed since the last full checkpoint.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+Much of the checkpointed data in a long simulation, such as permeability,
+porosity, or cell volumes on a non-deforming mesh, never changes.  With
+incremental checkpoints, every `"full checkpoint interval`" checkpoints a full
+checkpoint is written.  Each checkpoint in between is a delta, containing only
+the fields whose data differs from that full checkpoint.  Changes are
+detected by hashing each field's data.
+
+Next to each delta checkpoint, a small text file, named by appending
+`".delta`" to the checkpoint file name, lists the full checkpoint it is based
+upon, relative to the directory of the delta, and the fields it contains.  Restarting from a delta checkpoint first
+reads the full checkpoint and then the fields in the delta.  Restarting from a
+full checkpoint works as usual.
+
+The final checkpoint of a simulation is always full.  These options are
+specified in the `"checkpoint`" list, alongside the usual Checkpoint_ options.
+
+.. _incremental-checkpoint-spec:
+.. admonition:: incremental-checkpoint-spec
+
+    * `"incremental checkpoints`" ``[bool]`` **false** Write delta checkpoints.
+    * `"full checkpoint interval`" ``[int]`` **10** Every this many
+      checkpoints, a full checkpoint is written.
+
+*/
+
+#ifndef ATS_INCREMENTAL_CHECKPOINT_HH_
+#define ATS_INCREMENTAL_CHECKPOINT_HH_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+
+#include "Teuchos_ParameterList.hpp"
+#include "AmanziComm.hh"
+
+namespace Amanzi {
+class State;
+class Checkpoint;
+};
+
+
+namespace ATS {
+
+class IncrementalCheckpoint {
+
+ public:
+  // File names are those chkp writes.
+  IncrementalCheckpoint(Teuchos::ParameterList& plist,
+                        const Teuchos::RCP<const Amanzi::Checkpoint>& chkp,
+                        const Amanzi::Comm_ptr_type& comm);
+
+  // Collective.  Turns off checkpointing of fields that are unchanged since
+  // the last full checkpoint.  Must be followed by Finish() once the
+  // checkpoint is written (or queued).
+  void Select(Amanzi::State& S);
+
+  // Writes the list of fields in a delta checkpoint, and turns checkpointing
+  // back on for all fields.
+  void Finish(Amanzi::State& S);
+
+  // A full checkpoint was written outside of Select()/Finish(), e.g. the
+  // final checkpoint.  Removes any delta description for that cycle.
+  void FullWritten(int cycle);
+
+  bool enabled() const { return enabled_; }
+
+  // Collective.  Reads a checkpoint that may be a delta.
+  static void Read(const Amanzi::Comm_ptr_type& comm, Amanzi::State& S,
+                   const std::string& filename);
+
+ private:
+  std::string Filename_(int cycle) const;
+  static std::string Dirname_(const std::string& filename);
+  static std::string Basename_(const std::string& filename);
+  static std::uint64_t Hash_(const Amanzi::State& S, const std::string& key);
+
+ private:
+  Amanzi::Comm_ptr_type comm_;
+  Teuchos::RCP<const Amanzi::Checkpoint> chkp_;
+  bool enabled_;
+  int full_interval_;
+
+  int n_since_full_;
+  std::string full_filename_;
+  std::map<std::string, std::uint64_t> full_hashes_;
+  std::set<std::string> written_;
+  std::set<std::string> skipped_;
+};
+
+} // namespace ATS
+
+#endif
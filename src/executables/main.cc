@@ -89,7 +89,8 @@ int main(int argc, char *argv[])
   Teuchos::readVerboseObjectSublist(&*plist, &fos, &Amanzi::VerbosityLevel::level_);
 
   SimulationDriver simulator;
-  int ret = simulator.Run(mpi_comm, *plist);
+  int ret = plist->isSublist("ensemble") ?
+      simulator.RunEnsemble(mpi_comm, *plist) : simulator.Run(mpi_comm, *plist);
 }
 
 
@@ -8,6 +8,8 @@ Author: Ethan Coon (ecoon@lanl.gov)
 ------------------------------------------------------------------------- */
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <Epetra_MpiComm.h>
 
@@ -28,6 +30,7 @@ Author: Ethan Coon (ecoon@lanl.gov)
 #include "errors.hh"
 #include "exceptions.hh"
 
+#include "mesh_topology.hh"
 #include "ats_mesh_factory.hh"
 #include "simulation_driver.hh"
 
@@ -87,7 +90,233 @@ int SimulationDriver::Run(
   
   // run the simulation
   coordinator.cycle_driver();
+  Amanzi::MeshTopology::Clear();
   return 0;
 }
 
 
+
+
+// -----------------------------------------------------------------------------
+// Suffix output file names with the ensemble member name, so that members do
+// not overwrite each other's output.
+// -----------------------------------------------------------------------------
+static void
+setMemberFilenames(Teuchos::ParameterList& plist, const std::string& member)
+{
+  // visualization, with the coordinator's defaults
+  Teuchos::ParameterList& vis_list = plist.sublist("visualization");
+  std::vector<std::string> domains;
+  for (auto& entry : vis_list)
+    if (vis_list.isSublist(entry.first)) domains.push_back(entry.first);
+  for (const auto& domain : domains) {
+    Teuchos::ParameterList& vis = vis_list.sublist(domain);
+    std::string base;
+    if (Amanzi::Keys::ends_with(domain, "_*") || domain.empty() || domain == "domain") {
+      base = vis.get<std::string>("file name base", "ats_vis");
+    } else {
+      base = vis.get<std::string>("file name base", std::string("ats_vis_")+domain);
+    }
+    vis.set("file name base", base+"_"+member);
+  }
+
+  // checkpoint
+  Teuchos::ParameterList& chkp = plist.sublist("checkpoint");
+  chkp.set("file name base", chkp.get<std::string>("file name base", "checkpoint")+"_"+member+"_");
+
+  // observations
+  Teuchos::ParameterList& obs_list = plist.sublist("observations");
+  for (auto& entry : obs_list) {
+    if (obs_list.isSublist(entry.first)) {
+      Teuchos::ParameterList& obs = obs_list.sublist(entry.first);
+      if (obs.isParameter("observation output filename")) {
+        std::string filename = obs.get<std::string>("observation output filename");
+        std::size_t dot = filename.rfind('.');
+        if (dot == std::string::npos) {
+          filename = filename + "_" + member;
+        } else {
+          filename = filename.substr(0, dot) + "_" + member + filename.substr(dot);
+        }
+        obs.set("observation output filename", filename);
+      }
+    }
+  }
+
+  // timer tree
+  Teuchos::ParameterList& cd_list = plist.sublist("cycle driver");
+  std::string timers = cd_list.get<std::string>("timer tree filename", "ats_timer_tree.json");
+  cd_list.set("timer tree filename", timers.substr(0, timers.rfind('.')) + "_" + member + ".json");
+
+  // checkpoints written on failure
+  cd_list.set("error checkpoint file name base",
+              cd_list.get<std::string>("error checkpoint file name base", "error_checkpoint")+"_"+member+"_");
+  cd_list.set("last good checkpoint file name base",
+              cd_list.get<std::string>("last good checkpoint file name base", "last_good_checkpoint")+"_"+member+"_");
+}
+
+
+// -----------------------------------------------------------------------------
+// Collective.  True on all ranks if ok is true on all ranks.
+// -----------------------------------------------------------------------------
+static bool
+allSucceeded(bool ok, const MPI_Comm& comm)
+{
+  int local = ok ? 1 : 0;
+  int global = 0;
+  MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_MIN, comm);
+  return global == 1;
+}
+
+
+int SimulationDriver::RunEnsemble(
+    const MPI_Comm& mpi_comm, Teuchos::ParameterList& plist) {
+
+  // verbosity settings
+  setDefaultVerbLevel(Amanzi::VerbosityLevel::level_);
+  Teuchos::EVerbosityLevel verbLevel = getVerbLevel();
+  Teuchos::RCP<Teuchos::FancyOStream> out = getOStream();
+  Teuchos::OSTab tab = getOSTab(); // This sets the line prefix and adds one tab
+
+  int rank, size;
+  MPI_Comm_rank(mpi_comm,&rank);
+  MPI_Comm_size(mpi_comm,&size);
+
+  // the members
+  Teuchos::ParameterList& ensemble_list = plist.sublist("ensemble");
+  Teuchos::ParameterList& members_list = ensemble_list.sublist("members");
+  std::vector<std::string> members;
+  for (auto& entry : members_list) {
+    if (members_list.isSublist(entry.first)) {
+      if (members_list.sublist(entry.first).isSublist("mesh") ||
+          members_list.sublist(entry.first).isSublist("regions")) {
+        Errors::Message msg;
+        msg << "Ensemble member \"" << entry.first << "\" may not override \"mesh\" or \"regions\".";
+        Exceptions::amanzi_throw(msg);
+      }
+      members.push_back(entry.first);
+    }
+  }
+  if (members.size() == 0) {
+    Errors::Message msg("Ensemble: \"members\" list is empty.");
+    Exceptions::amanzi_throw(msg);
+  }
+
+  // split processes into groups, each of which runs members in sequence
+  int procs_per_member = ensemble_list.get<int>("processes per member", size);
+  if (procs_per_member < 1 || size % procs_per_member != 0) {
+    Errors::Message msg;
+    msg << "Ensemble: \"processes per member\" (" << procs_per_member
+        << ") must divide the number of processes (" << size << ").";
+    Exceptions::amanzi_throw(msg);
+  }
+  int n_groups = size / procs_per_member;
+  int group = rank / procs_per_member;
+
+  MPI_Comm group_mpi_comm;
+  MPI_Comm_split(mpi_comm, group, rank, &group_mpi_comm);
+
+  int n_failed = 0;
+  int n_succeeded = 0;
+  {
+    #ifdef HAVE_MPI
+    auto comm = Teuchos::rcp(new Amanzi::MpiComm_type(group_mpi_comm));
+    #else
+    auto comm = Amanzi::getCommSelf();
+    #endif
+
+    // the main list, less the ensemble, is the base for each member
+    Teuchos::ParameterList base_plist(plist);
+    base_plist.remove("ensemble");
+
+    // create the geometric model, regions, and meshes once
+    Teuchos::ParameterList reg_params = base_plist.sublist("regions");
+    Teuchos::RCP<Amanzi::AmanziGeometry::GeometricModel> gm =
+      Teuchos::rcp(new Amanzi::AmanziGeometry::GeometricModel(3, reg_params, *comm) );
+
+    Teuchos::RCP<Amanzi::State> S_meshes =
+      Teuchos::rcp(new Amanzi::State(base_plist.sublist("state")));
+    ATS::createMeshes(base_plist, comm, gm, *S_meshes);
+
+    bool deformable = false;
+    for (auto mesh=S_meshes->mesh_begin(); mesh!=S_meshes->mesh_end(); ++mesh) {
+      if (mesh->second.second) deformable = true;
+    }
+
+    for (int i=group; i<members.size(); i+=n_groups) {
+      const std::string& member = members[i];
+      if(out.get() && includesVerbLevel(verbLevel,Teuchos::VERB_LOW,true) && comm->MyPID() == 0) {
+        *out << "======================> ensemble member \"" << member << "\" <======================"
+             << std::endl;
+      }
+
+      Teuchos::ParameterList member_plist(base_plist);
+      member_plist.setParameters(members_list.sublist(member));
+      setMemberFilenames(member_plist, member);
+
+      // Errors are agreed on by the group after construction and after the
+      // run, so that a member failing on some ranks is abandoned by all of
+      // them rather than leaving the others in the next collective.  An
+      // error on some ranks within a time step is still not recoverable.
+      bool ok = true;
+      Teuchos::RCP<ATS::Coordinator> coordinator;
+      try {
+        Teuchos::RCP<Amanzi::State> S =
+          Teuchos::rcp(new Amanzi::State(member_plist.sublist("state")));
+        if (deformable) {
+          ATS::createMeshes(member_plist, comm, gm, *S);
+        } else {
+          ATS::shareMeshes(member_plist, *S_meshes, *S);
+        }
+        coordinator = Teuchos::rcp(new ATS::Coordinator(member_plist, S, comm));
+      } catch (const std::exception& e) {
+        ok = false;
+        std::cerr << "Ensemble member \"" << member << "\" failed on rank " << rank
+                  << ": " << e.what() << std::endl;
+      }
+      ok = allSucceeded(ok, group_mpi_comm);
+
+      // run the simulation
+      if (ok) {
+        try {
+          coordinator->cycle_driver();
+        } catch (const std::exception& e) {
+          ok = false;
+          std::cerr << "Ensemble member \"" << member << "\" failed on rank " << rank
+                    << ": " << e.what() << std::endl;
+        }
+        ok = allSucceeded(ok, group_mpi_comm);
+      }
+      coordinator = Teuchos::null;
+      Amanzi::MeshTopology::Clear();
+      if (ok) {
+        n_succeeded++;
+      } else {
+        n_failed++;
+      }
+
+      // a signal from the batch system ends the ensemble, not just the member
+      if (!allSucceeded(!ATS::Coordinator::signal_received(), group_mpi_comm)) {
+        if (comm->MyPID() == 0) {
+          std::cerr << "Signal received: not starting further ensemble members." << std::endl;
+        }
+        break;
+      }
+    }
+
+    // count each failure once
+    if (comm->MyPID() != 0) {
+      n_failed = 0;
+      n_succeeded = 0;
+    }
+  }
+  MPI_Comm_free(&group_mpi_comm);
+
+  int local_counts[2] = { n_succeeded, n_failed };
+  int counts[2] = { 0, 0 };
+  MPI_Allreduce(local_counts, counts, 2, MPI_INT, MPI_SUM, mpi_comm);
+  if(out.get() && includesVerbLevel(verbLevel,Teuchos::VERB_LOW,true)) {
+    *out << "Ensemble complete: " << counts[0] << " of "
+         << members.size() << " members succeeded." << std::endl;
+  }
+  return counts[0] < (int) members.size() ? 1 : 0;
+}
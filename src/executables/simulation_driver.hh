@@ -26,6 +26,33 @@ ATS's top-level main accepts an XML list including a few required elements.
     * `"checkpoint`" ``[checkpoint-spec]`` See Checkpoint_.      
     * `"PKs`" ``[pk-typed-spec-list]`` A list of PK_ objects.
     * `"state`" ``[state-spec]`` See State_.
+    * `"ensemble`" ``[ensemble-spec]`` **optional** If provided, run an
+      ensemble of simulations on the same meshes.  See below.
+
+An ensemble runs many simulations that differ only in parameters, for
+instance realizations of WRM or thermal parameters for uncertainty
+quantification.  Meshes and regions are created once and shared by all
+members; each member has its own State and Coordinator.  Each member's input
+is the main list with the member's overrides applied on top, so an override
+list mirrors the structure of the main list.  Members run one after another,
+or, if `"processes per member`" is less than the number of processes, on
+separate groups of processes at the same time.  A member that fails does not
+stop the ensemble; a signal handled by a member's `"checkpoint on signal`"
+does, after that member's final checkpoint.
+
+Output file names for visualization, checkpoints (including those written on
+failure), observations and the timer tree are suffixed with the member's
+name.  Deformable meshes are not shared;
+they are recreated for each member.
+
+.. _ensemble-spec:
+.. admonition:: ensemble-spec
+
+    * `"processes per member`" ``[int]`` **all processes** Number of processes
+      used by each member.  Must divide the number of processes.
+    * `"members`" ``[list]`` One sublist per member, named by the member, of
+      overrides to the main list.  Overrides may not include `"mesh`" or
+      `"regions`".
 
  */
   
@@ -39,4 +66,7 @@ struct SimulationDriver
   virtual int Run (const MPI_Comm&               mpi_comm,
                    Teuchos::ParameterList&       input_parameter_list);
 
+  virtual int RunEnsemble (const MPI_Comm&               mpi_comm,
+                           Teuchos::ParameterList&       input_parameter_list);
+
 };
@@ -0,0 +1,146 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of TimestepHistory, which caps the time step size using the
+history of nonlinear iterations, failures, and the freeze/thaw state of the
+forcing.
+------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <cmath>
+
+#include "errors.hh"
+#include "State.hh"
+
+#include "timestep_history.hh"
+
+namespace ATS {
+
+TimestepHistory::TimestepHistory(Teuchos::ParameterList& plist,
+                                 const Amanzi::Comm_ptr_type& comm) :
+    comm_(comm),
+    dt_last_(-1.),
+    iterations_last_(-1),
+    fail_cap_(-1.),
+    cycles_since_fail_(-1),
+    distance_(-1.),
+    distance_rate_(0.),
+    t_last_(-1.),
+    n_proposed_(0),
+    n_limited_(0)
+{
+  target_iterations_ = plist.get<int>("target nonlinear iterations", 6);
+  max_growth_ = plist.get<double>("max growth factor", 1.5);
+  max_reduction_ = plist.get<double>("max reduction factor", 0.5);
+  fail_factor_ = plist.get<double>("failure cap factor", 0.8);
+  fail_growth_ = plist.get<double>("failure cap growth factor", 1.1);
+  fail_memory_ = plist.get<int>("failure memory [cycles]", 20);
+
+  air_temp_key_ = plist.get<std::string>("air temperature key", "");
+  T_freeze_ = plist.get<double>("freezing temperature [K]", 273.15);
+  band_ = plist.get<double>("freeze-thaw band [K]", 1.0);
+  band_dt_ = plist.get<double>("freeze-thaw max time step [s]", 3600.);
+
+  if (target_iterations_ < 1 || max_growth_ < 1. || max_reduction_ <= 0. || max_reduction_ > 1.
+      || fail_factor_ <= 0. || fail_factor_ >= 1. || fail_growth_ < 1.) {
+    Errors::Message msg("Coordinator: invalid \"time step history\" parameters.");
+    Exceptions::amanzi_throw(msg);
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Update the history with a step.
+// -----------------------------------------------------------------------------
+void TimestepHistory::Record(const Amanzi::State& S, double dt, bool fail,
+                             int nonlinear_iterations)
+{
+  if (fail) {
+    // a failure soon after another lowers the previous cap
+    if (cycles_since_fail_ >= 0 && cycles_since_fail_ <= fail_memory_) {
+      fail_cap_ = fail_factor_ * std::min(dt, fail_cap_);
+    } else {
+      fail_cap_ = fail_factor_ * dt;
+    }
+    cycles_since_fail_ = 0;
+    return;
+  }
+
+  dt_last_ = dt;
+  iterations_last_ = nonlinear_iterations;
+  if (cycles_since_fail_ >= 0) {
+    cycles_since_fail_++;
+    fail_cap_ *= fail_growth_;
+  }
+
+  if (!air_temp_key_.empty()) {
+    double distance = DistanceToFreezing_(S);
+    if (t_last_ >= 0. && S.time() > t_last_) {
+      distance_rate_ = (distance - distance_) / (S.time() - t_last_);
+    }
+    distance_ = distance;
+    t_last_ = S.time();
+  }
+}
+
+
+double TimestepHistory::Limit(double dt)
+{
+  double limit = dt;
+
+  // nonlinear iterations of the last successful step
+  if (dt_last_ > 0. && iterations_last_ >= 0) {
+    double factor = iterations_last_ == 0 ? max_growth_ :
+        static_cast<double>(target_iterations_) / iterations_last_;
+    factor = std::max(max_reduction_, std::min(max_growth_, factor));
+    limit = std::min(limit, factor * dt_last_);
+  }
+
+  // recent failures
+  if (cycles_since_fail_ >= 0) limit = std::min(limit, fail_cap_);
+
+  // freeze/thaw of the forcing, current or extrapolated
+  if (t_last_ >= 0.) {
+    if (distance_ < band_) {
+      limit = std::min(limit, band_dt_);
+    } else if (distance_rate_ < 0.) {
+      double time_to_band = (distance_ - band_) / -distance_rate_;
+      limit = std::min(limit, std::max(time_to_band, band_dt_));
+    }
+  }
+
+  n_proposed_++;
+  if (limit < dt) n_limited_++;
+  return limit;
+}
+
+
+// -----------------------------------------------------------------------------
+// Minimum, over the domain, of the distance of the forcing temperature from
+// freezing.
+// -----------------------------------------------------------------------------
+double TimestepHistory::DistanceToFreezing_(const Amanzi::State& S) const
+{
+  if (!S.HasField(air_temp_key_)) {
+    Errors::Message msg;
+    msg << "Coordinator: \"time step history\" \"air temperature key\" \""
+        << air_temp_key_ << "\" is not a field in State.";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  const Epetra_MultiVector& temp = *S.GetFieldData(air_temp_key_)->ViewComponent("cell", false);
+  double distance = 1.e99;
+  for (int c=0; c!=temp.MyLength(); ++c) {
+    distance = std::min(distance, std::abs(temp[0][c] - T_freeze_));
+  }
+
+  double global_distance(0.);
+  comm_->MinAll(&distance, &global_distance, 1);
+  return global_distance;
+}
+
+} // namespace ATS
@@ -0,0 +1,121 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Limits the coordinator's time step size using the history of recent steps.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+PK time step controllers choose the next step size from the most recent step
+only.  Near difficult transitions such as freeze-up and snowmelt this leads to
+repeated cycles of failing, shrinking, growing back to the size that failed,
+and failing again.  Each failure costs a full nonlinear solve and a rollback
+of state.
+
+The time step history controller, set in the `"time step history`" sublist of
+the `"cycle driver`" list, caps the step size chosen by the PK using:
+
+- Nonlinear iterations.  The step is limited to the last successful step
+  scaled by the ratio of `"target nonlinear iterations`" to the number of
+  iterations it took, within `"max reduction factor`" and `"max growth
+  factor`".
+- Failures.  After a failed step, the step size is capped below the size that
+  failed, and that cap grows back slowly, by `"failure cap growth factor`"
+  per successful step, rather than at the rate of the PK's controller.  Each
+  failure within `"failure memory [cycles]`" of the last lowers the cap
+  further.
+- Freeze/thaw of the forcing.  If `"air temperature key`" is given, the
+  coordinator watches how close that field is, anywhere in the domain, to
+  freezing.  Within `"freeze-thaw band [K]`" of freezing the step is capped at
+  `"freeze-thaw max time step [s]`".  Outside the band, the rate at which the
+  forcing approaches freezing is extrapolated, and the step is cut so that it
+  ends as the forcing enters the band, stepping down ahead of the event rather
+  than failing in it.
+
+.. _time-step-history-spec:
+.. admonition:: time-step-history-spec
+
+    * `"target nonlinear iterations`" ``[int]`` **6**
+    * `"max growth factor`" ``[double]`` **1.5**
+    * `"max reduction factor`" ``[double]`` **0.5**
+    * `"failure cap factor`" ``[double]`` **0.8** Ratio of the cap to the
+      step size that failed.
+    * `"failure cap growth factor`" ``[double]`` **1.1**
+    * `"failure memory [cycles]`" ``[int]`` **20**
+    * `"air temperature key`" ``[string]`` **optional** e.g.
+      `"surface-air_temperature`"
+    * `"freezing temperature [K]`" ``[double]`` **273.15**
+    * `"freeze-thaw band [K]`" ``[double]`` **1.0**
+    * `"freeze-thaw max time step [s]`" ``[double]`` **3600.**
+
+*/
+
+#ifndef ATS_TIMESTEP_HISTORY_HH_
+#define ATS_TIMESTEP_HISTORY_HH_
+
+#include <string>
+
+#include "Teuchos_ParameterList.hpp"
+#include "AmanziComm.hh"
+
+namespace Amanzi {
+class State;
+};
+
+
+namespace ATS {
+
+class TimestepHistory {
+
+ public:
+  TimestepHistory(Teuchos::ParameterList& plist,
+                  const Amanzi::Comm_ptr_type& comm);
+
+  // Collective.  Records an attempted step of size dt.  S is the state at
+  // the end of the step if it succeeded.  A negative number of nonlinear
+  // iterations means the count is unknown.
+  void Record(const Amanzi::State& S, double dt, bool fail, int nonlinear_iterations);
+
+  // Limits a step size proposed by the PKs, counting the proposals and those
+  // that were limited.
+  double Limit(double dt);
+
+  // Counts of proposed and of limited steps, for reporting.
+  int proposed_count() const { return n_proposed_; }
+  int limited_count() const { return n_limited_; }
+
+ private:
+  double DistanceToFreezing_(const Amanzi::State& S) const;
+
+ private:
+  Amanzi::Comm_ptr_type comm_;
+
+  int target_iterations_;
+  double max_growth_, max_reduction_;
+  double fail_factor_, fail_growth_;
+  int fail_memory_;
+
+  std::string air_temp_key_;
+  double T_freeze_;
+  double band_;
+  double band_dt_;
+
+  // history
+  double dt_last_;
+  int iterations_last_;
+  double fail_cap_;
+  int cycles_since_fail_;
+  double distance_;
+  double distance_rate_;
+  double t_last_;
+  int n_proposed_, n_limited_;
+};
+
+} // namespace ATS
+
+#endif
@@ -0,0 +1,208 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+/* -------------------------------------------------------------------------
+   ATS
+
+   License: see $ATS_DIR/COPYRIGHT
+   Author: Ethan Coon
+
+   Implementation of the ColumnPreconditioner, tridiagonal solves along mesh
+   columns.
+   ------------------------------------------------------------------------- */
+
+#include <cmath>
+
+#include "Epetra_CrsMatrix.h"
+#include "errors.hh"
+
+#include "column_preconditioner.hh"
+
+namespace Amanzi {
+namespace Operators {
+
+ColumnPreconditioner::ColumnPreconditioner(Teuchos::ParameterList& plist,
+        const Teuchos::RCP<Operator>& op) :
+    op_(op),
+    mesh_(op->DomainMap().Mesh()),
+    symbolic_assembled_(false)
+{
+  std::string stage = plist.get<std::string>("stage", "columns");
+  if (stage == "columns") {
+    two_stage_ = false;
+  } else if (stage == "two stage") {
+    two_stage_ = true;
+  } else {
+    Errors::Message msg;
+    msg << "ColumnPreconditioner: invalid \"stage\" \"" << stage
+        << "\", valid are \"columns\" and \"two stage\".";
+    Exceptions::amanzi_throw(msg);
+  }
+
+  if (op_->DomainMap().HasComponent("face") || op_->DomainMap().size() != 1) {
+    Errors::Message msg("ColumnPreconditioner: requires a discretization with only cell unknowns, e.g. \"fv: default\".");
+    Exceptions::amanzi_throw(msg);
+  }
+
+  // lines: the columns, then the cells in no column
+  int ncells = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+  int ncols = mesh_->num_columns(false);
+  if (ncols == 0) {
+    Errors::Message msg("ColumnPreconditioner: the mesh has no columns; use \"build columns from set\" in the mesh list.");
+    Exceptions::amanzi_throw(msg);
+  }
+
+  std::vector<bool> in_column(ncells, false);
+  line_offsets_.push_back(0);
+  for (int col=0; col!=ncols; ++col) {
+    for (auto c : mesh_->cells_of_column(col)) {
+      if (c >= ncells) {
+        Errors::Message msg;
+        msg << "ColumnPreconditioner: column " << col << " contains cell " << c
+            << ", which this process does not own; the mesh must be partitioned"
+            << " so that no column is split across processes.";
+        Exceptions::amanzi_throw(msg);
+      }
+      line_cells_.push_back(c);
+      in_column[c] = true;
+    }
+    line_offsets_.push_back(line_cells_.size());
+  }
+  for (int c=0; c!=ncells; ++c) {
+    if (!in_column[c]) {
+      line_cells_.push_back(c);
+      line_offsets_.push_back(line_cells_.size());
+    }
+  }
+
+  lower_.resize(line_cells_.size());
+  upper_.resize(line_cells_.size());
+  inv_pivot_.resize(line_cells_.size());
+}
+
+
+// -----------------------------------------------------------------------------
+// Extract the tridiagonal systems from the assembled matrix and factor them.
+//
+// With one unknown per cell, the rows of the assembled matrix are ordered as
+// the owned cells.  The matrix is assembled once per update: in two stage
+// mode by the operator, as it computes its own inverse.
+// -----------------------------------------------------------------------------
+void ColumnPreconditioner::Update()
+{
+  if (two_stage_) {
+    op_->ComputeInverse();
+  } else {
+    if (!symbolic_assembled_) {
+      op_->SymbolicAssembleMatrix();
+      symbolic_assembled_ = true;
+    }
+    op_->AssembleMatrix();
+  }
+  const Epetra_CrsMatrix& A = *op_->A();
+  AMANZI_ASSERT(A.NumMyRows() == mesh_->num_entities(AmanziMesh::CELL,
+          AmanziMesh::Parallel_type::OWNED));
+
+  int nlines = line_offsets_.size() - 1;
+  for (int l=0; l!=nlines; ++l) {
+    int begin = line_offsets_[l];
+    int end = line_offsets_[l+1];
+
+    // the diagonal is factored in place into inv_pivot_
+    for (int k=begin; k!=end; ++k) {
+      int row = line_cells_[k];
+      int gid = A.RowMap().GID(row);
+      int gid_above = k > begin ? A.RowMap().GID(line_cells_[k-1]) : -1;
+      int gid_below = k < end-1 ? A.RowMap().GID(line_cells_[k+1]) : -1;
+
+      int nentries;
+      double* values;
+      int* indices;
+      A.ExtractMyRowView(row, nentries, values, indices);
+
+      double diag(0.), above(0.), below(0.);
+      for (int j=0; j!=nentries; ++j) {
+        int gcol = A.ColMap().GID(indices[j]);
+        if (gcol == gid) diag += values[j];
+        else if (gcol == gid_above) above += values[j];
+        else if (gcol == gid_below) below += values[j];
+      }
+      lower_[k] = above;
+      inv_pivot_[k] = diag;
+      upper_[k] = below;
+    }
+
+    int bad = FactorTridiagonal(end - begin, &lower_[begin], &inv_pivot_[begin], &upper_[begin]);
+    if (bad >= 0) {
+      Errors::Message msg;
+      msg << "ColumnPreconditioner: zero pivot in the column of cell "
+          << line_cells_[begin + bad] << ".";
+      Exceptions::amanzi_throw(msg);
+    }
+  }
+}
+
+
+int ColumnPreconditioner::ApplyInverse(const CompositeVector& X, CompositeVector& Y) const
+{
+  ApplyColumns_(X, Y);
+  if (!two_stage_) return 1;
+
+  // correct the remaining residual with the operator's inverse
+  CompositeVector R(X);
+  op_->Apply(Y, R);
+  R.Update(1., X, -1.);
+
+  CompositeVector dY(Y);
+  dY.PutScalar(0.);
+  int ierr = op_->ApplyInverse(R, dY);
+  Y.Update(1., dY, 1.);
+  return ierr;
+}
+
+
+void ColumnPreconditioner::ApplyColumns_(const CompositeVector& X, CompositeVector& Y) const
+{
+  const Epetra_MultiVector& x = *X.ViewComponent("cell", false);
+  Epetra_MultiVector& y = *Y.ViewComponent("cell", false);
+
+  int nlines = line_offsets_.size() - 1;
+  for (int l=0; l!=nlines; ++l) {
+    int begin = line_offsets_[l];
+    SolveTridiagonal(line_offsets_[l+1] - begin, &lower_[begin], &inv_pivot_[begin],
+                     &upper_[begin], &line_cells_[begin], x[0], y[0]);
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Thomas algorithm.
+// -----------------------------------------------------------------------------
+int FactorTridiagonal(int n, const double* lower, double* diag, double* upper)
+{
+  for (int i=0; i!=n; ++i) {
+    double pivot = i > 0 ? diag[i] - lower[i] * upper[i-1] : diag[i];
+    if (std::abs(pivot) < 1.e-300) return i;
+    diag[i] = 1. / pivot;
+    upper[i] *= diag[i];
+  }
+  return -1;
+}
+
+
+void SolveTridiagonal(int n, const double* lower, const double* inv_pivot,
+                      const double* upper, const int* rows, const double* x, double* y)
+{
+  // forward elimination
+  double y_above = 0.;
+  for (int i=0; i!=n; ++i) {
+    y[rows[i]] = (x[rows[i]] - lower[i] * y_above) * inv_pivot[i];
+    y_above = y[rows[i]];
+  }
+
+  // back substitution
+  for (int i=n-2; i>=0; --i) {
+    y[rows[i]] -= upper[i] * y[rows[i+1]];
+  }
+}
+
+} // namespace Operators
+} // namespace Amanzi
@@ -0,0 +1,112 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! ColumnPreconditioner: exact tridiagonal solves along the columns of an extruded mesh.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+On meshes extruded from a 2D surface, cells are thin layers and the vertical
+coupling in the diffusion operator is much stronger than the lateral coupling.
+Algebraic multigrid and incomplete factorizations handle this anisotropy
+poorly.  The column preconditioner instead solves each column exactly: from
+the assembled matrix of a cell-centered operator, it keeps the couplings of
+each cell to the cells above and below it in its column, drops the lateral
+couplings, and factors the resulting tridiagonal systems with the Thomas
+algorithm.  Cells that are not in a column are treated by their diagonal.
+
+Used alone, this is a block Jacobi preconditioner with one block per column.
+It may also be used as the first stage of a two stage preconditioner: the
+columns are solved, and the remaining residual is then corrected by the
+operator's own inverse, typically AMG, which handles the lateral coupling.
+
+This requires the mesh to have been built with `"build columns from set`", and
+a discretization with cells as the only unknowns, e.g. `"fv: default`".
+
+.. _column-preconditioner-spec:
+.. admonition:: column-preconditioner-spec
+
+    * `"stage`" ``[string]`` **columns** One of:
+
+      - `"columns`" Solve the columns only.
+      - `"two stage`" Solve the columns, then correct with the operator's
+        inverse.
+
+In `"columns`" mode the operator's inverse is never used, and is not set
+up.  In `"two stage`" mode the matrix is assembled once per update, as the
+operator computes its inverse, and the columns are read from it.
+
+*/
+
+#ifndef OPERATORS_COLUMN_PRECONDITIONER_HH_
+#define OPERATORS_COLUMN_PRECONDITIONER_HH_
+
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Mesh.hh"
+#include "CompositeVector.hh"
+#include "Operator.hh"
+
+namespace Amanzi {
+namespace Operators {
+
+class ColumnPreconditioner {
+
+ public:
+  ColumnPreconditioner(Teuchos::ParameterList& plist,
+                       const Teuchos::RCP<Operator>& op);
+
+  // Assembles the operator's matrix, and in two stage mode computes its
+  // inverse, then factors the column systems.
+  void Update();
+
+  // Y = P^-1 X.  Returns a positive value on success.
+  int ApplyInverse(const CompositeVector& X, CompositeVector& Y) const;
+
+  // Linear iterations of the operator's inverse in the last application.
+  // The columns are solved directly, so this is zero unless two stage.
+  int num_itrs() const { return two_stage_ ? op_->num_itrs() : 0; }
+
+ private:
+  void ApplyColumns_(const CompositeVector& X, CompositeVector& Y) const;
+
+ private:
+  Teuchos::RCP<Operator> op_;
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh_;
+  bool two_stage_;
+  bool symbolic_assembled_;
+
+  // lines of cells, the columns followed by one line per cell in no column
+  std::vector<int> line_offsets_;
+  std::vector<AmanziMesh::Entity_ID> line_cells_;
+
+  // Thomas factors, indexed as line_cells_: coupling to the cell above,
+  // eliminated coupling to the cell below, and inverse of the pivot
+  std::vector<double> lower_;
+  std::vector<double> upper_;
+  std::vector<double> inv_pivot_;
+};
+
+
+// Factors, in place, the tridiagonal system of n rows with sub-, main, and
+// super-diagonals lower, diag, and upper, where lower[0] and upper[n-1] are
+// zero.  On return diag holds the inverse pivots and upper the eliminated
+// super-diagonal.  Returns the first row with a zero pivot, or -1.
+int FactorTridiagonal(int n, const double* lower, double* diag, double* upper);
+
+// Solves the factored system for y given x, where row i of the system is
+// entry rows[i] of x and y.
+void SolveTridiagonal(int n, const double* lower, const double* inv_pivot,
+                      const double* upper, const int* rows, const double* x, double* y);
+
+} // namespace Operators
+} // namespace Amanzi
+
+#endif
@@ -0,0 +1,59 @@
+#include <cmath>
+#include <vector>
+#include "UnitTest++.h"
+
+#include "column_preconditioner.hh"
+
+using namespace Amanzi::Operators;
+
+// A column of cells, as ColumnPreconditioner sees it: rows of the system are
+// scattered through the vectors, in the order given by rows.
+TEST(TRIDIAGONAL_SOLVE) {
+  int n = 7;
+  std::vector<int> rows = { 5, 2, 8, 0, 3, 7, 1 };
+  std::vector<double> lower(n), diag(n), upper(n);
+  for (int i=0; i!=n; ++i) {
+    lower[i] = i > 0 ? -1. - 0.1*i : 0.;
+    upper[i] = i < n-1 ? -1. + 0.05*i : 0.;
+    diag[i] = 2.5 + 0.3*std::sin(i);
+  }
+  std::vector<double> lower0(lower), diag0(diag), upper0(upper);
+
+  std::vector<double> x(9, 0.), y(9, -99.);
+  for (int i=0; i!=n; ++i) x[rows[i]] = std::cos(1. + i);
+
+  CHECK_EQUAL(-1, FactorTridiagonal(n, &lower[0], &diag[0], &upper[0]));
+  SolveTridiagonal(n, &lower[0], &diag[0], &upper[0], &rows[0], &x[0], &y[0]);
+
+  // the residual of the original system
+  for (int i=0; i!=n; ++i) {
+    double Ay = diag0[i] * y[rows[i]];
+    if (i > 0) Ay += lower0[i] * y[rows[i-1]];
+    if (i < n-1) Ay += upper0[i] * y[rows[i+1]];
+    CHECK_CLOSE(x[rows[i]], Ay, 1.e-12);
+  }
+
+  // entries not in the column are untouched
+  CHECK_EQUAL(-99., y[4]);
+  CHECK_EQUAL(-99., y[6]);
+}
+
+
+// A cell in no column is a line of one row, solved by its diagonal.
+TEST(TRIDIAGONAL_SINGLE_ROW) {
+  double lower = 0., diag = 4., upper = 0.;
+  int row = 0;
+  double x = 2., y = 0.;
+  CHECK_EQUAL(-1, FactorTridiagonal(1, &lower, &diag, &upper));
+  SolveTridiagonal(1, &lower, &diag, &upper, &row, &x, &y);
+  CHECK_CLOSE(0.5, y, 1.e-15);
+}
+
+
+// A singular system reports the row of the zero pivot.
+TEST(TRIDIAGONAL_ZERO_PIVOT) {
+  std::vector<double> lower = { 0., 1., 1. };
+  std::vector<double> diag = { 1., 1., 2. };
+  std::vector<double> upper = { 1., 1., 0. };
+  CHECK_EQUAL(1, FactorTridiagonal(3, &lower[0], &diag[0], &upper[0]));
+}
@@ -0,0 +1,91 @@
+#include <cmath>
+#include <vector>
+#include "UnitTest++.h"
+
+#include "Teuchos_RCP.hpp"
+#include "AmanziComm.hh"
+#include "MeshFactory.hh"
+#include "CompositeVector.hh"
+
+#include "mesh_topology.hh"
+#include "upwind_total_flux.hh"
+
+using namespace Amanzi;
+
+// Upwinding on the active faces, those next to a cell or boundary face with
+// nonzero coefficient, gives the same face coefficients as upwinding on all
+// faces.
+TEST(UPWIND_TOTAL_FLUX_ACTIVE_FACES) {
+  auto comm = getDefaultComm();
+  AmanziMesh::MeshFactory meshfactory(comm);
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh = meshfactory.create(0.0, 0.0, 1.0, 1.0, 8, 8);
+  const MeshTopology& topo = MeshTopology::Get(mesh);
+
+  double eps = 1.e-3;
+
+  CompositeVectorSpace cell_space;
+  cell_space.SetMesh(mesh)->SetGhosted()->SetComponent("cell", AmanziMesh::CELL, 1);
+  CompositeVectorSpace face_space;
+  face_space.SetMesh(mesh)->SetGhosted()->SetComponent("face", AmanziMesh::FACE, 1);
+
+  // a ponded patch in one corner, dry elsewhere
+  CompositeVector cell_coef(cell_space);
+  Epetra_MultiVector& cell_coef_c = *cell_coef.ViewComponent("cell", false);
+  for (int c=0; c!=cell_coef_c.MyLength(); ++c) {
+    AmanziGeometry::Point xc = mesh->cell_centroid(c);
+    cell_coef_c[0][c] = (xc[0] < 0.3 && xc[1] < 0.5) ? 1. + xc[0] + 2*xc[1] : 0.;
+  }
+
+  // fluxes of both signs, including zero and small fluxes
+  CompositeVector flux(face_space);
+  Epetra_MultiVector& flux_f = *flux.ViewComponent("face", false);
+  int nfaces = flux_f.MyLength();
+  for (int f=0; f!=nfaces; ++f) {
+    if (f % 5 == 0) {
+      flux_f[0][f] = 0.;
+    } else if (f % 5 == 1) {
+      flux_f[0][f] = 0.3 * eps * std::sin(1. + f);
+    } else {
+      flux_f[0][f] = std::sin(1. + f);
+    }
+  }
+
+  // boundary conductivity on part of the boundary, a stale value elsewhere
+  CompositeVector face_coef0(face_space);
+  Epetra_MultiVector& face_coef0_f = *face_coef0.ViewComponent("face", false);
+  for (int f=0; f!=nfaces; ++f) {
+    if (topo.face_boundary_face(f) >= 0) {
+      face_coef0_f[0][f] = mesh->face_centroid(f)[1] > 0.8 ? 0.5 : 0.;
+    } else {
+      face_coef0_f[0][f] = 7.;
+    }
+  }
+
+  // the active faces
+  Teuchos::RCP<std::vector<int> > active = Teuchos::rcp(new std::vector<int>());
+  cell_coef.ScatterMasterToGhosted("cell");
+  const Epetra_MultiVector& cell_coef_g = *cell_coef.ViewComponent("cell", true);
+  for (int f=0; f!=nfaces; ++f) {
+    bool wet = topo.face_boundary_face(f) >= 0 && face_coef0_f[0][f] > 0.;
+    for (int n=0; n!=topo.face_num_cells(f); ++n)
+      wet |= cell_coef_g[0][topo.face_cells(f)[n]] > 0.;
+    if (wet) active->push_back(f);
+  }
+  CHECK(active->size() > 0);
+  CHECK(active->size() < nfaces);
+
+  Operators::UpwindTotalFlux upwind("pk", "cell_coef", "face_coef", "flux", eps);
+
+  CompositeVector face_coef_full(face_coef0);
+  upwind.CalculateCoefficientsOnFaces(cell_coef, flux, Teuchos::ptr(&face_coef_full), Teuchos::null);
+
+  CompositeVector face_coef_active(face_coef0);
+  upwind.SetActiveFaces(active);
+  upwind.CalculateCoefficientsOnFaces(cell_coef, flux, Teuchos::ptr(&face_coef_active), Teuchos::null);
+
+  const Epetra_MultiVector& full_f = *face_coef_full.ViewComponent("face", false);
+  const Epetra_MultiVector& active_f = *face_coef_active.ViewComponent("face", false);
+  for (int f=0; f!=nfaces; ++f) {
+    CHECK_EQUAL(full_f[0][f], active_f[0][f]);
+  }
+}
@@ -15,6 +15,7 @@
 #include "State.hh"
 #include "Debugger.hh"
 #include "VerboseObject.hh"
+#include "mesh_topology.hh"
 #include "upwind_total_flux.hh"
 #include "Epetra_IntVector.h"
 
@@ -48,6 +49,11 @@ void UpwindTotalFlux::CalculateCoefficientsOnFaces(
         const CompositeVector& flux,
         const Teuchos::Ptr<CompositeVector>& face_coef,
         const Teuchos::Ptr<Debugger>& db) {
+  if (active_faces_ != Teuchos::null && !face_coef->HasComponent("cell")) {
+    CalculateCoefficientsOnActiveFaces(cell_coef, flux, face_coef);
+    return;
+  }
+
   Teuchos::RCP<const AmanziMesh::Mesh> mesh = face_coef->Mesh();
 
   // initialize the face coefficients
@@ -172,6 +178,69 @@ void UpwindTotalFlux::CalculateCoefficientsOnFaces(
 };
 
 
+// -----------------------------------------------------------------------------
+// Same as above, but looping over the active faces instead of all cells.
+//
+// MeshTopology lists the cells of a face in increasing order, so that with
+// zero flux the upwind cell is the one the cell loop above would choose.
+// -----------------------------------------------------------------------------
+void UpwindTotalFlux::CalculateCoefficientsOnActiveFaces(
+        const CompositeVector& cell_coef,
+        const CompositeVector& flux,
+        const Teuchos::Ptr<CompositeVector>& face_coef) {
+  const MeshTopology& topo = MeshTopology::Get(face_coef->Mesh());
+  const std::vector<int>& active = *active_faces_;
+
+  cell_coef.ScatterMasterToGhosted("cell");
+
+  const Epetra_MultiVector& flux_v = *flux.ViewComponent("face",false);
+  Epetra_MultiVector& coef_faces = *face_coef->ViewComponent("face",false);
+  const Epetra_MultiVector& coef_cells = *cell_coef.ViewComponent("cell",true);
+
+  // Faces not in the set have zero conductivity on both sides.
+  int nfaces = face_coef->size("face",false);
+  int f_next = 0;
+
+  double coefs[2];
+  for (auto f : active) {
+    AMANZI_ASSERT(f >= f_next && f < nfaces);
+    for (; f_next!=f; ++f_next) coef_faces[0][f_next] = 0.;
+    f_next = f+1;
+
+    const AmanziMesh::Entity_ID* cells = topo.face_cells(f);
+    const int* dirs = topo.face_dirs(f);
+
+    int uw = -1;
+    int dw = -1;
+    for (int n=0; n!=topo.face_num_cells(f); ++n) {
+      if (flux_v[0][f] * dirs[n] > 0) {
+        uw = cells[n];
+      } else if (flux_v[0][f] * dirs[n] < 0) {
+        dw = cells[n];
+      } else if (uw == -1) {
+        uw = cells[n];
+      } else {
+        dw = cells[n];
+      }
+    }
+    AMANZI_ASSERT(!((uw == -1) && (dw == -1)));
+
+    coefs[0] = uw == -1 ? coef_faces[0][f] : coef_cells[0][uw];
+    coefs[1] = dw == -1 ? coef_faces[0][f] : coef_cells[0][dw];
+
+    if (std::abs(flux_v[0][f]) >= flux_eps_) {
+      coef_faces[0][f] = coefs[0];
+    } else {
+      double param = std::abs(flux_v[0][f]) / (2*flux_eps_) + 0.5;
+      AMANZI_ASSERT(param >= 0.5);
+      AMANZI_ASSERT(param <= 1.0);
+      coef_faces[0][f] = coefs[0] * param + coefs[1] * (1. - param);
+    }
+  }
+  for (; f_next!=nfaces; ++f_next) coef_faces[0][f_next] = 0.;
+};
+
+
 void
 UpwindTotalFlux::UpdateDerivatives(const Teuchos::Ptr<State>& S,
                                         std::string potential_key, 
@@ -42,6 +42,12 @@ public:
         const Teuchos::Ptr<CompositeVector>& face_coef,
         const Teuchos::Ptr<Debugger>& db);
 
+  // As above, restricted to the active faces.
+  void CalculateCoefficientsOnActiveFaces(
+        const CompositeVector& cell_coef,
+        const CompositeVector& flux,
+        const Teuchos::Ptr<CompositeVector>& face_coef);
+
   virtual void
   UpdateDerivatives(const Teuchos::Ptr<State>& S, 
                     std::string potential_key,
@@ -13,6 +13,8 @@
 #ifndef AMANZI_UPWINDING_SCHEME_
 #define AMANZI_UPWINDING_SCHEME_
 
+#include <vector>
+
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_SerialDenseMatrix.hpp"
 
@@ -57,7 +59,16 @@ class Upwinding {
 
   virtual std::string
   CoefficientLocation() = 0;
-  
+
+  // Restricts Update() to a subset of the owned faces, given in increasing
+  // order; the coefficient on all other faces is set to zero.  A null list
+  // means all faces.  Schemes that do not support this update all faces.
+  void SetActiveFaces(const Teuchos::RCP<const std::vector<int> >& faces) {
+    active_faces_ = faces;
+  }
+
+ protected:
+  Teuchos::RCP<const std::vector<int> > active_faces_;
 
 };
 
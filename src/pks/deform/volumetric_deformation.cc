@@ -21,6 +21,7 @@
 
 #include "CompositeVectorFunctionFactory.hh"
 
+#include "mesh_topology.hh"
 #include "volumetric_deformation.hh"
 
 #define DEBUG 0
@@ -702,6 +703,11 @@ bool VolumetricDeformation::AdvanceStep(double t_old, double t_new, bool reinit)
     surf3d_mesh_nc_->deform(surface3d_nodeids, surface3d_newpos, false, &surface_finpos);
   }
 
+  // cached topology of the deformed meshes is rebuilt on next use
+  MeshTopology::Invalidate(*mesh_);
+  if (surf_mesh_ != Teuchos::null) MeshTopology::Invalidate(*surf_mesh_);
+  if (surf3d_mesh_ != Teuchos::null) MeshTopology::Invalidate(*surf3d_mesh_);
+
   {  // update vertex coordinates in state (for checkpointing and error recovery)
     Epetra_MultiVector& vc =
       *S_next_->GetFieldData(Keys::getKey(domain_,"vertex_coordinate"),name_)
@@ -10,6 +10,8 @@ Energy for a three-phase, gas+liquid+ice evaluator.
 #ifndef AMANZI_ENERGY_THREE_PHASE_ENERGY_EVALUATOR_HH_
 #define AMANZI_ENERGY_THREE_PHASE_ENERGY_EVALUATOR_HH_
 
+#include <vector>
+
 #include "Factory.hh"
 #include "secondary_variable_field_evaluator.hh"
 
@@ -34,6 +36,16 @@ class ThreePhaseEnergyEvaluator : public SecondaryVariableFieldEvaluator {
   virtual void EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
           Key wrt_key, const Teuchos::Ptr<CompositeVector>& result);
 
+  // Evaluates, in one sweep over the cells, the value (if result is not
+  // null) and the partial derivatives with respect to each of wrt_keys.
+  void EvaluateFieldPartialDerivatives_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& result,
+          const std::vector<Key>& wrt_keys,
+          const std::vector<Teuchos::Ptr<CompositeVector> >& dresults);
+
+  // Computes all partial derivatives needed by the chain rule at once.
+  virtual void UpdateFieldDerivative_(const Teuchos::Ptr<State>& S, Key wrt_key);
+
   Teuchos::RCP<ThreePhaseEnergyModel> get_model() { return model_; }
 
  protected:
@@ -56,6 +68,11 @@ class ThreePhaseEnergyEvaluator : public SecondaryVariableFieldEvaluator {
 
   Teuchos::RCP<ThreePhaseEnergyModel> model_;
 
+  // workspace for the partial derivatives, one per dependency
+  std::vector<Teuchos::RCP<CompositeVector> > partials_;
+  // workspace for outputs of the array kernels that were not requested
+  std::vector<double> scratch_;
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,ThreePhaseEnergyEvaluator> reg_;
 
@@ -121,6 +121,161 @@ ThreePhaseEnergyModel::DEnergyDCellVolume(double phi, double phi0, double sl, do
   return phi*(ng*sg*ug + ni*si*ui + nl*sl*ul) + rho_r*ur*(-phi0 + 1);
 }
 
+// array kernels
+void
+ThreePhaseEnergyModel::EnergyKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*(phi[i]*(ng[i]*sg[i]*ug[i] + ni[i]*si[i]*ui[i] + nl[i]*sl[i]*ul[i]) + rho_r[i]*ur[i]*(1 - phi0[i]));
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDPorosityKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*(ng[i]*sg[i]*ug[i] + ni[i]*si[i]*ui[i] + nl[i]*sl[i]*ul[i]);
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDBasePorosityKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = -cv[i]*rho_r[i]*ur[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDSaturationLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*nl[i]*phi[i]*ul[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDMolarDensityLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*phi[i]*sl[i]*ul[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDInternalEnergyLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*nl[i]*phi[i]*sl[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDSaturationIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ni[i]*phi[i]*ui[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDMolarDensityIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*phi[i]*si[i]*ui[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDInternalEnergyIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ni[i]*phi[i]*si[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDSaturationGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ng[i]*phi[i]*ug[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDMolarDensityGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*phi[i]*sg[i]*ug[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDInternalEnergyGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ng[i]*phi[i]*sg[i];
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDDensityRockKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ur[i]*(1 - phi0[i]);
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDInternalEnergyRockKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*rho_r[i]*(1 - phi0[i]);
+  }
+}
+
+void
+ThreePhaseEnergyModel::DEnergyDCellVolumeKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = phi[i]*(ng[i]*sg[i]*ug[i] + ni[i]*si[i]*ui[i] + nl[i]*sl[i]*ul[i]) + rho_r[i]*ur[i]*(1 - phi0[i]);
+  }
+}
+
+void
+ThreePhaseEnergyModel::EnergyAllKernel(int n, const double* __restrict__ phi, const double* __restrict__ phi0, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ ul, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ ui, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ ug, const double* __restrict__ rho_r, const double* __restrict__ ur, const double* __restrict__ cv, double* __restrict__ result, double* __restrict__ dphi, double* __restrict__ dphi0, double* __restrict__ dsl, double* __restrict__ dnl, double* __restrict__ dul, double* __restrict__ dsi, double* __restrict__ dni, double* __restrict__ dui, double* __restrict__ dsg, double* __restrict__ dng, double* __restrict__ dug, double* __restrict__ drho_r, double* __restrict__ dur, double* __restrict__ dcv) const
+{
+  for (int i=0; i!=n; ++i) {
+    const double cse0 = 1 - phi0[i];
+    const double cse1 = rho_r[i]*ur[i];
+    const double cse2 = ng[i]*ug[i];
+    const double cse3 = ni[i]*ui[i];
+    const double cse4 = nl[i]*ul[i];
+    const double cse5 = cse2*sg[i] + cse3*si[i] + cse4*sl[i];
+    const double cse6 = cse0*cse1 + cse5*phi[i];
+    const double cse7 = cv[i]*phi[i];
+    const double cse8 = cse7*sl[i];
+    const double cse9 = cse7*si[i];
+    const double cse10 = cse7*sg[i];
+    const double cse11 = cse0*cv[i];
+    result[i] = cse6*cv[i];
+    dphi[i] = cse5*cv[i];
+    dphi0[i] = -cse1*cv[i];
+    dsl[i] = cse4*cse7;
+    dnl[i] = cse8*ul[i];
+    dul[i] = cse8*nl[i];
+    dsi[i] = cse3*cse7;
+    dni[i] = cse9*ui[i];
+    dui[i] = cse9*ni[i];
+    dsg[i] = cse2*cse7;
+    dng[i] = cse10*ug[i];
+    dug[i] = cse10*ng[i];
+    drho_r[i] = cse11*ur[i];
+    dur[i] = cse11*rho_r[i];
+    dcv[i] = cse6;
+  }
+}
+
 } //namespace
 } //namespace
 } //namespace
@@ -28,6 +28,12 @@ public:
   virtual bool IsMolarBasis() = 0;
   virtual double InternalEnergy(double temp) = 0;
   virtual double DInternalEnergyDT(double temp) = 0;
+
+  // Internal energy and its derivative in one call.
+  virtual double InternalEnergyAndDerivative(double temp, double* dT) {
+    *dT = DInternalEnergyDT(temp);
+    return InternalEnergy(temp);
+  }
 };
 
 }
@@ -36,7 +36,8 @@ IEMEvaluator::IEMEvaluator(Teuchos::ParameterList& plist, const Teuchos::RCP<IEM
 IEMEvaluator::IEMEvaluator(const IEMEvaluator& other) :
     SecondaryVariableFieldEvaluator(other),
     iem_(other.iem_),
-    temp_key_(other.temp_key_) {}
+    temp_key_(other.temp_key_),
+    partials_(other.partials_) {}
 
 
 Teuchos::RCP<FieldEvaluator>
@@ -57,34 +58,56 @@ void IEMEvaluator::InitializeFromPlist_() {
 
 void IEMEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
         const Teuchos::Ptr<CompositeVector>& result) {
-  Teuchos::RCP<const CompositeVector> temp = S->GetFieldData(temp_key_);
-
-  for (CompositeVector::name_iterator comp=result->begin();
-       comp!=result->end(); ++comp) {
-    const Epetra_MultiVector& temp_v = *temp->ViewComponent(*comp,false);
-    Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-    int ncomp = result->size(*comp, false);
-    for (int i=0; i!=ncomp; ++i) {
-      result_v[0][i] = iem_->InternalEnergy(temp_v[0][i]);
-    }
-  }
+  EvaluateFieldAndPartials_(S, result, partials_.TakeRequest());
 }
 
 
 void IEMEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
         Key wrt_key, const Teuchos::Ptr<CompositeVector>& result) {
   AMANZI_ASSERT(wrt_key == temp_key_);
-  Teuchos::RCP<const CompositeVector> temp = S->GetFieldData(temp_key_);
+  std::vector<Teuchos::RCP<const CompositeVector> > deps(1, S->GetFieldData(temp_key_));
+  partials_.Request();
+  if (!partials_.IsCurrent(deps)) EvaluateFieldAndPartials_(S, Teuchos::null, true);
+  *result = *partials_[0];
+}
+
 
-  for (CompositeVector::name_iterator comp=result->begin();
-       comp!=result->end(); ++comp) {
-    const Epetra_MultiVector& temp_v = *temp->ViewComponent(*comp,false);
-    Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
+void IEMEvaluator::EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+        const Teuchos::Ptr<CompositeVector>& result, bool partials) {
+  std::vector<Teuchos::RCP<const CompositeVector> > deps(1, S->GetFieldData(temp_key_));
+  const CompositeVector& space = result != Teuchos::null ? *result :
+      *S->GetFieldData(my_key_);
+  if (!partials) {
+    for (CompositeVector::name_iterator comp=space.begin();
+         comp!=space.end(); ++comp) {
+      const Epetra_MultiVector& temp_v = *deps[0]->ViewComponent(*comp,false);
+      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
+
+      int ncomp = space.size(*comp, false);
+      for (int i=0; i!=ncomp; ++i) {
+        result_v[0][i] = iem_->InternalEnergy(temp_v[0][i]);
+      }
+    }
+    return;
+  }
 
-    int ncomp = result->size(*comp, false);
-    for (int i=0; i!=ncomp; ++i) {
-      result_v[0][i] = iem_->DInternalEnergyDT(temp_v[0][i]);
+  partials_.Record(deps, 1, space);
+
+  for (CompositeVector::name_iterator comp=space.begin();
+       comp!=space.end(); ++comp) {
+    const Epetra_MultiVector& temp_v = *deps[0]->ViewComponent(*comp,false);
+    Epetra_MultiVector& dT_v = *partials_[0]->ViewComponent(*comp,false);
+
+    int ncomp = space.size(*comp, false);
+    if (result != Teuchos::null) {
+      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
+      for (int i=0; i!=ncomp; ++i) {
+        result_v[0][i] = iem_->InternalEnergyAndDerivative(temp_v[0][i], &dT_v[0][i]);
+      }
+    } else {
+      for (int i=0; i!=ncomp; ++i) {
+        iem_->InternalEnergyAndDerivative(temp_v[0][i], &dT_v[0][i]);
+      }
     }
   }
 }
@@ -11,6 +11,7 @@
 
 #include "Factory.hh"
 #include "iem.hh"
+#include "partials_cache.hh"
 #include "secondary_variable_field_evaluator.hh"
 
 namespace Amanzi {
@@ -38,8 +39,14 @@ class IEMEvaluator : public SecondaryVariableFieldEvaluator {
  protected:
   void InitializeFromPlist_();
 
+  // Internal energy, if result is non-null, and, if partials is true, its
+  // derivative, which is kept for the next derivative request.
+  void EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& result, bool partials);
+
   Key temp_key_;
   Teuchos::RCP<IEM> iem_;
+  PartialsCache partials_;
 
  private:
   static Utils::RegisteredFactory<FieldEvaluator,IEMEvaluator> factory_;
@@ -11,6 +11,7 @@ u = u0 + a(T - T_ref) + b(T - T_ref)^2
 UNITS: MJ/{mol,kg}
 ------------------------------------------------------------------------- */
 
+#include "dual.hh"
 #include "iem_quadratic.hh"
 
 namespace Amanzi {
@@ -21,9 +22,14 @@ IEMQuadratic::IEMQuadratic(Teuchos::ParameterList& plist) :
   InitializeFromPlist_();
 };
 
-double IEMQuadratic::InternalEnergy(double temp) {
-  double dT = temp - T0_;
+template<class T>
+T IEMQuadratic::InternalEnergy_(const T& temp) const {
+  T dT = temp - T0_;
   return u0_ + (ka_ + kb_*dT) * dT;
+}
+
+double IEMQuadratic::InternalEnergy(double temp) {
+  return InternalEnergy_(temp);
 };
 
 double IEMQuadratic::DInternalEnergyDT(double temp) {
@@ -31,6 +37,12 @@ double IEMQuadratic::DInternalEnergyDT(double temp) {
   return ka_ + 2.0*kb_*dT;
 };
 
+double IEMQuadratic::InternalEnergyAndDerivative(double temp, double* dT) {
+  Dual<1> u = InternalEnergy_(Dual<1>::Variable(temp, 0));
+  *dT = u.d(0);
+  return u.value();
+};
+
 void IEMQuadratic::InitializeFromPlist_() {
   if (plist_.isParameter("quadratic u_0 [J/kg]")) {
     u0_ = 1.e-6 * plist_.get<double>("quadratic u_0 [J/kg]");
@@ -36,10 +36,14 @@ public:
 
   double InternalEnergy(double temp);
   double DInternalEnergyDT(double temp);
+  double InternalEnergyAndDerivative(double temp, double* dT);
 
 private:
   virtual void InitializeFromPlist_();
 
+  // internal energy, on double or Dual
+  template<class T> T InternalEnergy_(const T& temp) const;
+
   Teuchos::ParameterList plist_;
 
   double u0_;
@@ -41,6 +41,16 @@ public:
     AMANZI_ASSERT(false);
     return 0.;
   }
+
+  // Thermal conductivity and all four derivatives in one call.
+  virtual double ThermalConductivityAndDerivatives(double porosity, double sat_liq, double sat_ice, double temp,
+          double* d_porosity, double* d_sat_liq, double* d_sat_ice, double* d_temp) {
+    *d_porosity = DThermalConductivity_DPorosity(porosity, sat_liq, sat_ice, temp);
+    *d_sat_liq = DThermalConductivity_DSaturationLiquid(porosity, sat_liq, sat_ice, temp);
+    *d_sat_ice = DThermalConductivity_DSaturationIce(porosity, sat_liq, sat_ice, temp);
+    *d_temp = DThermalConductivity_DTemperature(porosity, sat_liq, sat_ice, temp);
+    return ThermalConductivity(porosity, sat_liq, sat_ice, temp);
+  }
 };
 
 } // namespace
@@ -64,7 +64,8 @@ ThermalConductivityThreePhaseEvaluator::ThermalConductivityThreePhaseEvaluator(
     temp_key_(other.temp_key_),
     sat_key_(other.sat_key_),
     sat2_key_(other.sat2_key_),
-    tcs_(other.tcs_) {}
+    tcs_(other.tcs_),
+    partials_(other.partials_) {}
 
 Teuchos::RCP<FieldEvaluator>
 ThermalConductivityThreePhaseEvaluator::Clone() const {
@@ -75,21 +76,64 @@ ThermalConductivityThreePhaseEvaluator::Clone() const {
 void ThermalConductivityThreePhaseEvaluator::EvaluateField_(
     const Teuchos::Ptr<State>& S,
     const Teuchos::Ptr<CompositeVector>& result) {
+  EvaluateFieldAndPartials_(S, result, partials_.TakeRequest());
+}
+
+
+void ThermalConductivityThreePhaseEvaluator::EvaluateFieldPartialDerivative_(
+    const Teuchos::Ptr<State>& S, Key wrt_key,
+    const Teuchos::Ptr<CompositeVector>& result) {
+  int k = 0;
+  if (wrt_key == poro_key_) {
+    k = 0;
+  } else if (wrt_key == sat_key_) {
+    k = 1;
+  } else if (wrt_key == sat2_key_) {
+    k = 2;
+  } else if (wrt_key == temp_key_) {
+    k = 3;
+  } else {
+    AMANZI_ASSERT(false);
+  }
+
+  partials_.Request();
+  if (!partials_.IsCurrent(Dependencies_(S))) EvaluateFieldAndPartials_(S, Teuchos::null, true);
+  *result = *partials_[k];
+}
+
+
+std::vector<Teuchos::RCP<const CompositeVector> >
+ThermalConductivityThreePhaseEvaluator::Dependencies_(const Teuchos::Ptr<State>& S) {
+  std::vector<Teuchos::RCP<const CompositeVector> > deps;
+  deps.push_back(S->GetFieldData(poro_key_));
+  deps.push_back(S->GetFieldData(sat_key_));
+  deps.push_back(S->GetFieldData(sat2_key_));
+  deps.push_back(S->GetFieldData(temp_key_));
+  return deps;
+}
+
+
+void ThermalConductivityThreePhaseEvaluator::EvaluateFieldAndPartials_(
+    const Teuchos::Ptr<State>& S,
+    const Teuchos::Ptr<CompositeVector>& result, bool partials) {
   // pull out the dependencies
-  Teuchos::RCP<const CompositeVector> poro = S->GetFieldData(poro_key_);
-  Teuchos::RCP<const CompositeVector> temp = S->GetFieldData(temp_key_);
-  Teuchos::RCP<const CompositeVector> sat = S->GetFieldData(sat_key_);
-  Teuchos::RCP<const CompositeVector> sat2 = S->GetFieldData(sat2_key_);
-  Teuchos::RCP<const AmanziMesh::Mesh> mesh = result->Mesh();
-
-  for (CompositeVector::name_iterator comp = result->begin();
-       comp!=result->end(); ++comp) {
+  std::vector<Teuchos::RCP<const CompositeVector> > deps = Dependencies_(S);
+  const CompositeVector& space = result != Teuchos::null ? *result :
+      *S->GetFieldData(my_key_);
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh = space.Mesh();
+  if (partials) partials_.Record(deps, 4, space);
+
+  for (CompositeVector::name_iterator comp = space.begin();
+       comp!=space.end(); ++comp) {
     AMANZI_ASSERT(*comp == "cell");
-    const Epetra_MultiVector& poro_v = *poro->ViewComponent(*comp,false);
-    const Epetra_MultiVector& temp_v = *temp->ViewComponent(*comp,false);
-    const Epetra_MultiVector& sat_v = *sat->ViewComponent(*comp,false);
-    const Epetra_MultiVector& sat2_v = *sat2->ViewComponent(*comp,false);
-    Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
+    const Epetra_MultiVector& poro_v = *deps[0]->ViewComponent(*comp,false);
+    const Epetra_MultiVector& sat_v = *deps[1]->ViewComponent(*comp,false);
+    const Epetra_MultiVector& sat2_v = *deps[2]->ViewComponent(*comp,false);
+    const Epetra_MultiVector& temp_v = *deps[3]->ViewComponent(*comp,false);
+    std::vector<double*> d_v(4, (double*)NULL);
+    for (int k=0; partials && k!=4; ++k) d_v[k] = (*partials_[k]->ViewComponent(*comp,false))[0];
+    Epetra_MultiVector* result_v = result != Teuchos::null ?
+        result->ViewComponent(*comp,false).get() : NULL;
 
     for (std::vector<RegionModelPair>::const_iterator lcv = tcs_.begin();
          lcv != tcs_.end(); ++lcv) {
@@ -102,8 +146,13 @@ void ThermalConductivityThreePhaseEvaluator::EvaluateField_(
         // loop over indices
         for (AmanziMesh::Entity_ID_List::const_iterator id=id_list.begin();
              id!=id_list.end(); ++id) {
-          result_v[0][*id] = lcv->second->ThermalConductivity(poro_v[0][*id],
+          double tc = partials ?
+              lcv->second->ThermalConductivityAndDerivatives(poro_v[0][*id],
+                  sat_v[0][*id], sat2_v[0][*id], temp_v[0][*id],
+                  &d_v[0][*id], &d_v[1][*id], &d_v[2][*id], &d_v[3][*id]) :
+              lcv->second->ThermalConductivity(poro_v[0][*id],
                   sat_v[0][*id], sat2_v[0][*id], temp_v[0][*id]);
+          if (result_v) (*result_v)[0][*id] = tc;
         }
       } else {
         std::stringstream m;
@@ -113,129 +162,10 @@ void ThermalConductivityThreePhaseEvaluator::EvaluateField_(
       }
     }
   }
-  result->Scale(1.e-6); // convert to MJ
-}
-
-
-void ThermalConductivityThreePhaseEvaluator::EvaluateFieldPartialDerivative_(
-    const Teuchos::Ptr<State>& S, Key wrt_key,
-    const Teuchos::Ptr<CompositeVector>& result) {
-  // pull out the dependencies
-  Teuchos::RCP<const CompositeVector> poro = S->GetFieldData(poro_key_);
-  Teuchos::RCP<const CompositeVector> temp = S->GetFieldData(temp_key_);
-  Teuchos::RCP<const CompositeVector> sat = S->GetFieldData(sat_key_);
-  Teuchos::RCP<const CompositeVector> sat2 = S->GetFieldData(sat2_key_);
-  Teuchos::RCP<const AmanziMesh::Mesh> mesh = result->Mesh();
-
-  for (CompositeVector::name_iterator comp = result->begin();
-       comp!=result->end(); ++comp) {
-    AMANZI_ASSERT(*comp == "cell");
-    const Epetra_MultiVector& poro_v = *poro->ViewComponent(*comp,false);
-    const Epetra_MultiVector& temp_v = *temp->ViewComponent(*comp,false);
-    const Epetra_MultiVector& sat_v = *sat->ViewComponent(*comp,false);
-    const Epetra_MultiVector& sat2_v = *sat2->ViewComponent(*comp,false);
-    Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-    if (wrt_key == poro_key_) {
-      for (std::vector<RegionModelPair>::const_iterator lcv = tcs_.begin();
-           lcv != tcs_.end(); ++lcv) {
-        std::string region_name = lcv->first;
-        if (mesh->valid_set_name(region_name, AmanziMesh::CELL)) {
-          // get the indices of the domain.
-          AmanziMesh::Entity_ID_List id_list;
-          mesh->get_set_entities(region_name, AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED, &id_list);
-
-          // loop over indices
-          for (AmanziMesh::Entity_ID_List::const_iterator id=id_list.begin();
-               id!=id_list.end(); ++id) {
-            result_v[0][*id] = lcv->second->DThermalConductivity_DPorosity(poro_v[0][*id],
-                                              sat_v[0][*id], sat2_v[0][*id], temp_v[0][*id]);
-          }
-        } else {
-          std::stringstream m;
-          m << "Thermal conductivity evaluator: unknown region on cells: \"" << region_name << "\"";
-          Errors::Message message(m.str());
-          Exceptions::amanzi_throw(message);
-        }
-      }
-      
-    } else if (wrt_key == sat_key_) {
-      for (std::vector<RegionModelPair>::const_iterator lcv = tcs_.begin();
-           lcv != tcs_.end(); ++lcv) {
-        std::string region_name = lcv->first;
-        if (mesh->valid_set_name(region_name, AmanziMesh::CELL)) {
-          // get the indices of the domain.
-          AmanziMesh::Entity_ID_List id_list;
-          mesh->get_set_entities(region_name, AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED, &id_list);
-
-          // loop over indices
-          for (AmanziMesh::Entity_ID_List::const_iterator id=id_list.begin();
-               id!=id_list.end(); ++id) {
-            result_v[0][*id] = lcv->second->DThermalConductivity_DSaturationLiquid(
-                                    poro_v[0][*id], sat_v[0][*id], sat2_v[0][*id], temp_v[0][*id]);
-          }
-        } else {
-          std::stringstream m;
-          m << "Thermal conductivity evaluator: unknown region on cells: \"" << region_name << "\"";
-          Errors::Message message(m.str());
-          Exceptions::amanzi_throw(message);
-        }
-      }
-
-    } else if (wrt_key == sat2_key_) {
-      for (std::vector<RegionModelPair>::const_iterator lcv = tcs_.begin();
-           lcv != tcs_.end(); ++lcv) {
-        std::string region_name = lcv->first;
-        if (mesh->valid_set_name(region_name, AmanziMesh::CELL)) {
-          // get the indices of the domain.
-          AmanziMesh::Entity_ID_List id_list;
-          mesh->get_set_entities(region_name, AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED, &id_list);
-
-          // loop over indices
-          for (AmanziMesh::Entity_ID_List::const_iterator id=id_list.begin();
-               id!=id_list.end(); ++id) {
-            result_v[0][*id] = lcv->second->DThermalConductivity_DSaturationIce(
-                                    poro_v[0][*id], sat_v[0][*id], sat2_v[0][*id], temp_v[0][*id]);
-          }
-        } else {
-          std::stringstream m;
-          m << "Thermal conductivity evaluator: unknown region on cells: \"" << region_name << "\"";
-          Errors::Message message(m.str());
-          Exceptions::amanzi_throw(message);
-        }
-      }
-
-    } else if (wrt_key == temp_key_) {
-      for (std::vector<RegionModelPair>::const_iterator lcv = tcs_.begin();
-           lcv != tcs_.end(); ++lcv) {
-        std::string region_name = lcv->first;
-        if (mesh->valid_set_name(region_name, AmanziMesh::CELL)) {
-          // get the indices of the domain.
-          AmanziMesh::Entity_ID_List id_list;
-          mesh->get_set_entities(region_name, AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED, &id_list);
-
-          // loop over indices
-          for (AmanziMesh::Entity_ID_List::const_iterator id=id_list.begin();
-               id!=id_list.end(); ++id) {
-            result_v[0][*id] = lcv->second->DThermalConductivity_DTemperature(
-                                    poro_v[0][*id], sat_v[0][*id], sat2_v[0][*id], temp_v[0][*id]);
-          }
-        } else {
-          std::stringstream m;
-          m << "Thermal conductivity evaluator: unknown region on cells: \"" << region_name << "\"";
-          Errors::Message message(m.str());
-          Exceptions::amanzi_throw(message);
-        }
-      }
-      
-    } else {
-      AMANZI_ASSERT(false);
-    }
-  }
-    
-  result->Scale(1.e-6); // convert to MJ
 
-  Epetra_MultiVector& result_v = *result->ViewComponent("cell",false);
+  // convert to MJ
+  if (result != Teuchos::null) result->Scale(1.e-6);
+  for (int k=0; partials && k!=4; ++k) partials_[k]->Scale(1.e-6);
 }
 
 
@@ -10,6 +10,7 @@
 #ifndef AMANZI_ENERGY_RELATIONS_TC_THREEPHASE_EVALUATOR_HH_
 #define AMANZI_ENERGY_RELATIONS_TC_THREEPHASE_EVALUATOR_HH_
 
+#include "partials_cache.hh"
 #include "secondary_variable_field_evaluator.hh"
 #include "thermal_conductivity_threephase.hh"
 
@@ -37,8 +38,15 @@ class ThermalConductivityThreePhaseEvaluator :
           Key wrt_key, const Teuchos::Ptr<CompositeVector>& result);
 
  protected:
-  
+  // Thermal conductivity, if result is non-null, and, if partials is true,
+  // its derivatives with respect to porosity, liquid and ice saturation, and
+  // temperature, which are kept for the next derivative request.
+  void EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& result, bool partials);
+  std::vector<Teuchos::RCP<const CompositeVector> > Dependencies_(const Teuchos::Ptr<State>& S);
+
   std::vector<RegionModelPair> tcs_;
+  PartialsCache partials_;
 
   // Keys for fields
   // dependencies
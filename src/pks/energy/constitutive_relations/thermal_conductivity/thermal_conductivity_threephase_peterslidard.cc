@@ -10,6 +10,7 @@ Linear interpolant of thermal conductivity.
 ------------------------------------------------------------------------- */
 
 #include <cmath>
+#include "dual.hh"
 #include "thermal_conductivity_threephase_peterslidard.hh"
 
 namespace Amanzi {
@@ -20,15 +21,56 @@ ThermalConductivityThreePhasePetersLidard::ThermalConductivityThreePhasePetersLi
   InitializeFromPlist_();
 };
 
-double ThermalConductivityThreePhasePetersLidard::ThermalConductivity(double poro,
-        double sat_liq, double sat_ice, double temp) {
-  double k_dry = (d_*(1-poro)*k_soil_ + k_gas_*poro)/(d_*(1-poro) + poro);
-  double k_sat_u = pow(k_soil_,(1-poro)) * pow(k_liquid_,poro);
-  double k_sat_f = pow(k_soil_,(1-poro)) * pow(k_ice_,poro);
-  double kersten_u = pow(sat_liq + eps_, alpha_u_);
-  double kersten_f = pow(sat_ice + eps_, alpha_f_);
+template<class T>
+T ThermalConductivityThreePhasePetersLidard::ThermalConductivity_(const T& poro,
+        const T& sat_liq, const T& sat_ice) const {
+  using std::pow;
+  T k_dry = (d_*(1-poro)*k_soil_ + k_gas_*poro)/(d_*(1-poro) + poro);
+  T k_soil_pow = pow(k_soil_,(1-poro));
+  T k_sat_u = k_soil_pow * pow(k_liquid_,poro);
+  T k_sat_f = k_soil_pow * pow(k_ice_,poro);
+  T kersten_u = pow(sat_liq + eps_, alpha_u_);
+  T kersten_f = pow(sat_ice + eps_, alpha_f_);
   return kersten_f * k_sat_f + kersten_u * k_sat_u
     + (1.0 - kersten_f - kersten_u) * k_dry;
+}
+
+double ThermalConductivityThreePhasePetersLidard::ThermalConductivity(double poro,
+        double sat_liq, double sat_ice, double temp) {
+  return ThermalConductivity_(poro, sat_liq, sat_ice);
+};
+
+// Derivatives are computed by forward mode automatic differentiation.
+double ThermalConductivityThreePhasePetersLidard::DThermalConductivity_DPorosity(double poro,
+        double sat_liq, double sat_ice, double temp) {
+  return ThermalConductivity_(Dual<1>::Variable(poro, 0), Dual<1>(sat_liq), Dual<1>(sat_ice)).d(0);
+};
+
+double ThermalConductivityThreePhasePetersLidard::DThermalConductivity_DSaturationLiquid(double poro,
+        double sat_liq, double sat_ice, double temp) {
+  return ThermalConductivity_(Dual<1>(poro), Dual<1>::Variable(sat_liq, 0), Dual<1>(sat_ice)).d(0);
+};
+
+double ThermalConductivityThreePhasePetersLidard::DThermalConductivity_DSaturationIce(double poro,
+        double sat_liq, double sat_ice, double temp) {
+  return ThermalConductivity_(Dual<1>(poro), Dual<1>(sat_liq), Dual<1>::Variable(sat_ice, 0)).d(0);
+};
+
+double ThermalConductivityThreePhasePetersLidard::DThermalConductivity_DTemperature(double poro,
+        double sat_liq, double sat_ice, double temp) {
+  return 0.;
+};
+
+double ThermalConductivityThreePhasePetersLidard::ThermalConductivityAndDerivatives(double poro,
+        double sat_liq, double sat_ice, double temp,
+        double* d_poro, double* d_sat_liq, double* d_sat_ice, double* d_temp) {
+  Dual<3> k = ThermalConductivity_(Dual<3>::Variable(poro, 0),
+          Dual<3>::Variable(sat_liq, 1), Dual<3>::Variable(sat_ice, 2));
+  *d_poro = k.d(0);
+  *d_sat_liq = k.d(1);
+  *d_sat_ice = k.d(2);
+  *d_temp = 0.;
+  return k.value();
 };
 
 void ThermalConductivityThreePhasePetersLidard::InitializeFromPlist_() {
@@ -46,10 +46,21 @@ public:
   ThermalConductivityThreePhasePetersLidard(Teuchos::ParameterList& plist);
 
   double ThermalConductivity(double porosity, double sat_liq, double sat_ice, double temp);
+  double DThermalConductivity_DPorosity(double porosity, double sat_liq, double sat_ice, double temp);
+  double DThermalConductivity_DSaturationLiquid(double porosity, double sat_liq, double sat_ice, double temp);
+  double DThermalConductivity_DSaturationIce(double porosity, double sat_liq, double sat_ice, double temp);
+  double DThermalConductivity_DTemperature(double porosity, double sat_liq, double sat_ice, double temp);
+
+  double ThermalConductivityAndDerivatives(double porosity, double sat_liq, double sat_ice, double temp,
+          double* d_porosity, double* d_sat_liq, double* d_sat_ice, double* d_temp);
 
 private:
   void InitializeFromPlist_();
 
+  // the model, on double or Dual; it does not depend upon temperature
+  template<class T>
+  T ThermalConductivity_(const T& porosity, const T& sat_liq, const T& sat_ice) const;
+
   Teuchos::ParameterList plist_;
 
   double eps_;
@@ -64,6 +64,11 @@ Solves an advection-diffusion equation for energy:
       PDE_Diffusion_, the inverse operator.  Typically only adds Jacobian
       terms, as all the rest default to those values from `"diffusion`".
 
+    * `"preconditioner reuse`" ``[preconditioner-reuse-spec]`` **optional**
+      If provided, the assembled preconditioner is reused until the linear
+      iteration count or the nonlinear contraction rate degrades.  See
+      PreconditionerLag.
+
     IF
     
     * `"source term`" ``[bool]`` **false** Is there a source term?
@@ -165,6 +170,7 @@ Solves an advection-diffusion equation for energy:
 namespace Amanzi {
 
 // forward declarations
+class MeshTopology;
 namespace Operators { class Advection; }
 namespace Functions { class BoundaryFunction; }
 
@@ -207,6 +213,8 @@ public:
   // applies preconditioner to u and returns the result in Pu
   virtual int ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu) override;
 
+  virtual bool SupportsJacobianFree() const override { return true; }
+
   // updates the preconditioner
   virtual void UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h) override;
 
@@ -224,6 +232,9 @@ public:
                    Teuchos::RCP<const TreeVector> u,
                    Teuchos::RCP<TreeVector> du) override;
 
+  // -- storage used by operators, for memory reporting
+  virtual void OperatorMemory(std::map<std::string,double>& bytes) const override;
+
  protected:
   // These must be provided by the deriving PK.
   // -- setup the evaluators
@@ -326,6 +337,9 @@ public:
   Key source_key_;
   //  Key mass_source_key_;
   Key ss_flux_key_;
+
+  // face to cell topology of mesh_, from the MeshTopology cache
+  const MeshTopology* topo_;
 };
 
 } // namespace Energy
@@ -58,7 +58,7 @@ void EnergyBase::AddAdvection_(const Teuchos::Ptr<State>& S,
   // but for now we'll leave it there and assume it has been updated. --etc
   //  S->GetFieldEvaluator(flux_key_)->HasFieldChanged(S.ptr(), name_);
   Teuchos::RCP<const CompositeVector> flux = S->GetFieldData(flux_key_);
-  db_->WriteVector(" adv flux", flux.ptr(), true);
+  if (debugging_) db_->WriteVector(" adv flux", flux.ptr(), true);
   matrix_adv_->global_operator()->Init();
   matrix_adv_->Setup(*flux);
   matrix_adv_->SetBCs(bc_adv_, bc_adv_);
@@ -128,8 +128,10 @@ void EnergyBase::AddSources_(const Teuchos::Ptr<State>& S,
 
     if (vo_->os_OK(Teuchos::VERB_EXTREME))
       *vo_->os() << "Adding external source term" << std::endl;
-    db_->WriteVector("  Q_ext", S->GetFieldData(source_key_).ptr(), false);
-    db_->WriteVector("res (src)", g, false);
+    if (debugging_) {
+      db_->WriteVector("  Q_ext", S->GetFieldData(source_key_).ptr(), false);
+      db_->WriteVector("res (src)", g, false);
+    }
   }
 }
 
@@ -159,7 +161,7 @@ void EnergyBase::AddSourcesToPrecon_(const Teuchos::Ptr<State>& S, double h) {
       dsource_dT_nc->Update(-1/eps, *S->GetFieldData(source_key_), 1/eps);
       dsource_dT = dsource_dT_nc;
     }
-    db_->WriteVector("  dQ_ext/dT", dsource_dT.ptr(), false);
+    if (debugging_) db_->WriteVector("  dQ_ext/dT", dsource_dT.ptr(), false);
     preconditioner_acc_->AddAccumulationTerm(*dsource_dT, -1.0, "cell", true);
   }
 }
@@ -23,6 +23,7 @@ Author: Ethan Coon
 
 #include "CompositeVectorFunction.hh"
 #include "CompositeVectorFunctionFactory.hh"
+#include "mesh_topology.hh"
 
 #include "energy_base.hh"
 
@@ -47,7 +48,8 @@ EnergyBase::EnergyBase(Teuchos::ParameterList& FElist,
     coupled_to_surface_via_flux_(false),
     niter_(0),
     flux_exists_(true),
-    implicit_advection_(true) {
+    implicit_advection_(true),
+    topo_(nullptr) {
 
   if (!plist_->isParameter("conserved quantity key suffix"))
     plist_->set("conserved quantity key suffix", "energy");
@@ -75,6 +77,7 @@ EnergyBase::EnergyBase(Teuchos::ParameterList& FElist,
 // -------------------------------------------------------------
 void EnergyBase::Setup(const Teuchos::Ptr<State>& S) {
   PK_PhysicalBDF_Default::Setup(S);
+  topo_ = &MeshTopology::Get(mesh_);
 
   SetupEnergy_(S);
   SetupPhysicalEvaluators_(S);
@@ -404,9 +407,7 @@ void EnergyBase::CommitStep(double t_old, double t_new, const Teuchos::RCP<State
 ****************************************************************** */
 int EnergyBase::BoundaryFaceGetCell(int f) const
 {
-  AmanziMesh::Entity_ID_List cells;
-  mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-  return cells[0];
+  return topo_->face_cells(f)[0];
 }
 
 /* ******************************************************************
@@ -417,8 +418,6 @@ void EnergyBase::ApplyDirichletBCsToBoundaryFace_(const Teuchos::Ptr<CompositeVe
 
   Epetra_MultiVector& temp_bf = *temp->ViewComponent("boundary_face", false);
   const Epetra_MultiVector& temp_c = *temp->ViewComponent("cell", false);
-  const Epetra_Map& vandalay_map = mesh_->exterior_face_map(false);
-  const Epetra_Map& face_map = mesh_->face_map(false);
 
   const std::vector<int>& bc_model = bc_->bc_model();
   const std::vector<double>& bc_value = bc_->bc_value();
@@ -426,11 +425,11 @@ void EnergyBase::ApplyDirichletBCsToBoundaryFace_(const Teuchos::Ptr<CompositeVe
   int nbfaces = temp_bf.MyLength();
 
   for (int bf=0; bf!=nbfaces; ++bf) {
-    AmanziMesh::Entity_ID f = face_map.LID(vandalay_map.GID(bf));
+    AmanziMesh::Entity_ID f = topo_->boundary_face_face(bf);
     if (bc_model[f] == Operators::OPERATOR_BC_DIRICHLET) {
       temp_bf[0][bf] = bc_value[f];
     } else {
-      temp_bf[0][bf] = temp_c[0][BoundaryFaceGetCell(f)];
+      temp_bf[0][bf] = temp_c[0][topo_->boundary_face_cell(bf)];
     }
   }
 }
@@ -833,5 +832,14 @@ EnergyBase::ModifyCorrection(double h, Teuchos::RCP<const TreeVector> res,
   return AmanziSolvers::FnBaseDefs::CORRECTION_NOT_MODIFIED;
 }
 
+// -----------------------------------------------------------------------------
+// Storage used by the forward operator and preconditioner.
+// -----------------------------------------------------------------------------
+void EnergyBase::OperatorMemory(std::map<std::string,double>& bytes) const {
+  PK_PhysicalBDF_Default::OperatorMemory(bytes);
+  if (matrix_ != Teuchos::null)
+    bytes[name_+" operator"] += OperatorBytes_(*matrix_);
+}
+
 } // namespace Energy
 } // namespace Amanzi
@@ -15,6 +15,7 @@ Author: Ethan Coon
 #include "FieldEvaluator.hh"
 #include "energy_base.hh"
 #include "Op.hh"
+#include "timer_tree.hh"
 
 namespace Amanzi {
 namespace Energy {
@@ -28,6 +29,7 @@ namespace Energy {
 // -----------------------------------------------------------------------------
 void EnergyBase::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<TreeVector> u_old,
                        Teuchos::RCP<TreeVector> u_new, Teuchos::RCP<TreeVector> g) {
+  TimerTree::Scope timer(name_, "FunctionalResidual");
   Teuchos::OSTab tab = vo_->getOSTab();
 
   // increment, get timestep
@@ -45,12 +47,14 @@ void EnergyBase::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<Tre
                << " t1 = " << t_new << " h = " << h << std::endl;
 
   // dump u_old, u_new
-  db_->WriteCellInfo(true);
-  std::vector<std::string> vnames;
-  vnames.push_back("T_old"); vnames.push_back("T_new");
-  std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
-  vecs.push_back(S_inter_->GetFieldData(key_).ptr()); vecs.push_back(u.ptr());
-  db_->WriteVectors(vnames, vecs, true);
+  if (debugging_) {
+    db_->WriteCellInfo(true);
+    std::vector<std::string> vnames;
+    vnames.push_back("T_old"); vnames.push_back("T_new");
+    std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+    vecs.push_back(S_inter_->GetFieldData(key_).ptr()); vecs.push_back(u.ptr());
+    db_->WriteVectors(vnames, vecs, true);
+  }
 
   // vnames[0] = "sl"; vnames[1] = "si";
   // vecs[0] = S_next_->GetFieldData("saturation_liquid").ptr();
@@ -71,19 +75,24 @@ void EnergyBase::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<Tre
   // diffusion term, implicit
   ApplyDiffusion_(S_next_.ptr(), res.ptr());
 #if DEBUG_FLAG
-  db_->WriteVector("K",S_next_->GetFieldData(conductivity_key_).ptr(),true);
-  db_->WriteVector("res (diff)", res.ptr(), true);
+  if (debugging_) {
+    db_->WriteVector("K",S_next_->GetFieldData(conductivity_key_).ptr(),true);
+    db_->WriteVector("res (diff)", res.ptr(), true);
+  }
 #endif
 
   // accumulation term
   AddAccumulation_(res.ptr());
 #if DEBUG_FLAG
-  vnames[0] = "e_old";
-  vnames[1] = "e_new";
-  vecs[0] = S_inter_->GetFieldData(energy_key_).ptr();
-  vecs[1] = S_next_->GetFieldData(energy_key_).ptr();
-  db_->WriteVectors(vnames, vecs, true);
-  db_->WriteVector("res (acc)", res.ptr());
+  if (debugging_) {
+    std::vector<std::string> vnames;
+    vnames.push_back("e_old"); vnames.push_back("e_new");
+    std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+    vecs.push_back(S_inter_->GetFieldData(energy_key_).ptr());
+    vecs.push_back(S_next_->GetFieldData(energy_key_).ptr());
+    db_->WriteVectors(vnames, vecs, true);
+    db_->WriteVector("res (acc)", res.ptr());
+  }
 #endif
 
   // advection term
@@ -93,13 +102,13 @@ void EnergyBase::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<Tre
     AddAdvection_(S_inter_.ptr(), res.ptr(), true);
   }
 #if DEBUG_FLAG
-  db_->WriteVector("res (adv)", res.ptr());
+  if (debugging_) db_->WriteVector("res (adv)", res.ptr());
 #endif
 
   // source terms
   AddSources_(S_next_.ptr(), res.ptr());
 #if DEBUG_FLAG
-  db_->WriteVector("res (src)", res.ptr());
+  if (debugging_) db_->WriteVector("res (src)", res.ptr());
 #endif
 
   // Dump residual to state for visual debugging.
@@ -115,7 +124,9 @@ void EnergyBase::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<Tre
   }
 #endif
 
-
+  // the point at which a Jacobian-free correction linearizes
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    jfnk_->SetBasePoint(t_old, t_new, u_old, u_new, *g);
 };
 
 
@@ -123,18 +134,38 @@ void EnergyBase::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<Tre
 // Apply the preconditioner to u and return the result in Pu.
 // -----------------------------------------------------------------------------
 int EnergyBase::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu) {
+  TimerTree::Scope timer(name_, "ApplyPreconditioner");
 #if DEBUG_FLAG
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_HIGH))
     *vo_->os() << "Precon application:" << std::endl;
-  db_->WriteVector("T_res", u->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("T_res", u->Data().ptr(), true);
 #endif
 
+  // u is the nonlinear residual, unless this is a call back from the
+  // Jacobian-free correction's Krylov iteration
+  bool jfnk_active = jfnk_ != Teuchos::null && jfnk_->active();
+  if (precon_lag_ != Teuchos::null && !jfnk_active) {
+    double norm(0.);
+    u->Norm2(&norm);
+    precon_lag_->RecordResidualNorm(S_next_->time(), norm);
+  }
+
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_active) {
+    int ierr = jfnk_->ApplyInverse(u, Pu);
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  JFNK iterations: " << jfnk_->num_itrs() << std::endl;
+    return ierr;
+  }
+
   // apply the preconditioner
   int ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+  if (precon_lag_ != Teuchos::null)
+    precon_lag_->RecordLinearIterations(preconditioner_->num_itrs());
 
 #if DEBUG_FLAG
-  db_->WriteVector("PC*T_res", Pu->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("PC*T_res", Pu->Data().ptr(), true);
 #endif
   
   return (ierr > 0) ? 0 : 1;
@@ -145,11 +176,20 @@ int EnergyBase::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::R
 // Update the preconditioner at time t and u = up
 // -----------------------------------------------------------------------------
 void EnergyBase::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h) {
+  TimerTree::Scope timer(name_, "UpdatePreconditioner");
+
   // VerboseObject stuff.
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_HIGH))
     *vo_->os() << "Precon update at t = " << t << std::endl;
 
+  // keep the current preconditioner if it has not degraded
+  if (precon_lag_ != Teuchos::null && precon_lag_->Reuse(h)) {
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  reusing preconditioner" << std::endl;
+    return;
+  }
+
   // update state with the solution up.
 
   AMANZI_ASSERT(std::abs(S_next_->time() - t) <= 1.e-4*t);
@@ -207,7 +247,8 @@ void EnergyBase::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> u
   auto& acc_c = *acc.ViewComponent("cell", false);
   
 #if DEBUG_FLAG
-  db_->WriteVector("    de_dT", S_next_->GetFieldData(Keys::getDerivKey(energy_key_, key_)).ptr());
+  if (debugging_)
+    db_->WriteVector("    de_dT", S_next_->GetFieldData(Keys::getDerivKey(energy_key_, key_)).ptr());
 #endif
 
   if (coupled_to_subsurface_via_temp_ || coupled_to_subsurface_via_flux_) {
@@ -263,6 +304,8 @@ void EnergyBase::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> u
 // -----------------------------------------------------------------------------
 double EnergyBase::ErrorNorm(Teuchos::RCP<const TreeVector> u,
         Teuchos::RCP<const TreeVector> res) {
+  TimerTree::Scope timer(name_, "ErrorNorm");
+
   // Abs tol based on old conserved quantity -- we know these have been vetted
   // at some level whereas the new quantity is some iterate, and may be
   // anything from negative to overflow.
@@ -370,6 +413,7 @@ double EnergyBase::ErrorNorm(Teuchos::RCP<const TreeVector> u,
   int ierr;
   ierr = MPI_Allreduce(&enorm_val_l, &enorm_val, 1, MPI_DOUBLE, MPI_MAX, comm);
   AMANZI_ASSERT(!ierr);
+
   return enorm_val;
 };
 
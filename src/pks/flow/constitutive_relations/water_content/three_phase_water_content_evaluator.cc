@@ -128,9 +128,7 @@ Teuchos::RCP<const CompositeVector> cv = S->GetFieldData(cv_key_);
     Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
 
     int ncomp = result->size(*comp, false);
-    for (int i=0; i!=ncomp; ++i) {
-      result_v[0][i] = model_->WaterContent(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-    }
+    model_->WaterContentKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], result_v[0]);
   }
 }
 
@@ -139,6 +137,24 @@ void
 ThreePhaseWaterContentEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
         Key wrt_key, const Teuchos::Ptr<CompositeVector>& result)
 {
+  std::vector<Key> wrt_keys(1, wrt_key);
+  std::vector<Teuchos::Ptr<CompositeVector> > dresults(1, result);
+  EvaluateFieldPartialDerivatives_(S, Teuchos::null, wrt_keys, dresults);
+}
+
+
+// Value and partial derivatives in one sweep, so that the dependencies are
+// fetched and read only once.
+void
+ThreePhaseWaterContentEvaluator::EvaluateFieldPartialDerivatives_(const Teuchos::Ptr<State>& S,
+        const Teuchos::Ptr<CompositeVector>& result,
+        const std::vector<Key>& wrt_keys,
+        const std::vector<Teuchos::Ptr<CompositeVector> >& dresults)
+{
+  AMANZI_ASSERT(wrt_keys.size() == dresults.size());
+  if (result == Teuchos::null && wrt_keys.size() == 0) return;
+  const CompositeVector& space = result != Teuchos::null ? *result : *dresults[0];
+
 Teuchos::RCP<const CompositeVector> phi = S->GetFieldData(phi_key_);
 Teuchos::RCP<const CompositeVector> sl = S->GetFieldData(sl_key_);
 Teuchos::RCP<const CompositeVector> nl = S->GetFieldData(nl_key_);
@@ -149,188 +165,142 @@ Teuchos::RCP<const CompositeVector> ng = S->GetFieldData(ng_key_);
 Teuchos::RCP<const CompositeVector> omega = S->GetFieldData(omega_key_);
 Teuchos::RCP<const CompositeVector> cv = S->GetFieldData(cv_key_);
 
-  if (wrt_key == phi_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDPorosity(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
-    }
+  for (CompositeVector::name_iterator comp=space.begin();
+       comp!=space.end(); ++comp) {
+    int ncomp = space.size(*comp, false);
+    if (ncomp == 0) continue;
 
-  } else if (wrt_key == sl_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDSaturationLiquid(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
-    }
+    const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
+    const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
+    const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
+    const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
+    const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
+    const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
+    const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
+    const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
+    const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
 
-  } else if (wrt_key == nl_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDMolarDensityLiquid(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
+    // requested outputs, NULL if not requested
+    double* result_p = result != Teuchos::null ?
+        (*result->ViewComponent(*comp,false))[0] : NULL;
+    double* dphi_p = NULL;
+    double* dsl_p = NULL;
+    double* dnl_p = NULL;
+    double* dsi_p = NULL;
+    double* dni_p = NULL;
+    double* dsg_p = NULL;
+    double* dng_p = NULL;
+    double* domega_p = NULL;
+    double* dcv_p = NULL;
+    for (int k=0; k!=wrt_keys.size(); ++k) {
+      double* dresult_p = (*dresults[k]->ViewComponent(*comp,false))[0];
+      if (wrt_keys[k] == phi_key_) {
+        dphi_p = dresult_p;
+      } else if (wrt_keys[k] == sl_key_) {
+        dsl_p = dresult_p;
+      } else if (wrt_keys[k] == nl_key_) {
+        dnl_p = dresult_p;
+      } else if (wrt_keys[k] == si_key_) {
+        dsi_p = dresult_p;
+      } else if (wrt_keys[k] == ni_key_) {
+        dni_p = dresult_p;
+      } else if (wrt_keys[k] == sg_key_) {
+        dsg_p = dresult_p;
+      } else if (wrt_keys[k] == ng_key_) {
+        dng_p = dresult_p;
+      } else if (wrt_keys[k] == omega_key_) {
+        domega_p = dresult_p;
+      } else if (wrt_keys[k] == cv_key_) {
+        dcv_p = dresult_p;
+      } else {
+        AMANZI_ASSERT(0);
       }
     }
 
-  } else if (wrt_key == si_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDSaturationIce(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
+    if (wrt_keys.size() + (result_p ? 1 : 0) == 1) {
+      // a single output, from its own kernel
+      if (result_p) model_->WaterContentKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], result_p);
+      else if (dphi_p) model_->DWaterContentDPorosityKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dphi_p);
+      else if (dsl_p) model_->DWaterContentDSaturationLiquidKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dsl_p);
+      else if (dnl_p) model_->DWaterContentDMolarDensityLiquidKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dnl_p);
+      else if (dsi_p) model_->DWaterContentDSaturationIceKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dsi_p);
+      else if (dni_p) model_->DWaterContentDMolarDensityIceKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dni_p);
+      else if (dsg_p) model_->DWaterContentDSaturationGasKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dsg_p);
+      else if (dng_p) model_->DWaterContentDMolarDensityGasKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dng_p);
+      else if (domega_p) model_->DWaterContentDMolFracGasKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], domega_p);
+      else if (dcv_p) model_->DWaterContentDCellVolumeKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], dcv_p);
+    } else {
+      // all outputs from one kernel, which shares common subexpressions
+      // between them, with those not requested written to workspace
+      scratch_.resize(10 * ncomp);
+      int nscratch = 0;
+      if (!result_p) result_p = &scratch_[ncomp * nscratch++];
+      if (!dphi_p) dphi_p = &scratch_[ncomp * nscratch++];
+      if (!dsl_p) dsl_p = &scratch_[ncomp * nscratch++];
+      if (!dnl_p) dnl_p = &scratch_[ncomp * nscratch++];
+      if (!dsi_p) dsi_p = &scratch_[ncomp * nscratch++];
+      if (!dni_p) dni_p = &scratch_[ncomp * nscratch++];
+      if (!dsg_p) dsg_p = &scratch_[ncomp * nscratch++];
+      if (!dng_p) dng_p = &scratch_[ncomp * nscratch++];
+      if (!domega_p) domega_p = &scratch_[ncomp * nscratch++];
+      if (!dcv_p) dcv_p = &scratch_[ncomp * nscratch++];
+      model_->WaterContentAllKernel(ncomp, phi_v[0], sl_v[0], nl_v[0], si_v[0], ni_v[0], sg_v[0], ng_v[0], omega_v[0], cv_v[0], result_p, dphi_p, dsl_p, dnl_p, dsi_p, dni_p, dsg_p, dng_p, domega_p, dcv_p);
     }
+  }
+}
 
-  } else if (wrt_key == ni_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDMolarDensityIce(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
-    }
 
-  } else if (wrt_key == sg_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDSaturationGas(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
-    }
+// The chain rule over all dependencies that depend upon wrt_key, with the
+// partial derivatives with respect to all of them computed at once.
+void
+ThreePhaseWaterContentEvaluator::UpdateFieldDerivative_(const Teuchos::Ptr<State>& S,
+        Key wrt_key)
+{
+  Key dmy_key = Keys::getDerivKey(my_key_, wrt_key);
 
-  } else if (wrt_key == ng_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDMolarDensityGas(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
-    }
+  Teuchos::RCP<CompositeVector> dmy;
+  if (S->HasField(dmy_key)) {
+    // Get the field...
+    dmy = S->GetFieldData(dmy_key, my_key_);
+  } else {
+    // or create the field.  Note we have to do extra work that is normally
+    // done by State in initialize.
+    Teuchos::RCP<CompositeVectorSpace> my_fac = S->RequireField(my_key_);
+    Teuchos::RCP<CompositeVectorSpace> new_fac =
+      S->RequireField(dmy_key, my_key_);
+    new_fac->Update(*my_fac);
+    dmy = Teuchos::rcp(new CompositeVector(*my_fac));
+    S->SetData(dmy_key, my_key_, dmy);
+    S->GetField(dmy_key,my_key_)->set_initialized();
+    S->GetField(dmy_key,my_key_)->set_io_vis(false);
+    S->GetField(dmy_key,my_key_)->set_io_checkpoint(false);
+  }
 
-  } else if (wrt_key == omega_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDMolFracGas(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
+  // partial F / partial dep for every dep on the path to wrt_key
+  std::vector<Key> wrt_keys;
+  std::vector<Teuchos::Ptr<CompositeVector> > dresults;
+  for (KeySet::const_iterator dep=dependencies_.begin();
+       dep!=dependencies_.end(); ++dep) {
+    if (wrt_key == *dep || S->GetFieldEvaluator(*dep)->IsDependency(S, wrt_key)) {
+      if (partials_.size() == wrt_keys.size())
+        partials_.push_back(Teuchos::rcp(new CompositeVector(*dmy)));
+      dresults.push_back(partials_[wrt_keys.size()].ptr());
+      wrt_keys.push_back(*dep);
     }
-
-  } else if (wrt_key == cv_key_) {
-    for (CompositeVector::name_iterator comp=result->begin();
-         comp!=result->end(); ++comp) {
-      const Epetra_MultiVector& phi_v = *phi->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sl_v = *sl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& nl_v = *nl->ViewComponent(*comp, false);
-      const Epetra_MultiVector& si_v = *si->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ni_v = *ni->ViewComponent(*comp, false);
-      const Epetra_MultiVector& sg_v = *sg->ViewComponent(*comp, false);
-      const Epetra_MultiVector& ng_v = *ng->ViewComponent(*comp, false);
-      const Epetra_MultiVector& omega_v = *omega->ViewComponent(*comp, false);
-      const Epetra_MultiVector& cv_v = *cv->ViewComponent(*comp, false);
-      Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
-
-      int ncomp = result->size(*comp, false);
-      for (int i=0; i!=ncomp; ++i) {
-        result_v[0][i] = model_->DWaterContentDCellVolume(phi_v[0][i], sl_v[0][i], nl_v[0][i], si_v[0][i], ni_v[0][i], sg_v[0][i], ng_v[0][i], omega_v[0][i], cv_v[0][i]);
-      }
+  }
+  EvaluateFieldPartialDerivatives_(S, Teuchos::null, wrt_keys, dresults);
+
+  dmy->PutScalar(0.);
+  for (int k=0; k!=wrt_keys.size(); ++k) {
+    if (wrt_keys[k] == wrt_key) {
+      // partial F / partial x
+      dmy->Update(1., *dresults[k], 1.);
+    } else {
+      // partial F / partial dep * ddep/dx
+      Teuchos::RCP<const CompositeVector> ddep =
+          S->GetFieldData(Keys::getDerivKey(wrt_keys[k], wrt_key));
+      dmy->Multiply(1., *ddep, *dresults[k], 1.);
     }
-
-  } else {
-    AMANZI_ASSERT(0);
   }
 }
 
@@ -50,6 +50,8 @@ Water content for a three-phase, gas+liquid+ice evaluator.
 #ifndef AMANZI_FLOW_THREE_PHASE_WATER_CONTENT_EVALUATOR_HH_
 #define AMANZI_FLOW_THREE_PHASE_WATER_CONTENT_EVALUATOR_HH_
 
+#include <vector>
+
 #include "Factory.hh"
 #include "secondary_variable_field_evaluator.hh"
 
@@ -74,6 +76,16 @@ class ThreePhaseWaterContentEvaluator : public SecondaryVariableFieldEvaluator {
   virtual void EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
           Key wrt_key, const Teuchos::Ptr<CompositeVector>& result);
 
+  // Evaluates, in one sweep over the cells, the value (if result is not
+  // null) and the partial derivatives with respect to each of wrt_keys.
+  void EvaluateFieldPartialDerivatives_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& result,
+          const std::vector<Key>& wrt_keys,
+          const std::vector<Teuchos::Ptr<CompositeVector> >& dresults);
+
+  // Computes all partial derivatives needed by the chain rule at once.
+  virtual void UpdateFieldDerivative_(const Teuchos::Ptr<State>& S, Key wrt_key);
+
   Teuchos::RCP<ThreePhaseWaterContentModel> get_model() { return model_; }
 
  protected:
@@ -91,6 +103,11 @@ class ThreePhaseWaterContentEvaluator : public SecondaryVariableFieldEvaluator {
 
   Teuchos::RCP<ThreePhaseWaterContentModel> model_;
 
+  // workspace for the partial derivatives, one per dependency
+  std::vector<Teuchos::RCP<CompositeVector> > partials_;
+  // workspace for outputs of the array kernels that were not requested
+  std::vector<double> scratch_;
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,ThreePhaseWaterContentEvaluator> reg_;
 
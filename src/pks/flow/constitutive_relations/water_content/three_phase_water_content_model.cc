@@ -91,6 +91,109 @@ ThreePhaseWaterContentModel::DWaterContentDCellVolume(double phi, double sl, dou
   return phi*(ng*omega*sg + ni*si + nl*sl);
 }
 
+// array kernels
+void
+ThreePhaseWaterContentModel::WaterContentKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*phi[i]*(ng[i]*omega[i]*sg[i] + ni[i]*si[i] + nl[i]*sl[i]);
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDPorosityKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*(ng[i]*omega[i]*sg[i] + ni[i]*si[i] + nl[i]*sl[i]);
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDSaturationLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*nl[i]*phi[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDMolarDensityLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*phi[i]*sl[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDSaturationIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ni[i]*phi[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDMolarDensityIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*phi[i]*si[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDSaturationGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ng[i]*omega[i]*phi[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDMolarDensityGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*omega[i]*phi[i]*sg[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDMolFracGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = cv[i]*ng[i]*phi[i]*sg[i];
+  }
+}
+
+void
+ThreePhaseWaterContentModel::DWaterContentDCellVolumeKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const
+{
+  for (int i=0; i!=n; ++i) {
+    result[i] = phi[i]*(ng[i]*omega[i]*sg[i] + ni[i]*si[i] + nl[i]*sl[i]);
+  }
+}
+
+void
+ThreePhaseWaterContentModel::WaterContentAllKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result, double* __restrict__ dphi, double* __restrict__ dsl, double* __restrict__ dnl, double* __restrict__ dsi, double* __restrict__ dni, double* __restrict__ dsg, double* __restrict__ dng, double* __restrict__ domega, double* __restrict__ dcv) const
+{
+  for (int i=0; i!=n; ++i) {
+    const double cse0 = ng[i]*omega[i];
+    const double cse1 = cse0*sg[i] + ni[i]*si[i] + nl[i]*sl[i];
+    const double cse2 = cse1*cv[i];
+    const double cse3 = cv[i]*phi[i];
+    const double cse4 = cse3*sg[i];
+    result[i] = cse2*phi[i];
+    dphi[i] = cse2;
+    dsl[i] = cse3*nl[i];
+    dnl[i] = cse3*sl[i];
+    dsi[i] = cse3*ni[i];
+    dni[i] = cse3*si[i];
+    dsg[i] = cse0*cse3;
+    dng[i] = cse4*omega[i];
+    domega[i] = cse4*ng[i];
+    dcv[i] = cse1*phi[i];
+  }
+}
+
 } //namespace
 } //namespace
 } //namespace
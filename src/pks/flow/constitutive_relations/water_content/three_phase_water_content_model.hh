@@ -31,6 +31,20 @@ class ThreePhaseWaterContentModel {
   double DWaterContentDMolarDensityGas(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const;
   double DWaterContentDMolFracGas(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const;
   double DWaterContentDCellVolume(double phi, double sl, double nl, double si, double ni, double sg, double ng, double omega, double cv) const;
+
+  // Array kernels over n entries of each argument, free of branches so that
+  // they vectorize.  The outputs may not alias the arguments.
+  void WaterContentKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDPorosityKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDSaturationLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDMolarDensityLiquidKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDSaturationIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDMolarDensityIceKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDSaturationGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDMolarDensityGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDMolFracGasKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void DWaterContentDCellVolumeKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result) const;
+  void WaterContentAllKernel(int n, const double* __restrict__ phi, const double* __restrict__ sl, const double* __restrict__ nl, const double* __restrict__ si, const double* __restrict__ ni, const double* __restrict__ sg, const double* __restrict__ ng, const double* __restrict__ omega, const double* __restrict__ cv, double* __restrict__ result, double* __restrict__ dphi, double* __restrict__ dsl, double* __restrict__ dnl, double* __restrict__ dsi, double* __restrict__ dni, double* __restrict__ dsg, double* __restrict__ dng, double* __restrict__ domega, double* __restrict__ dcv) const;
   
  protected:
   void InitializeFromPlist_(Teuchos::ParameterList& plist);
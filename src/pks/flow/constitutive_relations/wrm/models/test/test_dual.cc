@@ -0,0 +1,196 @@
+#include <cmath>
+#include "UnitTest++.h"
+
+#include "dual.hh"
+#include "wrm_van_genuchten.hh"
+#include "eos_water.hh"
+#include "iem_quadratic.hh"
+#include "thermal_conductivity_threephase_peterslidard.hh"
+
+using namespace Amanzi;
+
+// The hand-written van Genuchten derivatives, used as an oracle for the
+// automatically differentiated ones.  The Burdine derivative previously
+// dropped the factor y from its second term.
+namespace {
+
+double d_k_relative_oracle(double s, double m, double l, double sr, bool mualem) {
+  double se = (s - sr)/(1-sr);
+  double x = std::pow(se, 1.0 / m);
+  if (std::fabs(1.0 - x) < 1.e-10) return 0.0;
+
+  double y = std::pow(1.0 - x, m);
+  double dkdse;
+  if (mualem)
+    dkdse = (1.0 - y) * (l * (1.0 - y) + 2 * x * y / (1.0 - x)) * std::pow(se, l - 1.0);
+  else
+    dkdse = (2 * (1.0 - y) + x * y / (1.0 - x)) * se;
+  return dkdse / (1 - sr);
+}
+
+double d_saturation_oracle(double pc, double m, double n, double alpha, double sr) {
+  return -m*n * std::pow(1.0 + std::pow(alpha*pc, n), -m-1.0)
+      * std::pow(alpha*pc, n-1) * alpha * (1.0 - sr);
+}
+
+}
+
+
+TEST(dual_arithmetic) {
+  Dual<2> x = Dual<2>::Variable(3.0, 0);
+  Dual<2> y = Dual<2>::Variable(0.5, 1);
+
+  Dual<2> f = (x * y + 2.0) / (x - y) - 1.0 / x;
+  double xv = 3.0, yv = 0.5;
+  CHECK_CLOSE((xv*yv + 2.0)/(xv - yv) - 1.0/xv, f.value(), 1.e-14);
+  CHECK_CLOSE((yv*(xv-yv) - (xv*yv + 2.0))/std::pow(xv-yv,2) + 1.0/(xv*xv), f.d(0), 1.e-14);
+  CHECK_CLOSE((xv*(xv-yv) + (xv*yv + 2.0))/std::pow(xv-yv,2), f.d(1), 1.e-14);
+
+  // constants carry no derivatives
+  Dual<2> c(4.0);
+  CHECK_EQUAL(0.0, c.d(0));
+  CHECK_EQUAL(0.0, Constant(x).d(0));
+  CHECK(x > y);
+  CHECK(x < 4.0);
+}
+
+
+TEST(dual_functions) {
+  double xv = 0.7;
+  Dual<1> x = Dual<1>::Variable(xv, 0);
+
+  CHECK_CLOSE(std::exp(xv), exp(x).d(0), 1.e-14);
+  CHECK_CLOSE(1.0/xv, log(x).d(0), 1.e-14);
+  CHECK_CLOSE(0.5/std::sqrt(xv), sqrt(x).d(0), 1.e-14);
+  CHECK_CLOSE(-0.3*std::pow(xv, -1.3), pow(x, -0.3).d(0), 1.e-14);
+  CHECK_CLOSE(std::pow(2.5, xv)*std::log(2.5), pow(2.5, x).d(0), 1.e-14);
+  CHECK_CLOSE(std::pow(xv, xv)*(std::log(xv) + 1.0), pow(x, x).d(0), 1.e-14);
+
+  // power of zero
+  Dual<1> z = Dual<1>::Variable(0.0, 0);
+  CHECK_EQUAL(0.0, pow(z, 2.0).d(0));
+  CHECK_EQUAL(1.0, pow(z, 1.0).d(0));
+}
+
+
+TEST(vanGenuchten_dual) {
+  using namespace Amanzi::Flow;
+
+  double m = 0.4;
+  double alpha = 1.e-4;
+  double sr = 0.1;
+  double l = 0.5;
+
+  for (int mualem=0; mualem!=2; ++mualem) {
+    Teuchos::ParameterList plist;
+    plist.set("Krel function name", std::string(mualem ? "Mualem" : "Burdine"));
+    plist.set("van Genuchten m [-]", m);
+    plist.set("van Genuchten alpha [Pa^-1]", alpha);
+    plist.set("residual saturation [-]", sr);
+    plist.set("Mualem exponent l [-]", l);
+    WRMVanGenuchten vG(plist);
+    double n = mualem ? 1.0 / (1.0 - m) : 2.0 / (1.0 - m);
+
+    for (double s=sr + 0.01; s<1.0; s+=0.01) {
+      double dkr_oracle = d_k_relative_oracle(s, m, l, sr, mualem);
+      CHECK_CLOSE(dkr_oracle, vG.d_k_relative(s), 1.e-10 * std::max(1.0, std::abs(dkr_oracle)));
+
+      double dkr;
+      double kr = vG.k_relativeAndDerivative(s, &dkr);
+      CHECK_CLOSE(vG.k_relative(s), kr, 1.e-15);
+      CHECK_EQUAL(vG.d_k_relative(s), dkr);
+    }
+
+    for (double pc=1.; pc<1.e9; pc*=1.7) {
+      double dsat_oracle = d_saturation_oracle(pc, m, n, alpha, sr);
+      CHECK_CLOSE(dsat_oracle, vG.d_saturation(pc), 1.e-10 * std::abs(dsat_oracle));
+
+      double dsat;
+      double sat = vG.saturationAndDerivative(pc, &dsat);
+      CHECK_CLOSE(vG.saturation(pc), sat, 1.e-15);
+      CHECK_EQUAL(vG.d_saturation(pc), dsat);
+    }
+  }
+}
+
+
+// EOSWater and IEMQuadratic keep their hand-written derivatives, which
+// serve as the oracle.
+TEST(eosWater_dual) {
+  Teuchos::ParameterList plist;
+  Amanzi::Relations::EOSWater eos(plist);
+
+  std::vector<double> params(2);
+  for (double T=260.; T<320.; T+=2.5) {
+    // below atmospheric pressure density is held constant in p
+    for (double p=5.e4; p<5.e6; p*=1.5) {
+      params[0] = T;
+      params[1] = p;
+
+      double dT, dp;
+      double rho = eos.MassDensityAndDerivatives(params, &dT, &dp);
+      CHECK_CLOSE(eos.MassDensity(params), rho, 1.e-15 * rho);
+      CHECK_CLOSE(eos.DMassDensityDT(params), dT, 1.e-12 * std::max(1.0, std::abs(dT)));
+      CHECK_CLOSE(eos.DMassDensityDp(params), dp, 1.e-12 * std::abs(eos.DMassDensityDp(params)));
+    }
+  }
+}
+
+
+TEST(iemQuadratic_dual) {
+  Teuchos::ParameterList plist;
+  plist.set("quadratic u_0 [J/mol]", 76.e3);
+  plist.set("quadratic a [J/mol-K]", -7.5);
+  plist.set("quadratic b [J/mol-K^2]", 0.3);
+  Amanzi::Energy::IEMQuadratic iem(plist);
+
+  for (double T=240.; T<320.; T+=1.5) {
+    double dT;
+    double u = iem.InternalEnergyAndDerivative(T, &dT);
+    CHECK_CLOSE(iem.InternalEnergy(T), u, 1.e-15 * std::abs(u));
+    CHECK_CLOSE(iem.DInternalEnergyDT(T), dT, 1.e-12 * std::abs(dT));
+  }
+}
+
+
+// Peters-Lidard has no hand-written derivatives; check against centered
+// differences.
+TEST(petersLidard_dual) {
+  Teuchos::ParameterList plist;
+  plist.set("unsaturated alpha unfrozen [-]", 0.92);
+  plist.set("unsaturated alpha frozen [-]", 0.27);
+  plist.set("thermal conductivity of soil [W/(m-K)]", 2.0);
+  plist.set("thermal conductivity of ice [W/(m-K)]", 2.2);
+  plist.set("thermal conductivity of liquid [W/(m-K)]", 0.6);
+  plist.set("thermal conductivity of gas [W/(m-K)]", 0.02);
+  Amanzi::Energy::ThermalConductivityThreePhasePetersLidard tc(plist);
+
+  double h = 1.e-6;
+  double T = 270.;
+  for (double poro=0.1; poro<0.8; poro+=0.1) {
+    for (double sl=0.05; sl<0.9; sl+=0.1) {
+      for (double si=0.05; si<0.95-sl; si+=0.1) {
+        double dporo, dsl, dsi, dT;
+        double k = tc.ThermalConductivityAndDerivatives(poro, sl, si, T,
+                &dporo, &dsl, &dsi, &dT);
+        CHECK_CLOSE(tc.ThermalConductivity(poro, sl, si, T), k, 1.e-14 * k);
+
+        double fd_poro = (tc.ThermalConductivity(poro+h, sl, si, T)
+                          - tc.ThermalConductivity(poro-h, sl, si, T)) / (2*h);
+        double fd_sl = (tc.ThermalConductivity(poro, sl+h, si, T)
+                        - tc.ThermalConductivity(poro, sl-h, si, T)) / (2*h);
+        double fd_si = (tc.ThermalConductivity(poro, sl, si+h, T)
+                        - tc.ThermalConductivity(poro, sl, si-h, T)) / (2*h);
+        CHECK_CLOSE(fd_poro, dporo, 1.e-6 * std::max(1.0, std::abs(fd_poro)));
+        CHECK_CLOSE(fd_sl, dsl, 1.e-6 * std::max(1.0, std::abs(fd_sl)));
+        CHECK_CLOSE(fd_si, dsi, 1.e-6 * std::max(1.0, std::abs(fd_si)));
+        CHECK_EQUAL(0.0, dT);
+
+        // the single derivatives agree with the combined call
+        CHECK_CLOSE(dporo, tc.DThermalConductivity_DPorosity(poro, sl, si, T), 1.e-14 * std::max(1.0, std::abs(dporo)));
+        CHECK_CLOSE(dsl, tc.DThermalConductivity_DSaturationLiquid(poro, sl, si, T), 1.e-14 * std::max(1.0, std::abs(dsl)));
+        CHECK_CLOSE(dsi, tc.DThermalConductivity_DSaturationIce(poro, sl, si, T), 1.e-14 * std::max(1.0, std::abs(dsi)));
+      }
+    }
+  }
+}
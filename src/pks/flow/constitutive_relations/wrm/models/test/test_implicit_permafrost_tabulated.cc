@@ -0,0 +1,62 @@
+#include <cmath>
+#include <vector>
+#include "UnitTest++.h"
+
+#include "wrm_van_genuchten.hh"
+#include "wrm_implicit_permafrost_model.hh"
+
+// Compares the tabulated implicit permafrost model against the exact solve,
+// over the partially frozen, unsaturated region.
+TEST(implicitPermafrost_tabulated) {
+  using namespace Amanzi::Flow;
+
+  Teuchos::ParameterList plist;
+  plist.set("van Genuchten m [-]", 0.8);
+  plist.set("van Genuchten alpha [Pa^-1]", 1.5e-4);
+  plist.set("residual saturation [-]", 0.);
+  Teuchos::RCP<WRMVanGenuchten> wrm = Teuchos::rcp(new WRMVanGenuchten(plist));
+
+  Teuchos::ParameterList plist_exact;
+  WRMImplicitPermafrostModel exact(plist_exact);
+  exact.set_WRM(wrm);
+
+  // the table is built when the WRM is set
+  Teuchos::ParameterList plist_tab;
+  plist_tab.set("tabulate", true);
+  WRMImplicitPermafrostModel tab(plist_tab);
+  tab.set_WRM(wrm);
+
+  std::vector<double> pc_liqs, pc_ices;
+  for (double pc_liq=20.; pc_liq<5.e7; pc_liq*=1.31) {
+    for (double pc_ice=20.; pc_ice<5.e7; pc_ice*=1.29) {
+      pc_liqs.push_back(pc_liq);
+      pc_ices.push_back(pc_ice);
+    }
+  }
+
+  // derivative errors are relative to the largest derivative, as in the
+  // table's tolerance
+  double err(0.), derr_liq(0.), derr_ice(0.), dmax_liq(0.), dmax_ice(0.);
+  for (int i=0; i!=pc_liqs.size(); ++i) {
+    double s1[3], s2[3];
+    exact.saturations(pc_liqs[i], pc_ices[i], s1);
+    tab.saturations(pc_liqs[i], pc_ices[i], s2);
+    for (int k=0; k!=3; ++k) err = std::max(err, std::abs(s1[k] - s2[k]));
+
+    exact.dsaturations_dpc_liq(pc_liqs[i], pc_ices[i], s1);
+    tab.dsaturations_dpc_liq(pc_liqs[i], pc_ices[i], s2);
+    derr_liq = std::max(derr_liq, std::abs(s1[2] - s2[2]));
+    dmax_liq = std::max(dmax_liq, std::abs(s1[2]));
+
+    exact.dsaturations_dpc_ice(pc_liqs[i], pc_ices[i], s1);
+    tab.dsaturations_dpc_ice(pc_liqs[i], pc_ices[i], s2);
+    derr_ice = std::max(derr_ice, std::abs(s1[2] - s2[2]));
+    dmax_ice = std::max(dmax_ice, std::abs(s1[2]));
+  }
+  derr_liq /= dmax_liq;
+  derr_ice /= dmax_ice;
+
+  CHECK(err < 1.e-6);
+  CHECK(derr_liq < 1.e-4);
+  CHECK(derr_ice < 1.e-4);
+}
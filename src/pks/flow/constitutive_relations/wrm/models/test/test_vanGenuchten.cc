@@ -12,9 +12,9 @@ TEST(vanGenuchten) {
   double p_atm = 1.0e+5;
 
   Teuchos::ParameterList plist;
-  plist.set("van Genuchten m", m);
-  plist.set("van Genuchten alpha", alpha);
-  plist.set("residual saturation", sr);
+  plist.set("van Genuchten m [-]", m);
+  plist.set("van Genuchten alpha [Pa^-1]", alpha);
+  plist.set("residual saturation [-]", sr);
   plist.set("smoothing interval width [saturation]", 0.0);
   WRMVanGenuchten vG(plist);
 
@@ -59,3 +59,34 @@ TEST(vanGenuchten) {
   CHECK_CLOSE(vG.d_capillaryPressure( vG.saturation(pc) ),
               1.0 / vG.d_saturation(pc), 1.);
 }
+
+
+TEST(vanGenuchten_tabulated) {
+  using namespace Amanzi::Flow;
+
+  Teuchos::ParameterList plist;
+  plist.set("van Genuchten m [-]", 0.5);
+  plist.set("van Genuchten alpha [Pa^-1]", 1.e-4);
+  plist.set("residual saturation [-]", 0.1);
+  WRMVanGenuchten vG(plist);
+
+  Teuchos::ParameterList plist_tab(plist);
+  plist_tab.set("tabulate", true);
+  plist_tab.set("tabulation tolerance [-]", 1.e-10);
+  WRMVanGenuchten vG_tab(plist_tab);
+
+  // saturation over many decades of capillary pressure, including outside
+  // the tabulated range
+  for (double pc=-1.e3; pc<1.e10; pc = pc < 1. ? pc + 100. : pc*1.37) {
+    CHECK_CLOSE(vG.saturation(pc), vG_tab.saturation(pc), 1.e-10);
+    CHECK_CLOSE(vG.d_saturation(pc), vG_tab.d_saturation(pc),
+                1.e-5 * std::abs(vG.d_saturation(pc)) + 1.e-20);
+  }
+
+  // rel perm over saturation
+  for (double s=0.1005; s<=1.0; s+=0.0013) {
+    CHECK_CLOSE(vG.k_relative(s), vG_tab.k_relative(s), 1.e-10);
+    CHECK_CLOSE(vG.d_k_relative(s), vG_tab.d_k_relative(s),
+                1.e-5 * std::abs(vG.d_k_relative(s)) + 1.e-6);
+  }
+}
@@ -6,6 +6,9 @@
   Authors: Ethan Coon (ecoon@lanl.gov)
 */
 
+#include "timer_tree.hh"
+#include "mesh_topology.hh"
+#include "wrm_fused_evaluator.hh"
 #include "rel_perm_evaluator.hh"
 
 namespace Amanzi {
@@ -160,6 +163,7 @@ void RelPermEvaluator::EnsureCompatibility(const Teuchos::Ptr<State>& S) {
 void RelPermEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
         const Teuchos::Ptr<CompositeVector>& result)
 {
+  TimerTree::Scope timer(my_key_, "EvaluateField");
   result->PutScalar(0.);
 
   // Initialize the MeshPartition
@@ -174,10 +178,33 @@ void RelPermEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
       ->ViewComponent("cell",false);
   Epetra_MultiVector& res_c = *result->ViewComponent("cell",false);
 
+  // -- dkr/dsl comes along with krel, and is kept for the derivative, if
+  //    the derivative is being requested.
+  Epetra_MultiVector* dkr_c = NULL;
+  if (partials_.TakeRequest()) {
+    std::vector<Teuchos::RCP<const CompositeVector> > deps(1, S->GetFieldData(sat_key_));
+    partials_.Record(deps, 1, *result);
+    dkr_c = partials_[0]->ViewComponent("cell",false).get();
+  }
+
+  // -- a fused WRM evaluator may have computed both along with saturation
   int ncells = res_c.MyLength();
+  Teuchos::RCP<WRMFusedEvaluator> fused =
+      Teuchos::rcp_dynamic_cast<WRMFusedEvaluator>(S->GetFieldEvaluator(sat_key_));
+  if (fused == Teuchos::null || !fused->CopyRelPerm(sat_c, res_c, dkr_c)) {
+    if (runs_.empty()) runs_ = createPartitionRuns(*wrms_->first, ncells);
+    for (const auto& run : runs_) {
+      if (dkr_c) {
+        wrms_->second[run.index]->k_relativeAndDerivativeArray(run.end - run.begin,
+                &sat_c[0][run.begin], &res_c[0][run.begin], &(*dkr_c)[0][run.begin]);
+      } else {
+        wrms_->second[run.index]->k_relativeArray(run.end - run.begin,
+                &sat_c[0][run.begin], &res_c[0][run.begin]);
+      }
+    }
+  }
   for (unsigned int c=0; c!=ncells; ++c) {
-    int index = (*wrms_->first)[c];
-    res_c[0][c] = std::max(wrms_->second[index]->k_relative(sat_c[0][c]), min_val_);
+    res_c[0][c] = std::max(res_c[0][c], min_val_);
   }
 
   // -- Potentially evaluate the model on boundary faces as well.
@@ -186,31 +213,25 @@ void RelPermEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
                                        ->ViewComponent("boundary_face",false);
     Epetra_MultiVector& res_bf = *result->ViewComponent("boundary_face",false);
 
-    Teuchos::RCP<const AmanziMesh::Mesh> mesh = result->Mesh();
-    const Epetra_Map& vandelay_map = mesh->exterior_face_map(false);
-    const Epetra_Map& face_map = mesh->face_map(false);
-      
+    const MeshTopology& topo = MeshTopology::Get(result->Mesh());
+
     // Evaluate the model to calculate krel.
-    AmanziMesh::Entity_ID_List cells;
     int nbfaces = res_bf.MyLength();
     for (unsigned int bf=0; bf!=nbfaces; ++bf) {
       // given a boundary face, we need the internal cell to choose the right WRM
-      AmanziMesh::Entity_ID f = face_map.LID(vandelay_map.GID(bf));
-      mesh->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      AMANZI_ASSERT(cells.size() == 1);
-        
-      int index = (*wrms_->first)[cells[0]];
+      AmanziMesh::Entity_ID c = topo.boundary_face_cell(bf);
+      int index = (*wrms_->first)[c];
       double krel;
       if (boundary_krel_ == BoundaryRelPerm::HARMONIC_MEAN) {
         double krelb = std::max(wrms_->second[index]->k_relative(sat_bf[0][bf]),min_val_);
-        double kreli = std::max(wrms_->second[index]->k_relative(sat_c[0][cells[0]]), min_val_);
+        double kreli = std::max(wrms_->second[index]->k_relative(sat_c[0][c]), min_val_);
         krel = 1.0 / (1.0/krelb + 1.0/kreli);
       } else if (boundary_krel_ == BoundaryRelPerm::ARITHMETIC_MEAN) {
         double krelb = std::max(wrms_->second[index]->k_relative(sat_bf[0][bf]),min_val_);
-        double kreli = std::max(wrms_->second[index]->k_relative(sat_c[0][cells[0]]), min_val_);
+        double kreli = std::max(wrms_->second[index]->k_relative(sat_c[0][c]), min_val_);
         krel = (krelb + kreli)/2.0;
       } else if (boundary_krel_ == BoundaryRelPerm::INTERIOR_PRESSURE) {
-        krel = wrms_->second[index]->k_relative(sat_c[0][cells[0]]);
+        krel = wrms_->second[index]->k_relative(sat_c[0][c]);
       } else if (boundary_krel_ == BoundaryRelPerm::ONE) {
         krel = 1.;
       } else {
@@ -227,16 +248,12 @@ void RelPermEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
     Epetra_MultiVector& res_bf = *result->ViewComponent("boundary_face",false);
 
     Teuchos::RCP<const AmanziMesh::Mesh> surf_mesh = S->GetMesh(surf_domain_);
-    Teuchos::RCP<const AmanziMesh::Mesh> mesh = result->Mesh();
-    const Epetra_Map& vandelay_map = mesh->exterior_face_map(false);
-    const Epetra_Map& face_map = mesh->face_map(false);
-    
+    const MeshTopology& surf_topo = MeshTopology::Get(surf_mesh, result->Mesh());
+
     unsigned int nsurf_cells = surf_mesh->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
     for (unsigned int sc=0; sc!=nsurf_cells; ++sc) {
       // need to map from surface quantity on cells to subsurface boundary_face quantity
-      AmanziMesh::Entity_ID f = surf_mesh->entity_get_parent(AmanziMesh::CELL, sc);
-      AmanziMesh::Entity_ID bf = vandelay_map.LID(face_map.GID(f));
-
+      AmanziMesh::Entity_ID bf = surf_topo.parent_boundary_face(sc);
       res_bf[0][bf] = std::max(surf_kr[0][sc], min_val_);
     }
   }
@@ -276,6 +293,7 @@ void RelPermEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
 
 void RelPermEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
         Key wrt_key, const Teuchos::Ptr<CompositeVector>& result) {
+  TimerTree::Scope timer(my_key_, "EvaluateFieldPartialDerivative");
 
   // Initialize the MeshPartition
   if (!wrms_->first->initialized()) {
@@ -293,11 +311,21 @@ void RelPermEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>
     Epetra_MultiVector& res_c = *result->ViewComponent("cell",false);
 
     int ncells = res_c.MyLength();
-    for (unsigned int c=0; c!=ncells; ++c) {
-      int index = (*wrms_->first)[c];
-      res_c[0][c] = wrms_->second[index]->d_k_relative(sat_c[0][c]);
-      AMANZI_ASSERT(res_c[0][c] >= 0.);
+    std::vector<Teuchos::RCP<const CompositeVector> > deps(1, S->GetFieldData(sat_key_));
+    partials_.Request();
+    if (partials_.IsCurrent(deps)) {
+      // computed along with krel
+      res_c = *partials_[0]->ViewComponent("cell",false);
+    } else {
+      if (runs_.empty()) runs_ = createPartitionRuns(*wrms_->first, ncells);
+      for (const auto& run : runs_) {
+        wrms_->second[run.index]->d_k_relativeArray(run.end - run.begin,
+                &sat_c[0][run.begin], &res_c[0][run.begin]);
+      }
     }
+#ifdef ENABLE_DBC
+    for (unsigned int c=0; c!=ncells; ++c) AMANZI_ASSERT(res_c[0][c] >= 0.);
+#endif
 
     // -- Potentially evaluate the model on boundary faces as well.
     if (result->HasComponent("boundary_face")) {
@@ -353,15 +381,12 @@ void RelPermEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>
       Epetra_MultiVector& res_bf = *result->ViewComponent("boundary_face",false);
 
       Teuchos::RCP<const AmanziMesh::Mesh> surf_mesh = S->GetMesh(surf_domain_);
-      Teuchos::RCP<const AmanziMesh::Mesh> mesh = result->Mesh();
-      const Epetra_Map& vandelay_map = mesh->exterior_face_map(false);
-      const Epetra_Map& face_map = mesh->face_map(false);
-    
+      const MeshTopology& surf_topo = MeshTopology::Get(surf_mesh, result->Mesh());
+
       unsigned int nsurf_cells = surf_mesh->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
       for (unsigned int sc=0; sc!=nsurf_cells; ++sc) {
         // need to map from surface quantity on cells to subsurface boundary_face quantity
-        AmanziMesh::Entity_ID f = surf_mesh->entity_get_parent(AmanziMesh::CELL, sc);
-        AmanziMesh::Entity_ID bf = vandelay_map.LID(face_map.GID(f));
+        AmanziMesh::Entity_ID bf = surf_topo.parent_boundary_face(sc);
 
         //        res_bf[0][bf] = std::max(surf_kr[0][sc], min_val_);
         res_bf[0][bf] = 0.;
@@ -460,6 +485,34 @@ void RelPermEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>
       }
     }
 
+  } else if (wrt_key == surf_rel_perm_key_) {
+    // Rel perm on the boundary faces under the surface is the surface rel
+    // perm, so the derivative is one on those faces, where the cutoff is not
+    // active, scaled as the value is.
+    result->PutScalar(0.);
+    if (!result->HasComponent("boundary_face")) return;
+    Epetra_MultiVector& res_bf = *result->ViewComponent("boundary_face",false);
+
+    const Epetra_MultiVector& surf_kr = *S->GetFieldData(surf_rel_perm_key_)
+        ->ViewComponent("cell",false);
+    const double* dens_bf = NULL;
+    const double* visc_bf = NULL;
+    if (is_dens_visc_) {
+      dens_bf = (*S->GetFieldData(dens_key_)->ViewComponent("boundary_face",false))[0];
+      visc_bf = (*S->GetFieldData(visc_key_)->ViewComponent("boundary_face",false))[0];
+    }
+
+    Teuchos::RCP<const AmanziMesh::Mesh> surf_mesh = S->GetMesh(surf_domain_);
+    const MeshTopology& surf_topo = MeshTopology::Get(surf_mesh, result->Mesh());
+
+    unsigned int nsurf_cells = surf_mesh->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+    for (unsigned int sc=0; sc!=nsurf_cells; ++sc) {
+      if (surf_kr[0][sc] < min_val_) continue;
+      AmanziMesh::Entity_ID bf = surf_topo.parent_boundary_face(sc);
+      res_bf[0][bf] = 1. / perm_scale_;
+      if (is_dens_visc_) res_bf[0][bf] *= dens_bf[bf] / visc_bf[bf];
+    }
+
   } else {
     AMANZI_ASSERT(0);
   }
@@ -14,6 +14,9 @@ relative permeability, typically as a function of liquid saturation.
 
 Most of the parameters are provided to the WRM model, and not the evaluator.
 
+If saturation is evaluated by a WRMFusedEvaluator, rel perm on cells is
+copied from the values it computed along with saturation.
+
 * `"use density on viscosity in rel perm`" ``[bool]`` **true** Include 
 
 * `"boundary rel perm strategy`" ``[string]`` **boundary pressure** Controls
@@ -52,6 +55,7 @@ Keys:
 
 #include "wrm.hh"
 #include "wrm_partition.hh"
+#include "partials_cache.hh"
 #include "secondary_variable_field_evaluator.hh"
 #include "Factory.hh"
 
@@ -66,9 +70,6 @@ enum class BoundaryRelPerm {
   ONE,
   SURF_REL_PERM
 };
-  
-  
-
 
 class RelPermEvaluator : public SecondaryVariableFieldEvaluator {
 
@@ -99,6 +100,7 @@ class RelPermEvaluator : public SecondaryVariableFieldEvaluator {
   void InitializeFromPlist_();
 
   Teuchos::RCP<WRMPartition> wrms_;
+  std::vector<PartitionRun> runs_;
   Key sat_key_;
   Key dens_key_;
   Key visc_key_;
@@ -111,6 +113,9 @@ class RelPermEvaluator : public SecondaryVariableFieldEvaluator {
   double perm_scale_;
   double min_val_;
 
+  // dkr/dsl on cells, computed along with krel
+  PartialsCache partials_;
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,RelPermEvaluator> factory_;
 };
@@ -35,6 +35,42 @@ public:
   virtual double d_capillaryPressure(double saturation) = 0;
   virtual double residualSaturation() = 0;
 
+  // Array versions, evaluating n entries at once.  Evaluators call these on
+  // runs of cells sharing a WRM, so models that override them with tight,
+  // non-virtual loops avoid a virtual call per cell.
+  virtual void k_relativeArray(int n, const double* sat, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = k_relative(sat[i]);
+  }
+  virtual void d_k_relativeArray(int n, const double* sat, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = d_k_relative(sat[i]);
+  }
+  virtual void saturationArray(int n, const double* pc, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = saturation(pc[i]);
+  }
+  virtual void d_saturationArray(int n, const double* pc, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = d_saturation(pc[i]);
+  }
+
+  // Value and derivative in one call.  Models that differentiate their
+  // curves automatically override these to share the transcendental
+  // evaluations between the two.
+  virtual double k_relativeAndDerivative(double saturation, double* d_kr) {
+    *d_kr = d_k_relative(saturation);
+    return k_relative(saturation);
+  }
+  virtual double saturationAndDerivative(double pc, double* d_sat) {
+    *d_sat = d_saturation(pc);
+    return saturation(pc);
+  }
+  virtual void k_relativeAndDerivativeArray(int n, const double* sat,
+          double* result, double* d_result) {
+    for (int i=0; i!=n; ++i) result[i] = k_relativeAndDerivative(sat[i], &d_result[i]);
+  }
+  virtual void saturationAndDerivativeArray(int n, const double* pc,
+          double* result, double* d_result) {
+    for (int i=0; i!=n; ++i) result[i] = saturationAndDerivative(pc[i], &d_result[i]);
+  }
+
 };
 
 typedef double(WRM::*KRelFn)(double pc);
@@ -7,6 +7,8 @@
 */
 
 
+#include "timer_tree.hh"
+#include "mesh_topology.hh"
 #include "wrm_evaluator.hh"
 #include "wrm_factory.hh"
 
@@ -35,7 +37,8 @@ WRMEvaluator::WRMEvaluator(const WRMEvaluator& other) :
     SecondaryVariablesFieldEvaluator(other),
     calc_other_sat_(other.calc_other_sat_),
     cap_pres_key_(other.cap_pres_key_),
-    wrms_(other.wrms_) {}
+    wrms_(other.wrms_),
+    partials_(other.partials_) {}
 
 
 Teuchos::RCP<FieldEvaluator> WRMEvaluator::Clone() const {
@@ -75,46 +78,8 @@ void WRMEvaluator::InitializeFromPlist_() {
 
 void WRMEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
         const std::vector<Teuchos::Ptr<CompositeVector> >& results) {
-  // Initialize the MeshPartition
-  if (!wrms_->first->initialized()) {
-    wrms_->first->Initialize(results[0]->Mesh(), -1);
-    wrms_->first->Verify();
-  }
-
-  Epetra_MultiVector& sat_c = *results[0]->ViewComponent("cell",false);
-  const Epetra_MultiVector& pres_c = *S->GetFieldData(cap_pres_key_)
-      ->ViewComponent("cell",false);
-
-  // calculate cell values
-  AmanziMesh::Entity_ID ncells = sat_c.MyLength();
-  for (AmanziMesh::Entity_ID c=0; c!=ncells; ++c) {
-    sat_c[0][c] = wrms_->second[(*wrms_->first)[c]]->saturation(pres_c[0][c]);
-  }
-
-  // Potentially do face values as well.
-  if (results[0]->HasComponent("boundary_face")) {
-    Epetra_MultiVector& sat_bf = *results[0]->ViewComponent("boundary_face",false);
-    const Epetra_MultiVector& pres_bf = *S->GetFieldData(cap_pres_key_)
-        ->ViewComponent("boundary_face",false);
-
-    // Need to get boundary face's inner cell to specify the WRM.
-    Teuchos::RCP<const AmanziMesh::Mesh> mesh = results[0]->Mesh();
-    const Epetra_Map& vandelay_map = mesh->exterior_face_map(false);
-    const Epetra_Map& face_map = mesh->face_map(false);
-    AmanziMesh::Entity_ID_List cells;
-
-    // calculate boundary face values
-    int nbfaces = sat_bf.MyLength();
-    for (int bf=0; bf!=nbfaces; ++bf) {
-      // given a boundary face, we need the internal cell to choose the right WRM
-      AmanziMesh::Entity_ID f = face_map.LID(vandelay_map.GID(bf));
-      mesh->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      AMANZI_ASSERT(cells.size() == 1);
-
-      int index = (*wrms_->first)[cells[0]];
-      sat_bf[0][bf] = wrms_->second[index]->saturation(pres_bf[0][bf]);
-    }
-  }
+  TimerTree::Scope timer(my_keys_[0], "EvaluateField");
+  EvaluateFieldAndPartials_(S, results[0], partials_.TakeRequest());
 
   // If needed, also do gas saturation
   if (calc_other_sat_) {
@@ -140,48 +105,13 @@ void WRMEvaluator::EvaluateField_(const Teuchos::Ptr<State>& S,
 
 void WRMEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
         Key wrt_key, const std::vector<Teuchos::Ptr<CompositeVector> > & results) {
-  // Initialize the MeshPartition
-  if (!wrms_->first->initialized()) {
-    wrms_->first->Initialize(results[0]->Mesh(), -1);
-    wrms_->first->Verify();
-  }
-
+  TimerTree::Scope timer(my_keys_[0], "EvaluateFieldPartialDerivative");
   AMANZI_ASSERT(wrt_key == cap_pres_key_);
 
-  Epetra_MultiVector& sat_c = *results[0]->ViewComponent("cell",false);
-  const Epetra_MultiVector& pres_c = *S->GetFieldData(cap_pres_key_)
-      ->ViewComponent("cell",false);
-
-  // calculate cell values
-  AmanziMesh::Entity_ID ncells = sat_c.MyLength();
-  for (AmanziMesh::Entity_ID c=0; c!=ncells; ++c) {
-    sat_c[0][c] = wrms_->second[(*wrms_->first)[c]]->d_saturation(pres_c[0][c]);
-  }
-
-  // Potentially do face values as well.
-  if (results[0]->HasComponent("boundary_face")) {
-    Epetra_MultiVector& sat_bf = *results[0]->ViewComponent("boundary_face",false);
-    const Epetra_MultiVector& pres_bf = *S->GetFieldData(cap_pres_key_)
-        ->ViewComponent("boundary_face",false);
-
-    // Need to get boundary face's inner cell to specify the WRM.
-    Teuchos::RCP<const AmanziMesh::Mesh> mesh = results[0]->Mesh();
-    const Epetra_Map& vandelay_map = mesh->exterior_face_map(false);
-    const Epetra_Map& face_map = mesh->face_map(false);
-    AmanziMesh::Entity_ID_List cells;
-
-    // calculate boundary face values
-    int nbfaces = sat_bf.MyLength();
-    for (int bf=0; bf!=nbfaces; ++bf) {
-      // given a boundary face, we need the internal cell to choose the right WRM
-      AmanziMesh::Entity_ID f = face_map.LID(vandelay_map.GID(bf));
-      mesh->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      AMANZI_ASSERT(cells.size() == 1);
-
-      int index = (*wrms_->first)[cells[0]];
-      sat_bf[0][bf] = wrms_->second[index]->d_saturation(pres_bf[0][bf]);
-    }
-  }
+  std::vector<Teuchos::RCP<const CompositeVector> > deps(1, S->GetFieldData(cap_pres_key_));
+  partials_.Request();
+  if (!partials_.IsCurrent(deps)) EvaluateFieldAndPartials_(S, Teuchos::null, true);
+  *results[0] = *partials_[0];
 
   // If needed, also do gas saturation
   if (calc_other_sat_) {
@@ -205,5 +135,66 @@ void WRMEvaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
 }
 
 
+void WRMEvaluator::EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+        const Teuchos::Ptr<CompositeVector>& sat, bool partials) {
+  std::vector<Teuchos::RCP<const CompositeVector> > deps(1, S->GetFieldData(cap_pres_key_));
+  const CompositeVector& space = sat != Teuchos::null ? *sat :
+      *S->GetFieldData(my_keys_[0]);
+  if (partials) partials_.Record(deps, 1, space);
+
+  // Initialize the MeshPartition
+  if (!wrms_->first->initialized()) {
+    wrms_->first->Initialize(space.Mesh(), -1);
+    wrms_->first->Verify();
+  }
+
+  // the value is computed into the workspace if it is not wanted
+  if (sat == Teuchos::null) {
+    if (sat_work_ == Teuchos::null) sat_work_ = Teuchos::rcp(new CompositeVector(space));
+  }
+  CompositeVector& sat_space = sat != Teuchos::null ? *sat : *sat_work_;
+
+  Epetra_MultiVector& sat_c = *sat_space.ViewComponent("cell",false);
+  Epetra_MultiVector* dsat_c = partials ? partials_[0]->ViewComponent("cell",false).get() : NULL;
+  const Epetra_MultiVector& pres_c = *deps[0]->ViewComponent("cell",false);
+
+  // calculate cell values, one call per run of cells sharing a WRM
+  AmanziMesh::Entity_ID ncells = sat_c.MyLength();
+  if (runs_.empty()) runs_ = createPartitionRuns(*wrms_->first, ncells);
+  for (const auto& run : runs_) EvaluateRun_(run, pres_c, sat_c, dsat_c);
+
+  // Potentially do face values as well.
+  if (space.HasComponent("boundary_face")) {
+    Epetra_MultiVector& sat_bf = *sat_space.ViewComponent("boundary_face",false);
+    const Epetra_MultiVector& pres_bf = *deps[0]->ViewComponent("boundary_face",false);
+    double* dsat_bf = partials ?
+        (*partials_[0]->ViewComponent("boundary_face",false))[0] : NULL;
+
+    // Need to get boundary face's inner cell to specify the WRM.
+    const MeshTopology& topo = MeshTopology::Get(space.Mesh());
+
+    // calculate boundary face values
+    int nbfaces = sat_bf.MyLength();
+    for (int bf=0; bf!=nbfaces; ++bf) {
+      WRM& wrm = *wrms_->second[(*wrms_->first)[topo.boundary_face_cell(bf)]];
+      sat_bf[0][bf] = dsat_bf ? wrm.saturationAndDerivative(pres_bf[0][bf], &dsat_bf[bf])
+          : wrm.saturation(pres_bf[0][bf]);
+    }
+  }
+}
+
+
+void WRMEvaluator::EvaluateRun_(const PartitionRun& run, const Epetra_MultiVector& pc_c,
+        Epetra_MultiVector& sat_c, Epetra_MultiVector* dsat_c) {
+  int n = run.end - run.begin;
+  if (dsat_c) {
+    wrms_->second[run.index]->saturationAndDerivativeArray(n, &pc_c[0][run.begin],
+            &sat_c[0][run.begin], &(*dsat_c)[0][run.begin]);
+  } else {
+    wrms_->second[run.index]->saturationArray(n, &pc_c[0][run.begin], &sat_c[0][run.begin]);
+  }
+}
+
+
 } //namespace
 } //namespace
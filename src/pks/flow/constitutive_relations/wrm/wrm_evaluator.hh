@@ -29,6 +29,7 @@ Evaluates a set of WRMs on a partition of the mesh.
 
 #include "wrm_partition.hh"
 #include "wrm.hh"
+#include "partials_cache.hh"
 #include "secondary_variables_field_evaluator.hh"
 #include "Factory.hh"
 
@@ -58,11 +59,26 @@ class WRMEvaluator : public SecondaryVariablesFieldEvaluator {
   virtual void EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
           Key wrt_key, const std::vector<Teuchos::Ptr<CompositeVector> > & results);
 
+  // Liquid saturation, if sat is non-null, and, if partials is true, its
+  // derivative with respect to capillary pressure, which is kept for the
+  // next derivative request.
+  void EvaluateFieldAndPartials_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& sat, bool partials);
+
+  // Liquid saturation on the cells of one run sharing a WRM, and its
+  // derivative if dsat_c is non-null.
+  virtual void EvaluateRun_(const PartitionRun& run, const Epetra_MultiVector& pc_c,
+          Epetra_MultiVector& sat_c, Epetra_MultiVector* dsat_c);
+
  protected:
   Teuchos::RCP<WRMPartition> wrms_;
+  std::vector<PartitionRun> runs_;
   bool calc_other_sat_;
   Key cap_pres_key_;
 
+  PartialsCache partials_;
+  Teuchos::RCP<CompositeVector> sat_work_;
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,WRMEvaluator> factory_;
 
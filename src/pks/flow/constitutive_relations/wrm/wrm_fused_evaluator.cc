@@ -0,0 +1,72 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/*
+  Saturations ( pc ), and rel perm ( sat ) for the RelPermEvaluator, in one
+  pass.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+#include <algorithm>
+
+#include "wrm_fused_evaluator.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+WRMFusedEvaluator::WRMFusedEvaluator(Teuchos::ParameterList& plist) :
+    WRMEvaluator(plist),
+    have_dkr_(false) {}
+
+// Copies start without rel perm, as they may be evaluated in another State.
+WRMFusedEvaluator::WRMFusedEvaluator(const WRMFusedEvaluator& other) :
+    WRMEvaluator(other),
+    have_dkr_(false) {}
+
+Teuchos::RCP<FieldEvaluator> WRMFusedEvaluator::Clone() const {
+  return Teuchos::rcp(new WRMFusedEvaluator(*this));
+}
+
+
+bool WRMFusedEvaluator::CopyRelPerm(const Epetra_MultiVector& sat_c,
+        Epetra_MultiVector& kr_c, Epetra_MultiVector* dkr_c) const {
+  if (sat_c_ == Teuchos::null || sat_c_->MyLength() != sat_c.MyLength()) return false;
+  if (dkr_c && !have_dkr_) return false;
+
+  int ncells = sat_c.MyLength();
+  const double* sat0 = (*sat_c_)[0];
+  for (int c=0; c!=ncells; ++c) {
+    if (sat0[c] != sat_c[0][c]) return false;
+  }
+
+  std::copy((*kr_c_)[0], (*kr_c_)[0] + ncells, kr_c[0]);
+  if (dkr_c) std::copy((*dkr_c_)[0], (*dkr_c_)[0] + ncells, (*dkr_c)[0]);
+  return true;
+}
+
+
+void WRMFusedEvaluator::EvaluateRun_(const PartitionRun& run,
+        const Epetra_MultiVector& pc_c, Epetra_MultiVector& sat_c,
+        Epetra_MultiVector* dsat_c) {
+  if (sat_c_ == Teuchos::null) {
+    sat_c_ = Teuchos::rcp(new Epetra_MultiVector(sat_c.Map(), 1));
+    kr_c_ = Teuchos::rcp(new Epetra_MultiVector(sat_c.Map(), 1));
+    dkr_c_ = Teuchos::rcp(new Epetra_MultiVector(sat_c.Map(), 1));
+  }
+
+  // saturation, and then rel perm while the saturation is still in cache
+  WRMEvaluator::EvaluateRun_(run, pc_c, sat_c, dsat_c);
+  int n = run.end - run.begin;
+  std::copy(&sat_c[0][run.begin], &sat_c[0][run.end], &(*sat_c_)[0][run.begin]);
+  if (dsat_c) {
+    wrms_->second[run.index]->k_relativeAndDerivativeArray(n, &sat_c[0][run.begin],
+            &(*kr_c_)[0][run.begin], &(*dkr_c_)[0][run.begin]);
+  } else {
+    wrms_->second[run.index]->k_relativeArray(n, &sat_c[0][run.begin],
+            &(*kr_c_)[0][run.begin]);
+  }
+  have_dkr_ = dsat_c != NULL;
+}
+
+} //namespace
+} //namespace
@@ -0,0 +1,75 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! WRMFusedEvaluator evaluates saturations, and relative permeability for the RelPermEvaluator, in one pass.
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+Evaluates liquid and gas saturation exactly as WRMEvaluator does, and, in the
+same pass over each run of cells sharing a WRM, the unscaled relative
+permeability, while that saturation is still in cache.  The derivative of rel
+perm with respect to saturation is computed too, when the derivative of
+saturation is.  The rel perm results are kept here, not in
+State: the RelPermEvaluator of the same domain still owns rel perm, still
+depends upon saturation, density, and viscosity, and copies the cell values
+from this evaluator instead of calling the WRMs again.  Keys and dependencies
+are the same as with the separate evaluators.
+
+The RelPermEvaluator uses the kept values only if the saturation it is given
+is the one they were computed from, and otherwise calls the WRMs itself.
+
+This is typically not set directly, but instead by setting `"fused water
+retention evaluator`" in the Richards PK.  Options are those of WRMEvaluator.
+
+*/
+
+#ifndef AMANZI_FLOW_RELATIONS_WRM_FUSED_EVALUATOR_
+#define AMANZI_FLOW_RELATIONS_WRM_FUSED_EVALUATOR_
+
+#include "wrm_evaluator.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+class WRMFusedEvaluator : public WRMEvaluator {
+
+ public:
+  explicit
+  WRMFusedEvaluator(Teuchos::ParameterList& plist);
+  WRMFusedEvaluator(const WRMFusedEvaluator& other);
+
+  virtual Teuchos::RCP<FieldEvaluator> Clone() const;
+
+  // Copies the unscaled rel perm on cells, and its derivative with respect
+  // to saturation if dkr_c is non-null, if they were computed at the liquid
+  // saturation sat_c.  Returns false, copying nothing, otherwise.
+  bool CopyRelPerm(const Epetra_MultiVector& sat_c, Epetra_MultiVector& kr_c,
+                   Epetra_MultiVector* dkr_c) const;
+
+ protected:
+  // Saturation as in WRMEvaluator, then rel perm from it.
+  virtual void EvaluateRun_(const PartitionRun& run, const Epetra_MultiVector& pc_c,
+          Epetra_MultiVector& sat_c, Epetra_MultiVector* dsat_c);
+
+ protected:
+  // saturation on cells, and rel perm and, if have_dkr_, dkr/dsl computed
+  // from it, along with dsat/dpc
+  Teuchos::RCP<Epetra_MultiVector> sat_c_;
+  Teuchos::RCP<Epetra_MultiVector> kr_c_;
+  Teuchos::RCP<Epetra_MultiVector> dkr_c_;
+  bool have_dkr_;
+
+ private:
+  static Utils::RegisteredFactory<FieldEvaluator,WRMFusedEvaluator> factory_;
+
+};
+
+} //namespace
+} //namespace
+
+#endif
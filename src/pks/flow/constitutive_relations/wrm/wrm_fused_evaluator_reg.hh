@@ -0,0 +1,10 @@
+#include "wrm_fused_evaluator.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+// registry of method
+Utils::RegisteredFactory<FieldEvaluator,WRMFusedEvaluator> WRMFusedEvaluator::factory_("WRM fused");
+
+} //namespace
+} //namespace
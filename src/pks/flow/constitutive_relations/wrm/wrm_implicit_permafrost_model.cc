@@ -21,6 +21,13 @@ WRMImplicitPermafrostModel::WRMImplicitPermafrostModel(Teuchos::ParameterList& p
   max_it_ = plist_.get<int>("max iterations", 100);
   deriv_regularization_ = plist_.get<double>("minimum dsi_dpressure magnitude", 1.e-10);
   solver_ = plist_.get<std::string>("solver algorithm [bisection/toms]", "bisection");
+  tabulate_ = plist_.get<bool>("tabulate", false);
+}
+
+
+void WRMImplicitPermafrostModel::set_WRM(const Teuchos::RCP<WRM>& wrm) {
+  WRMPermafrostModel::set_WRM(wrm);
+  if (tabulate_) InitializeTable_();
 }
 
 // Above freezing calculation methods:
@@ -148,6 +155,9 @@ bool WRMImplicitPermafrostModel::dsats_dpc_ice_frozen_unsaturated_(double pc_liq
 // -- si calculation, partially frozen, unsaturated
 double WRMImplicitPermafrostModel::si_frozen_unsaturated_(double pc_liq, double pc_ice) {
   double si(0.);
+  if (table_.initialized() && table_.Value(std::log(pc_liq), std::log(pc_ice), si)) {
+    return std::min(std::max(si, 0.), 1.);
+  }
 
   // check if we are in the splined region
   double cutoff(0.), si_cutoff(0.);
@@ -175,15 +185,20 @@ double WRMImplicitPermafrostModel::dsi_dpc_liq_frozen_unsaturated_(double pc_liq
   double cutoff(0.), si_cutoff(0.);
   double dsi(0.);
 
-  DetermineSplineCutoff_(pc_liq, pc_ice, cutoff, si_cutoff);
-  if (pc_liq > cutoff) {
-    // outside of the spline
-    dsi = dsi_dpc_liq_frozen_unsaturated_nospline_(pc_liq, pc_ice, si);
+  if (table_.initialized() && table_.DerivativeX(std::log(pc_liq), std::log(pc_ice), dsi)) {
+    // tabulated in log(pc_liq)
+    dsi /= pc_liq;
   } else {
-    // fit spline, evaluate
-    double spline[4];
-    FitSpline_(pc_ice, cutoff, si_cutoff, spline);
-    dsi = (3 * spline[0] * pc_liq + 2 * spline[1]) * pc_liq + spline[2];
+    DetermineSplineCutoff_(pc_liq, pc_ice, cutoff, si_cutoff);
+    if (pc_liq > cutoff) {
+      // outside of the spline
+      dsi = dsi_dpc_liq_frozen_unsaturated_nospline_(pc_liq, pc_ice, si);
+    } else {
+      // fit spline, evaluate
+      double spline[4];
+      FitSpline_(pc_ice, cutoff, si_cutoff, spline);
+      dsi = (3 * spline[0] * pc_liq + 2 * spline[1]) * pc_liq + spline[2];
+    }
   }
 
   // regularize
@@ -197,6 +212,12 @@ double WRMImplicitPermafrostModel::dsi_dpc_liq_frozen_unsaturated_(double pc_liq
 // -- dsi_dpcice calculation, partially frozen, unsaturated
 double WRMImplicitPermafrostModel::dsi_dpc_ice_frozen_unsaturated_(double pc_liq,
         double pc_ice, double si) {
+  double dsi(0.);
+  if (table_.initialized() && table_.DerivativeY(std::log(pc_liq), std::log(pc_ice), dsi)) {
+    // tabulated in log(pc_ice)
+    return dsi / pc_ice;
+  }
+
   // check if we are in the splined region
   double cutoff(0.), si_cutoff(0.);
   DetermineSplineCutoff_(pc_liq, pc_ice, cutoff, si_cutoff);
@@ -374,6 +395,139 @@ double WRMImplicitPermafrostModel::dsi_dpc_ice_frozen_unsaturated_nospline_(doub
 }
 
 
+// Tabulation
+// -- Value and derivatives, in log space, at a node.  Nodes in the splined
+//    region, or where the solve fails, are invalid.  The cross derivative
+//    needs second derivatives of the WRM, so it is a centered difference of
+//    the exact d/dy over a step in x much smaller than the table spacing.
+bool WRMImplicitPermafrostModel::TableNode_(double x, double y, double (&vals)[4]) {
+  const double delta = 1.e-4;
+  double pc_ice = std::exp(y);
+
+  double cutoff(0.), si_cutoff(0.);
+  try {
+    DetermineSplineCutoff_(std::exp(x), pc_ice, cutoff, si_cutoff);
+  } catch (const Errors::CutTimeStep& e) {
+    return false;
+  }
+
+  double dsi_dy[2];
+  for (int k=0; k!=3; ++k) {
+    double pc_liq = std::exp(x + (k-1)*delta);
+    if (pc_liq <= cutoff) return false;
+
+    double si;
+    try {
+      si = si_frozen_unsaturated_nospline_(pc_liq, pc_ice, true);
+    } catch (const Errors::CutTimeStep& e) {
+      return false;
+    }
+
+    double dy = dsi_dpc_ice_frozen_unsaturated_nospline_(pc_liq, pc_ice, si) * pc_ice;
+    if (k == 1) {
+      vals[0] = si;
+      vals[1] = dsi_dpc_liq_frozen_unsaturated_nospline_(pc_liq, pc_ice, si) * pc_liq;
+      vals[2] = dy;
+    } else {
+      dsi_dy[k/2] = dy;
+    }
+  }
+  vals[3] = (dsi_dy[1] - dsi_dy[0]) / (2*delta);
+  return true;
+}
+
+
+// -- Build the table, refining until its value and derivatives match the
+//    exact solve at points within each cell.  Ice saturation has a kink
+//    where ice first forms; cells across it do not improve with refinement,
+//    and are left to the exact solve.
+void WRMImplicitPermafrostModel::InitializeTable_() {
+  Teuchos::Array<double> range(2);
+  range[0] = 10.;
+  range[1] = 1.e8;
+  range = plist_.get<Teuchos::Array<double> >("tabulation capillary pressure range [Pa]", range);
+  int per_decade = plist_.get<int>("tabulation points per decade", 10);
+  double tol = plist_.get<double>("tabulation tolerance [-]", 1.e-8);
+  double dtol = plist_.get<double>("tabulation derivative tolerance [-]", 1.e-4);
+
+  double x0 = std::log(range[0]);
+  double x1 = std::log(range[1]);
+  double decades = std::log10(range[1] / range[0]);
+  auto node = [this](double x, double y, double (&vals)[4]) { return TableNode_(x, y, vals); };
+
+  // check points, in cell coordinates
+  const double pts[5][2] = { {0.5, 0.5}, {0.25, 0.25}, {0.75, 0.25}, {0.25, 0.75}, {0.75, 0.75} };
+
+  int n_bad_prev = -1;
+  for (; ; per_decade *= 2) {
+    int n = static_cast<int>(std::ceil(decades * per_decade)) + 1;
+    table_.Setup(x0, x1, n, x0, x1, n, node);
+    double h = (x1 - x0) / (n - 1);
+
+    // exact values and log-space derivatives at the check points of valid
+    // cells; a failed solve marks the cell bad
+    std::vector<int> cells;
+    std::vector<double> exact;
+    std::vector<char> bad;
+    double dmax[2] = {0., 0.};
+    for (int j=0; j!=n-1; ++j) {
+      for (int i=0; i!=n-1; ++i) {
+        double si;
+        if (!table_.Value(x0 + (i+0.5)*h, x0 + (j+0.5)*h, si)) continue;
+
+        cells.push_back(j*(n-1) + i);
+        bad.push_back(false);
+        for (int q=0; q!=5; ++q) {
+          double pc_liq = std::exp(x0 + (i+pts[q][0])*h);
+          double pc_ice = std::exp(x0 + (j+pts[q][1])*h);
+          double vals[3] = {0., 0., 0.};
+          try {
+            vals[0] = si_frozen_unsaturated_nospline_(pc_liq, pc_ice, true);
+            vals[1] = dsi_dpc_liq_frozen_unsaturated_nospline_(pc_liq, pc_ice, vals[0]) * pc_liq;
+            vals[2] = dsi_dpc_ice_frozen_unsaturated_nospline_(pc_liq, pc_ice, vals[0]) * pc_ice;
+          } catch (const Errors::CutTimeStep& e) {
+            bad.back() = true;
+          }
+          dmax[0] = std::max(dmax[0], std::abs(vals[1]));
+          dmax[1] = std::max(dmax[1], std::abs(vals[2]));
+          exact.insert(exact.end(), vals, vals+3);
+        }
+      }
+    }
+
+    int n_bad = 0;
+    for (int c=0; c!=cells.size(); ++c) {
+      int i = cells[c] % (n-1), j = cells[c] / (n-1);
+      for (int q=0; q!=5 && !bad[c]; ++q) {
+        double x = x0 + (i+pts[q][0])*h;
+        double y = x0 + (j+pts[q][1])*h;
+        const double* vals = &exact[3*(5*c + q)];
+        double si, dsi_dx, dsi_dy;
+        table_.Value(x, y, si);
+        table_.DerivativeX(x, y, dsi_dx);
+        table_.DerivativeY(x, y, dsi_dy);
+        bad[c] = std::abs(si - vals[0]) > tol
+                 || std::abs(dsi_dx - vals[1]) > dtol * dmax[0]
+                 || std::abs(dsi_dy - vals[2]) > dtol * dmax[1];
+      }
+      if (bad[c]) n_bad++;
+    }
+    if (n_bad == 0) return;
+
+    // Refinement resolves the smooth region, reducing the bad cells many
+    // times over.  The cells that remain lie on the kink, and double in
+    // number with each refinement.
+    if ((n_bad_prev >= 0 && 2*n_bad > n_bad_prev) || 2*per_decade > 80) {
+      for (int c=0; c!=cells.size(); ++c) {
+        if (bad[c]) table_.InvalidateCell(cells[c] % (n-1), cells[c] / (n-1));
+      }
+      return;
+    }
+    n_bad_prev = n_bad;
+  }
+}
+
+
 // PUBLIC METHODS
 // Calculate the saturation
 void WRMImplicitPermafrostModel::saturations(double pc_liq, double pc_ice,
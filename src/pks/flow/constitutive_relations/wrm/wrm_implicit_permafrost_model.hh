@@ -3,6 +3,27 @@ Author: Ethan Coon
 
 Painter's permafrost model.
 
+Ice saturation is the root of an implicit equation, solved per call by
+bisection or TOMS748.  Optionally, with `"tabulate`" true, ice saturation and
+its partial derivatives are instead interpolated from a bicubic table in
+(log pc_liq, log pc_ice), built when the model is given its WRM.  Near the
+saturated and unfrozen boundaries, where the model splines or switches
+branches, across the kink where ice first forms, and outside the tabulated
+range, the exact solve is used.
+
+* `"tabulate`" ``[bool]`` **false**
+* `"tabulation capillary pressure range [Pa]`" ``[Array(double)]`` **{10, 1e8}**
+  Range, for both liquid and ice capillary pressure, of the table.
+* `"tabulation points per decade`" ``[int]`` **10** Initial table density;
+  doubled, up to 80, until the tolerances are met.  Cells that still miss
+  them are left to the exact solve.
+* `"tabulation tolerance [-]`" ``[double]`` **1e-8** Maximum error in ice
+  saturation, checked at setup against the exact solve at five points in
+  each cell.
+* `"tabulation derivative tolerance [-]`" ``[double]`` **1e-4** Maximum error
+  in each partial derivative of ice saturation, relative to the largest
+  magnitude of that derivative, checked at the same points.
+
  */
 
 #ifndef AMANZI_FLOWRELATIONS_WRM_IMPLICIT_PERMAFROST_MODEL_
@@ -14,6 +35,7 @@ Painter's permafrost model.
 
 #include "wrm_permafrost_model.hh"
 #include "wrm_permafrost_factory.hh"
+#include "wrm_table.hh"
 
 namespace Amanzi {
 namespace Flow {
@@ -26,6 +48,9 @@ class WRMImplicitPermafrostModel : public WRMPermafrostModel {
   explicit
   WRMImplicitPermafrostModel(Teuchos::ParameterList& plist);
 
+  // builds the table, if tabulated
+  virtual void set_WRM(const Teuchos::RCP<WRM>& wrm);
+
   // required methods from the base class
   // sats[0] = sg, sats[1] = sl, sats[2] = si
   virtual bool freezing(double T, double pc_liq, double pc_ice) { return T < 273.15; }
@@ -64,6 +89,10 @@ class WRMImplicitPermafrostModel : public WRMPermafrostModel {
   bool DetermineSplineCutoff_(double pc_liq, double pc_ice, double& cutoff, double& si);
   bool FitSpline_(double pc_ice, double cutoff, double si_cutoff, double (&coefs)[4]);
 
+  // tabulation of si outside of the splined region
+  void InitializeTable_();
+  bool TableNode_(double x, double y, double (&vals)[4]);
+
 
  protected:
   double eps_;
@@ -71,6 +100,9 @@ class WRMImplicitPermafrostModel : public WRMPermafrostModel {
   double deriv_regularization_;
   std::string solver_;
 
+  bool tabulate_;
+  WRMTable2D table_;
+
  private:
   // Functor for ice saturation, gets used within a root-finding algorithm
   class SatIceFunctor_ {
@@ -34,6 +34,19 @@ public:
   virtual double d_capillaryPressure(double saturation) { return 1./alpha_; }
   virtual double residualSaturation() { return 0.0; }
 
+  virtual void k_relativeArray(int n, const double* sat, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = 1.0;
+  }
+  virtual void d_k_relativeArray(int n, const double* sat, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = 0.0;
+  }
+  virtual void saturationArray(int n, const double* pc, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = sat_at_zero_pc_ + alpha_*pc[i];
+  }
+  virtual void d_saturationArray(int n, const double* pc, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = alpha_;
+  }
+
  private:
   void InitializeFromPlist_();
 
@@ -14,6 +14,22 @@
 namespace Amanzi {
 namespace Flow {
 
+std::vector<PartitionRun>
+createPartitionRuns(const Functions::MeshPartition& partition, int n) {
+  std::vector<PartitionRun> runs;
+  for (int i=0; i!=n; ++i) {
+    int index = partition[i];
+    if (runs.empty() || runs.back().index != index) {
+      PartitionRun run = { index, i, i+1 };
+      runs.push_back(run);
+    } else {
+      runs.back().end = i+1;
+    }
+  }
+  return runs;
+}
+
+
 // Non-member factory
 Teuchos::RCP<WRMPartition>
 createWRMPartition(Teuchos::ParameterList& plist) {
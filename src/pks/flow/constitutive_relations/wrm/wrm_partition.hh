@@ -37,6 +37,18 @@ typedef std::pair<Teuchos::RCP<Functions::MeshPartition>, WRMList> WRMPartition;
 typedef std::vector<Teuchos::RCP<WRMPermafrostModel> > WRMPermafrostModelList;
 typedef std::pair<Teuchos::RCP<Functions::MeshPartition>, WRMPermafrostModelList> WRMPermafrostModelPartition;
 
+// A contiguous run of entities, [begin, end), that share the model index.
+struct PartitionRun {
+  int index;
+  int begin;
+  int end;
+};
+
+// Splits the first n entities of a partition into runs, so that each run may
+// be evaluated by one call to a model's array methods.
+std::vector<PartitionRun>
+createPartitionRuns(const Functions::MeshPartition& partition, int n);
+
 // Non-member factory
 Teuchos::RCP<WRMPartition>
 createWRMPartition(Teuchos::ParameterList& plist);
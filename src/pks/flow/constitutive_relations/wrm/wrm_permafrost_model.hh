@@ -22,7 +22,7 @@ public:
 
   virtual ~WRMPermafrostModel() {}
 
-  void set_WRM(const Teuchos::RCP<WRM>& wrm) { wrm_ = wrm; }
+  virtual void set_WRM(const Teuchos::RCP<WRM>& wrm) { wrm_ = wrm; }
 
   virtual bool freezing(double T, double pc_liq, double pc_ice) = 0;
   virtual void saturations(double pc_liq, double pc_ice, double (&sats)[3]) = 0;
@@ -0,0 +1,256 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! WRMTable, WRMTable2D: uniformly spaced cubic Hermite tables of WRM curves.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+Tabulates a smooth function on an interval using its values and derivatives
+at uniformly spaced nodes.  Between nodes, the function is the cubic Hermite
+interpolant, so values and derivatives are continuous and the derivative of
+the table is consistent with its values.  A lookup is one multiply, one
+truncation, and a cubic in Horner form.
+
+At setup, the number of nodes is doubled until, at points between the nodes,
+values match the function to within an absolute tolerance and derivatives
+match to within a tolerance relative to the largest derivative.  This is the
+self-check against the analytic model; if it cannot be met, setup throws.
+
+WRMTable2D is the bicubic analogue, for functions of two variables such as ice
+saturation in the implicit permafrost model.  Nodes store the value, both
+partial derivatives, and the cross derivative, all supplied by the caller.
+Nodes may be marked invalid, in which case lookups in the cells touching them
+fail and the caller falls back to the exact function.
+
+*/
+
+#ifndef ATS_FLOWRELATIONS_WRM_TABLE_HH_
+#define ATS_FLOWRELATIONS_WRM_TABLE_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "errors.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+class WRMTable {
+
+ public:
+  WRMTable() : n_(0) {}
+
+  // Tabulate f, whose derivative is df, on [x0, x1].
+  template<class F, class DF>
+  void Setup(double x0, double x1, F f, DF df, double tol, double dtol,
+             int n_start=256, int n_max=262144);
+
+  bool initialized() const { return n_ > 0; }
+  int size() const { return n_; }
+
+  // Lookups.  x must be in [x0, x1].
+  double operator()(double x) const {
+    double t = (x - x0_) * inv_h_;
+    int i = std::min(static_cast<int>(t), n_-1);
+    t -= i;
+    const double* c = &coefs_[4*i];
+    return ((c[0]*t + c[1])*t + c[2])*t + c[3];
+  }
+
+  double Derivative(double x) const {
+    double t = (x - x0_) * inv_h_;
+    int i = std::min(static_cast<int>(t), n_-1);
+    t -= i;
+    const double* c = &coefs_[4*i];
+    return ((3.*c[0]*t + 2.*c[1])*t + c[2]) * inv_h_;
+  }
+
+ private:
+  template<class F, class DF>
+  void Build_(double x0, double x1, int n, F f, DF df);
+
+ private:
+  int n_;   // number of intervals
+  double x0_, inv_h_;
+  std::vector<double> coefs_;  // cubic coefficients, 4 per interval
+};
+
+
+template<class F, class DF>
+void WRMTable::Build_(double x0, double x1, int n, F f, DF df)
+{
+  n_ = n;
+  x0_ = x0;
+  double h = (x1 - x0) / n;
+  inv_h_ = 1. / h;
+  coefs_.resize(4*n);
+
+  double f0 = f(x0), m0 = df(x0) * h;
+  for (int i=0; i!=n; ++i) {
+    double x = (i+1 == n) ? x1 : x0 + (i+1)*h;
+    double f1 = f(x), m1 = df(x) * h;
+    coefs_[4*i] = 2.*(f0 - f1) + m0 + m1;
+    coefs_[4*i+1] = 3.*(f1 - f0) - 2.*m0 - m1;
+    coefs_[4*i+2] = m0;
+    coefs_[4*i+3] = f0;
+    f0 = f1;
+    m0 = m1;
+  }
+}
+
+
+template<class F, class DF>
+void WRMTable::Setup(double x0, double x1, F f, DF df, double tol, double dtol,
+                     int n_start, int n_max)
+{
+  for (int n=n_start; n<=n_max; n*=2) {
+    Build_(x0, x1, n, f, df);
+
+    // check at the quarter points of each interval
+    double h = (x1 - x0) / n;
+    double err = 0., derr = 0., dmax = 0.;
+    for (int i=0; i!=n; ++i) {
+      for (int q=1; q!=4; ++q) {
+        double x = x0 + (i + 0.25*q)*h;
+        double dfx = df(x);
+        err = std::max(err, std::abs((*this)(x) - f(x)));
+        derr = std::max(derr, std::abs(Derivative(x) - dfx));
+        dmax = std::max(dmax, std::abs(dfx));
+      }
+    }
+    if (err <= tol && derr <= dtol * dmax) return;
+  }
+
+  n_ = 0;
+  Errors::Message msg;
+  msg << "WRM: tabulation could not reach the requested tolerance with " << n_max
+      << " points; increase \"tabulation tolerance [-]\" or turn off tabulation.";
+  Exceptions::amanzi_throw(msg);
+}
+
+
+class WRMTable2D {
+
+ public:
+  WRMTable2D() : nx_(0), ny_(0) {}
+
+  // Tabulate on an nx by ny grid of nodes covering [x0, x1] x [y0, y1].
+  // f(x, y, vals) sets vals to the value, the x and y partial derivatives,
+  // and the cross derivative at a node, and returns false if the node is
+  // invalid.
+  template<class F>
+  void Setup(double x0, double x1, int nx, double y0, double y1, int ny, F f);
+
+  bool initialized() const { return nx_ > 0; }
+
+  // Marks the cell between nodes i and i+1 in x and j and j+1 in y invalid.
+  void InvalidateCell(int i, int j) { valid_[j*(nx_-1) + i] = 0; }
+
+  // Lookups.  Return false if (x,y) is not in a valid cell.
+  bool Value(double x, double y, double& val) const {
+    return Evaluate_(x, y, 0, val);
+  }
+  bool DerivativeX(double x, double y, double& val) const {
+    return Evaluate_(x, y, 1, val);
+  }
+  bool DerivativeY(double x, double y, double& val) const {
+    return Evaluate_(x, y, 2, val);
+  }
+
+ private:
+  bool Evaluate_(double x, double y, int deriv, double& val) const;
+
+ private:
+  int nx_, ny_;
+  double x0_, y0_, hx_, hy_;
+  std::vector<double> nodes_;  // value, d/dx, d/dy, d2/dxdy per node
+  std::vector<char> valid_;    // per cell
+};
+
+
+template<class F>
+void WRMTable2D::Setup(double x0, double x1, int nx, double y0, double y1, int ny, F f)
+{
+  nx_ = nx;
+  ny_ = ny;
+  x0_ = x0;
+  y0_ = y0;
+  hx_ = (x1 - x0) / (nx - 1);
+  hy_ = (y1 - y0) / (ny - 1);
+  nodes_.assign(4*nx*ny, 0.);
+
+  std::vector<char> node_valid(nx*ny);
+  for (int j=0; j!=ny; ++j) {
+    for (int i=0; i!=nx; ++i) {
+      double vals[4];
+      int n = j*nx + i;
+      node_valid[n] = f(x0 + i*hx_, y0 + j*hy_, vals);
+      if (node_valid[n]) {
+        for (int k=0; k!=4; ++k) nodes_[4*n+k] = vals[k];
+      }
+    }
+  }
+
+  valid_.assign((nx-1)*(ny-1), 0);
+  for (int j=0; j!=ny-1; ++j) {
+    for (int i=0; i!=nx-1; ++i) {
+      int n = j*nx + i;
+      valid_[j*(nx-1) + i] = node_valid[n] && node_valid[n+1]
+                             && node_valid[n+nx] && node_valid[n+nx+1];
+    }
+  }
+}
+
+
+inline bool WRMTable2D::Evaluate_(double x, double y, int deriv, double& val) const
+{
+  double t = (x - x0_) / hx_;
+  double u = (y - y0_) / hy_;
+  if (!(t >= 0. && u >= 0.)) return false;
+  int i = static_cast<int>(t);
+  int j = static_cast<int>(u);
+  if (i >= nx_-1 || j >= ny_-1 || !valid_[j*(nx_-1) + i]) return false;
+  t -= i;
+  u -= j;
+
+  // cubic Hermite basis and derivatives in each direction: value at 0, value
+  // at 1, slope at 0, slope at 1
+  double t2 = t*t, t3 = t2*t, u2 = u*u, u3 = u2*u;
+  double bt[4], bu[4];
+  if (deriv == 1) {
+    bt[0] = (6*t2 - 6*t) / hx_;  bt[1] = (-6*t2 + 6*t) / hx_;
+    bt[2] = 3*t2 - 4*t + 1;      bt[3] = 3*t2 - 2*t;
+  } else {
+    bt[0] = 2*t3 - 3*t2 + 1;     bt[1] = -2*t3 + 3*t2;
+    bt[2] = (t3 - 2*t2 + t)*hx_; bt[3] = (t3 - t2)*hx_;
+  }
+  if (deriv == 2) {
+    bu[0] = (6*u2 - 6*u) / hy_;  bu[1] = (-6*u2 + 6*u) / hy_;
+    bu[2] = 3*u2 - 4*u + 1;      bu[3] = 3*u2 - 2*u;
+  } else {
+    bu[0] = 2*u3 - 3*u2 + 1;     bu[1] = -2*u3 + 3*u2;
+    bu[2] = (u3 - 2*u2 + u)*hy_; bu[3] = (u3 - u2)*hy_;
+  }
+
+  val = 0.;
+  for (int b=0; b!=2; ++b) {
+    for (int a=0; a!=2; ++a) {
+      const double* node = &nodes_[4*((j+b)*nx_ + i+a)];
+      val += bt[a]*bu[b]*node[0] + bt[2+a]*bu[b]*node[1]
+             + bt[a]*bu[2+b]*node[2] + bt[2+a]*bu[2+b]*node[3];
+    }
+  }
+  return true;
+}
+
+} // namespace
+} // namespace
+
+#endif
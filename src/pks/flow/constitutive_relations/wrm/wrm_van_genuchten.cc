@@ -9,6 +9,7 @@
 #include "dbc.hh"
 #include "errors.hh"
 #include "Spline.hh"
+#include "dual.hh"
 
 #include "wrm_van_genuchten.hh"
 
@@ -21,24 +22,64 @@ const double FLOW_WRM_TOLERANCE = 1e-10;
  * Setup fundamental parameters for this model.
  ****************************************************************** */
 WRMVanGenuchten::WRMVanGenuchten(Teuchos::ParameterList& plist) :
-    plist_(plist) {
+    plist_(plist),
+    // empty table ranges, so that the analytic curves are used to set up the
+    // smoothing fits and to build the tables
+    table_pc_min_(1.),
+    table_pc_max_(-1.),
+    table_s_min_(1.),
+    table_s_max_(-1.) {
   InitializeFromPlist_();
 };
 
 
+/* ******************************************************************
+ * The analytic relative permeability, on double or Dual.  Its derivative
+ * is singular as se -> 1, and is taken to be zero there.
+ ****************************************************************** */
+template<class T>
+T WRMVanGenuchten::k_relative_(const T& s) const {
+  using std::pow;
+  T se = (s - sr_) / (1.0 - sr_);
+  T x = pow(se, 1.0 / m_);
+  if (std::fabs(1.0 - value(x)) < FLOW_WRM_TOLERANCE) {
+    return T(k_relative_(value(se), value(x)));
+  }
+  return k_relative_(se, x);
+}
+
+template<class T>
+T WRMVanGenuchten::k_relative_(const T& se, const T& x) const {
+  using std::pow;
+  T one_minus_y = 1.0 - pow(1.0 - x, m_);
+  if (function_ == FLOW_WRM_MUALEM) {
+    return pow(se, l_) * one_minus_y * one_minus_y;
+  } else {
+    return se * se * one_minus_y;
+  }
+}
+
+
+/* ******************************************************************
+ * The analytic saturation, on double or Dual.
+ ****************************************************************** */
+template<class T>
+T WRMVanGenuchten::saturation_(const T& pc) const {
+  using std::pow;
+  return pow(1.0 + pow(alpha_*pc, n_), -m_) * (1.0 - sr_) + sr_;
+}
+
+
 /* ******************************************************************
 * Relative permeability formula: input is liquid saturation.
 * The original curve is regulized on interval (s0, 1) using the
 * Hermite interpolant of order 3. Formulas (3.11)-(3.12).
 ****************************************************************** */
 double WRMVanGenuchten::k_relative(double s) {
-  if (s <= s0_) {
-    double se = (s - sr_)/(1-sr_);
-    if (function_ == FLOW_WRM_MUALEM) {
-      return pow(se, l_) * pow(1.0 - pow(1.0 - pow(se, 1.0/m_), m_), 2.0);
-    } else {
-      return se * se * (1.0 - pow(1.0 - pow(se, 1.0/m_), m_));
-    }
+  if (s >= table_s_min_ && s <= table_s_max_) {
+    return table_kr_(s);
+  } else if (s <= s0_) {
+    return k_relative_(s);
   } else if (s == 1.0) {
     return 1.0;
   } else {
@@ -48,24 +89,13 @@ double WRMVanGenuchten::k_relative(double s) {
 
 
 /* ******************************************************************
- * D Relative permeability / D capillary pressure pc.
+ * D Relative permeability / D saturation.
  ****************************************************************** */
 double WRMVanGenuchten::d_k_relative(double s) {
-  if (s <= s0_) {
-    double se = (s - sr_)/(1-sr_);
-
-    double x = pow(se, 1.0 / m_);
-    if (fabs(1.0 - x) < FLOW_WRM_TOLERANCE) return 0.0;
-
-    double y = pow(1.0 - x, m_);
-    double dkdse;
-    if (function_ == FLOW_WRM_MUALEM)
-      dkdse = (1.0 - y) * (l_ * (1.0 - y) + 2 * x * y / (1.0 - x)) * pow(se, l_ - 1.0);
-    else
-      dkdse = (2 * (1.0 - y) + x / (1.0 - x)) * se;
-
-    return dkdse / (1 - sr_);
-
+  if (s >= table_s_min_ && s <= table_s_max_) {
+    return table_kr_.Derivative(s);
+  } else if (s <= s0_) {
+    return k_relative_(Dual<1>::Variable(s, 0)).d(0);
   } else if (s == 1.0) {
     return 0.0;
   } else {
@@ -74,12 +104,36 @@ double WRMVanGenuchten::d_k_relative(double s) {
 }
 
 
+/* ******************************************************************
+ * Relative permeability and its derivative together.  On the analytic
+ * branch these share one evaluation of each power.
+ ****************************************************************** */
+double WRMVanGenuchten::k_relativeAndDerivative(double s, double* dkr) {
+  if (s >= table_s_min_ && s <= table_s_max_) {
+    *dkr = table_kr_.Derivative(s);
+    return table_kr_(s);
+  } else if (s <= s0_) {
+    Dual<1> kr = k_relative_(Dual<1>::Variable(s, 0));
+    *dkr = kr.d(0);
+    return kr.value();
+  } else if (s == 1.0) {
+    *dkr = 0.0;
+    return 1.0;
+  } else {
+    *dkr = fit_kr_.Derivative(s);
+    return fit_kr_(s);
+  }
+}
+
+
 /* ******************************************************************
  * Saturation formula (3.5)-(3.6).
  ****************************************************************** */
 double WRMVanGenuchten::saturation(double pc) {
-  if (pc > pc0_) {
-    return std::pow(1.0 + std::pow(alpha_*pc, n_), -m_) * (1.0 - sr_) + sr_;
+  if (pc >= table_pc_min_ && pc <= table_pc_max_) {
+    return table_s_(std::log(pc));
+  } else if (pc > pc0_) {
+    return saturation_(pc);
   } else if (pc <= 0.) {
     return 1.0;
   } else {
@@ -92,8 +146,10 @@ double WRMVanGenuchten::saturation(double pc) {
  * Derivative of the saturation formula w.r.t. capillary pressure.
  ****************************************************************** */
 double WRMVanGenuchten::d_saturation(double pc) {
-  if (pc > pc0_) {
-    return -m_*n_ * std::pow(1.0 + std::pow(alpha_*pc, n_), -m_-1.0) * std::pow(alpha_*pc, n_-1) * alpha_ * (1.0 - sr_);
+  if (pc >= table_pc_min_ && pc <= table_pc_max_) {
+    return table_s_.Derivative(std::log(pc)) / pc;
+  } else if (pc > pc0_) {
+    return saturation_(Dual<1>::Variable(pc, 0)).d(0);
   } else if (pc <= 0.) {
     return 0.0;
   } else {
@@ -101,6 +157,29 @@ double WRMVanGenuchten::d_saturation(double pc) {
   }
 }
 
+
+/* ******************************************************************
+ * Saturation and its derivative together.
+ ****************************************************************** */
+double WRMVanGenuchten::saturationAndDerivative(double pc, double* dsat) {
+  if (pc >= table_pc_min_ && pc <= table_pc_max_) {
+    double x = std::log(pc);
+    *dsat = table_s_.Derivative(x) / pc;
+    return table_s_(x);
+  } else if (pc > pc0_) {
+    Dual<1> sat = saturation_(Dual<1>::Variable(pc, 0));
+    *dsat = sat.d(0);
+    return sat.value();
+  } else if (pc <= 0.) {
+    *dsat = 0.0;
+    return 1.0;
+  } else {
+    *dsat = fit_s_.Derivative(pc);
+    return fit_s_(pc);
+  }
+}
+
+
 /* ******************************************************************
  * Pressure as a function of saturation.
  ****************************************************************** */
@@ -132,6 +211,36 @@ double WRMVanGenuchten::d_capillaryPressure(double s) {
 }
 
 
+/* ******************************************************************
+ * Array versions: qualified calls are not virtual, and may be inlined.
+ ****************************************************************** */
+void WRMVanGenuchten::k_relativeArray(int n, const double* s, double* result) {
+  for (int i=0; i!=n; ++i) result[i] = WRMVanGenuchten::k_relative(s[i]);
+}
+
+void WRMVanGenuchten::d_k_relativeArray(int n, const double* s, double* result) {
+  for (int i=0; i!=n; ++i) result[i] = WRMVanGenuchten::d_k_relative(s[i]);
+}
+
+void WRMVanGenuchten::saturationArray(int n, const double* pc, double* result) {
+  for (int i=0; i!=n; ++i) result[i] = WRMVanGenuchten::saturation(pc[i]);
+}
+
+void WRMVanGenuchten::d_saturationArray(int n, const double* pc, double* result) {
+  for (int i=0; i!=n; ++i) result[i] = WRMVanGenuchten::d_saturation(pc[i]);
+}
+
+void WRMVanGenuchten::k_relativeAndDerivativeArray(int n, const double* s,
+        double* result, double* d_result) {
+  for (int i=0; i!=n; ++i) result[i] = WRMVanGenuchten::k_relativeAndDerivative(s[i], &d_result[i]);
+}
+
+void WRMVanGenuchten::saturationAndDerivativeArray(int n, const double* pc,
+        double* result, double* d_result) {
+  for (int i=0; i!=n; ++i) result[i] = WRMVanGenuchten::saturationAndDerivative(pc[i], &d_result[i]);
+}
+
+
 void WRMVanGenuchten::InitializeFromPlist_() {
   std::string fname = plist_.get<std::string>("Krel function name", "Mualem");
   if (fname == std::string("Mualem")) {
@@ -203,7 +312,44 @@ void WRMVanGenuchten::InitializeFromPlist_() {
   if (pc0_ > 0.) {
     fit_s_.Setup(0.0, 1.0, 0.0, pc0_, saturation(pc0_), d_saturation(pc0_));
   }  
+
+  if (plist_.get<bool>("tabulate", false)) InitializeTables_();
 };
 
+
+/* ******************************************************************
+ * Tabulate the curves on the regions where they are analytic.
+ ****************************************************************** */
+void WRMVanGenuchten::InitializeTables_() {
+  double tol = plist_.get<double>("tabulation tolerance [-]", 1.e-10);
+  double dtol = plist_.get<double>("tabulation derivative tolerance [-]", 1.e-6);
+
+  // saturation, as a function of x = log(pc)
+  double pc_min = std::max(1.e-3 / alpha_, pc0_);
+  double pc_max = 1.e4 / alpha_;
+  table_s_.Setup(std::log(pc_min), std::log(pc_max),
+                 [this](double x) { return saturation(std::exp(x)); },
+                 [this](double x) { double pc = std::exp(x); return d_saturation(pc) * pc; },
+                 tol, dtol);
+
+  // rel perm, as a function of saturation.  Both ends are singular in
+  // derivatives, and are left to the analytic curve.
+  double s_min = sr_ + 1.e-3 * (1.0 - sr_);
+  double s_max = std::min(s0_, sr_ + 0.99 * (1.0 - sr_));
+  if (s_max > s_min) {
+    table_kr_.Setup(s_min, s_max,
+                    [this](double s) { return k_relative(s); },
+                    [this](double s) { return d_k_relative(s); },
+                    tol, dtol);
+  }
+
+  table_pc_min_ = pc_min;
+  table_pc_max_ = pc_max;
+  if (table_kr_.initialized()) {
+    table_s_min_ = s_min;
+    table_s_max_ = s_max;
+  }
+}
+
 }  // namespace
 }  // namespace
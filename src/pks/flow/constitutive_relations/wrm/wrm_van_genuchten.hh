@@ -29,6 +29,19 @@ END
 
 * `"Krel function name`" ``[string]`` **Mualem**  `"Mualem`" or `"Burdine`"
 
+* `"tabulate`" ``[bool]`` **false** Replace the analytic curves with lookup
+  tables, built at setup.  Saturation is tabulated in log capillary pressure
+  for alpha*pc in [1e-3, 1e4], and relative permeability in saturation,
+  away from the residual and full saturation ends.  Outside these ranges the
+  analytic curves are used.  As the permafrost models call this WRM, they
+  benefit as well.
+
+* `"tabulation tolerance [-]`" ``[double]`` **1e-10** Maximum error in
+  saturation or relative permeability of the tables.
+
+* `"tabulation derivative tolerance [-]`" ``[double]`` **1e-6** Maximum error
+  in derivatives of the tables, relative to the largest derivative.
+
 Example:
 
 .. code-block:: xml
@@ -51,6 +64,7 @@ Example:
 #include "Spline.hh"
 
 #include "wrm.hh"
+#include "wrm_table.hh"
 #include "Factory.hh"
 
 namespace Amanzi {
@@ -70,8 +84,25 @@ public:
   double d_capillaryPressure(double saturation);
   double residualSaturation() { return sr_; }
 
+  void k_relativeArray(int n, const double* sat, double* result);
+  void d_k_relativeArray(int n, const double* sat, double* result);
+  void saturationArray(int n, const double* pc, double* result);
+  void d_saturationArray(int n, const double* pc, double* result);
+  void k_relativeAndDerivativeArray(int n, const double* sat, double* result, double* d_result);
+  void saturationAndDerivativeArray(int n, const double* pc, double* result, double* d_result);
+
+  double k_relativeAndDerivative(double saturation, double* d_kr);
+  double saturationAndDerivative(double pc, double* d_sat);
+
  private:
+  // The analytic curves, templated on double or Dual so that their
+  // derivatives are computed alongside the value.
+  template<class T> T k_relative_(const T& s) const;
+  template<class T> T k_relative_(const T& se, const T& x) const;
+  template<class T> T saturation_(const T& pc) const;
+
   void InitializeFromPlist_();
+  void InitializeTables_();
 
   Teuchos::ParameterList& plist_;
 
@@ -87,7 +118,13 @@ public:
 
   double pc0_;
   Amanzi::Utils::Spline fit_s_;
-  
+
+  // optional tables: saturation in log(pc), rel perm in saturation
+  WRMTable table_s_;
+  double table_pc_min_, table_pc_max_;
+  WRMTable table_kr_;
+  double table_s_min_, table_s_max_;
+
 
   static Utils::RegisteredFactory<WRM,WRMVanGenuchten> factory_;
 };
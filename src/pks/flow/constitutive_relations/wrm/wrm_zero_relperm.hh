@@ -30,6 +30,19 @@ class WRMZeroRelPerm : public WRM {
   double d_capillaryPressure(double sat) { return wrm_->d_capillaryPressure(sat); }
   double residualSaturation() { return wrm_->residualSaturation(); }
 
+  void k_relativeArray(int n, const double* sat, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = 0.0;
+  }
+  void d_k_relativeArray(int n, const double* sat, double* result) {
+    for (int i=0; i!=n; ++i) result[i] = 0.0;
+  }
+  void saturationArray(int n, const double* pc, double* result) {
+    wrm_->saturationArray(n, pc, result);
+  }
+  void d_saturationArray(int n, const double* pc, double* result) {
+    wrm_->d_saturationArray(n, pc, result);
+  }
+
  private:
   void InitializeFromPlist_();
 
@@ -0,0 +1,254 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -----------------------------------------------------------------------------
+Explicit, locally time stepped, diffusion wave kernel for overland flow.
+License: BSD
+Author: Ethan Coon (ecoon@lanl.gov)
+----------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <cmath>
+
+#include "manning_conductivity_model.hh"
+#include "diffusion_wave_subcycler.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+DiffusionWaveSubcycler::DiffusionWaveSubcycler(Teuchos::ParameterList& plist,
+                                               const Epetra_Map& cell_map,
+                                               const Epetra_Map& cell_map_ghosted,
+                                               int nfaces, int nfaces_owned, double gz) :
+    gz_(gz),
+    nfaces_(nfaces),
+    nfaces_owned_(nfaces_owned),
+    ncells_owned_(cell_map.NumMyElements()),
+    importer_(cell_map_ghosted, cell_map)
+{
+  cfl_ = plist.get<double>("CFL", 0.5);
+  max_levels_ = plist.get<int>("maximum levels", 8);
+
+  Teuchos::ParameterList& model_plist = plist.sublist("overland conductivity model");
+  if (!model_plist.isParameter("Manning exponent"))
+    model_plist.set("Manning exponent", 2./3.);
+  model_ = Teuchos::rcp(new ManningConductivityModel(model_plist));
+
+  face_cells_.assign(2*nfaces_, -1);
+  face_dirs_.assign(nfaces_, 1);
+  face_area_.assign(nfaces_, 0.);
+  face_trans_.assign(nfaces_, 0.);
+  face_elev_.assign(nfaces_, 0.);
+  face_bc_.assign(nfaces_, BC_NONE);
+  face_bc_value_.assign(nfaces_, 0.);
+  level_faces_.resize(max_levels_+1);
+
+  int ncells = cell_map_ghosted.NumMyElements();
+  cell_nfaces_.assign(ncells, 0);
+  cell_capacity_.assign(ncells, 1.);
+  cell_mobile_.assign(ncells, 1.);
+  cell_elev_.assign(ncells, 0.);
+  cell_slope_.assign(ncells, 0.);
+  cell_coef_.assign(ncells, 1.);
+  cell_nl_.assign(ncells, 0.);
+
+  wc_ = Teuchos::rcp(new Epetra_Vector(cell_map_ghosted));
+  wc_owned_ = Teuchos::rcp(new Epetra_Vector(View, cell_map, wc_->Values()));
+  level_ = Teuchos::rcp(new Epetra_IntVector(cell_map_ghosted));
+  level_owned_ = Teuchos::rcp(new Epetra_IntVector(View, cell_map, level_->Values()));
+  flux_sum_.assign(nfaces_owned_, 0.);
+}
+
+
+void DiffusionWaveSubcycler::SetFace(int f, int c0, int c1, int dir, double area, double trans) {
+  face_cells_[2*f] = c0;
+  face_cells_[2*f+1] = c1;
+  face_dirs_[f] = dir;
+  face_area_[f] = area;
+  face_trans_[f] = trans;
+
+  cell_nfaces_[c0]++;
+  if (c1 >= 0) cell_nfaces_[c1]++;
+}
+
+
+void DiffusionWaveSubcycler::SetCellData(int c, double capacity, double nl, double elev,
+                                         double slope, double coef, double mobile) {
+  cell_capacity_[c] = capacity;
+  cell_nl_[c] = nl;
+  cell_elev_[c] = elev;
+  cell_slope_[c] = slope;
+  cell_coef_[c] = coef;
+  cell_mobile_[c] = mobile;
+}
+
+
+void DiffusionWaveSubcycler::StartStep(const Epetra_MultiVector& wc) {
+  for (int c=0; c!=ncells_owned_; ++c) (*wc_owned_)[c] = wc[0][c];
+  wc_->Import(*wc_owned_, importer_, Insert);
+  flux_sum_.assign(nfaces_owned_, 0.);
+}
+
+
+// -----------------------------------------------------------------------------
+// No flux across a face with no water on either side.
+// -----------------------------------------------------------------------------
+bool DiffusionWaveSubcycler::IsDry_(int f) const {
+  const Epetra_Vector& wc = *wc_;
+  int c0 = face_cells_[2*f];
+  int c1 = face_cells_[2*f+1];
+  return wc[c0] <= 0. && (c1 < 0 ? face_bc_[f] != BC_HEAD : wc[c1] <= 0.);
+}
+
+
+// -----------------------------------------------------------------------------
+// Upwinded two point flux, in [mol s^-1].
+//
+//   rate is the derivative of the flux's magnitude with respect to the head
+//   of the upwind cell, for the stability bound.
+// -----------------------------------------------------------------------------
+double DiffusionWaveSubcycler::FaceFlux(int f, double* rate) const {
+  const Epetra_Vector& wc = *wc_;
+  int c0 = face_cells_[2*f];
+  int c1 = face_cells_[2*f+1];
+
+  double h0 = std::max(wc[c0], 0.) / cell_capacity_[c0];
+  double H0 = h0 + cell_elev_[c0];
+
+  if (c1 >= 0) {
+    double h1 = std::max(wc[c1], 0.) / cell_capacity_[c1];
+    double H1 = h1 + cell_elev_[c1];
+    int up = H0 >= H1 ? c0 : c1;
+    double h_up = (up == c0 ? h0 : h1) * cell_mobile_[up];
+
+    double K = cell_nl_[up] * model_->Conductivity(h_up, cell_slope_[up], cell_coef_[up]);
+    double dK = cell_nl_[up] * model_->DConductivityDDepth(h_up, cell_slope_[up], cell_coef_[up]);
+    *rate = face_trans_[f] * (K + dK * std::abs(H0 - H1));
+    return K * face_trans_[f] * (H0 - H1);
+
+  } else if (face_bc_[f] == BC_HEAD) {
+    double hb = std::max(face_bc_value_[f], 0.);
+    double Hb = hb + face_elev_[f];
+    double h_up = H0 >= Hb ? h0 * cell_mobile_[c0] : hb;
+
+    double K = cell_nl_[c0] * model_->Conductivity(h_up, cell_slope_[c0], cell_coef_[c0]);
+    double dK = cell_nl_[c0] * model_->DConductivityDDepth(h_up, cell_slope_[c0], cell_coef_[c0]);
+    *rate = face_trans_[f] * (K + dK * std::abs(H0 - Hb));
+    return K * face_trans_[f] * (H0 - Hb);
+
+  } else if (face_bc_[f] == BC_CRITICAL_DEPTH) {
+    // v = sqrt(gzh), so q = n_liq * h * sqrt(gzh)
+    double h_mob = h0 * cell_mobile_[c0];
+    *rate = 1.5 * std::sqrt(gz_ * h_mob) * cell_nl_[c0] * face_area_[f];
+    return std::sqrt(gz_) * std::pow(h_mob, 1.5) * cell_nl_[c0] * face_area_[f];
+  }
+
+  *rate = 0.;
+  return 0.;
+}
+
+
+// -----------------------------------------------------------------------------
+// Local time step levels for the next cycle.
+// -----------------------------------------------------------------------------
+double DiffusionWaveSubcycler::ComputeLevels(double dt_remaining, int* nlevels) {
+  // rate of change of each owned cell's flux with its water content
+  std::vector<double> lambda(ncells_owned_, 0.);
+  for (int f=0; f!=nfaces_; ++f) {
+    if (IsDry_(f)) continue;
+    int c0 = face_cells_[2*f];
+    int c1 = face_cells_[2*f+1];
+
+    double rate;
+    FaceFlux(f, &rate);
+    if (c0 < ncells_owned_) lambda[c0] += rate / cell_capacity_[c0];
+    if (c1 >= 0 && c1 < ncells_owned_) lambda[c1] += rate / cell_capacity_[c1];
+  }
+
+  double lambda_max_l = 0.;
+  for (int c=0; c!=ncells_owned_; ++c) lambda_max_l = std::max(lambda_max_l, lambda[c]);
+  double lambda_max = 0.;
+  wc_->Comm().MaxAll(&lambda_max_l, &lambda_max, 1);
+
+  double dt_cycle = dt_remaining;
+  if (lambda_max > 0.)
+    dt_cycle = std::min(dt_remaining, std::ldexp(cfl_ / lambda_max, max_levels_));
+
+  // levels of cells
+  Epetra_IntVector& level = *level_owned_;
+  int nlevels_l = 0;
+  for (int c=0; c!=ncells_owned_; ++c) {
+    int l = 0;
+    if (lambda[c] > 0.) {
+      l = (int) std::ceil(std::log2(dt_cycle * lambda[c] / cfl_));
+      l = std::min(std::max(l, 0), max_levels_);
+    }
+    level[c] = l;
+    nlevels_l = std::max(nlevels_l, l);
+  }
+  wc_->Comm().MaxAll(&nlevels_l, nlevels, 1);
+  level_->Import(*level_owned_, importer_, Insert);
+
+  // each face takes the finer level of its cells
+  const Epetra_IntVector& level_g = *level_;
+  for (auto& faces : level_faces_) faces.clear();
+  for (int f=0; f!=nfaces_; ++f) {
+    int c0 = face_cells_[2*f];
+    int c1 = face_cells_[2*f+1];
+    int l = c1 < 0 ? level_g[c0] : std::max(level_g[c0], level_g[c1]);
+    level_faces_[l].push_back(f);
+  }
+  return dt_cycle;
+}
+
+
+// -----------------------------------------------------------------------------
+// One substep of a cycle.
+//
+//   A face of level l is due every 2^(nlevels - l) substeps, and its flux is
+//   applied for that long.  All fluxes of a substep are computed from the
+//   same state.
+// -----------------------------------------------------------------------------
+int DiffusionWaveSubcycler::Substep(int k, int nlevels, double dt_sub) {
+  Epetra_Vector& wc = *wc_;
+
+  due_faces_.clear();
+  due_amounts_.clear();
+  for (int l=0; l<=nlevels; ++l) {
+    int stride = 1 << (nlevels - l);
+    if (k % stride) continue;
+
+    for (auto f : level_faces_[l]) {
+      if (IsDry_(f)) continue;
+      int c0 = face_cells_[2*f];
+      int c1 = face_cells_[2*f+1];
+
+      double rate;
+      double amount = FaceFlux(f, &rate) * dt_sub * stride;
+
+      // limit the outflow so that water content stays non-negative
+      if (amount > 0.) {
+        amount = std::min(amount, std::max(wc[c0], 0.) / cell_nfaces_[c0]);
+      } else if (c1 >= 0) {
+        amount = -std::min(-amount, std::max(wc[c1], 0.) / cell_nfaces_[c1]);
+      }
+      due_faces_.push_back(f);
+      due_amounts_.push_back(amount);
+    }
+  }
+
+  // apply them
+  for (int i=0; i!=(int) due_faces_.size(); ++i) {
+    int f = due_faces_[i];
+    double amount = due_amounts_[i];
+    int c0 = face_cells_[2*f];
+    int c1 = face_cells_[2*f+1];
+    if (c0 < ncells_owned_) wc[c0] -= amount;
+    if (c1 >= 0 && c1 < ncells_owned_) wc[c1] += amount;
+    if (f < nfaces_owned_) flux_sum_[f] += face_dirs_[f] * amount;
+  }
+  wc_->Import(*wc_owned_, importer_, Insert);
+  return due_faces_.size();
+}
+
+} // namespace Flow
+} // namespace Amanzi
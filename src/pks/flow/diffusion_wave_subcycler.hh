@@ -0,0 +1,158 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Explicit, locally time stepped, two point flux diffusion wave on water content.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*
+
+The kernel of the `"overland flow, diffusion wave`" PK, on flat arrays so that
+it does not depend on State.  Cells are numbered as in the ghosted cell map,
+owned cells first; faces are numbered by the caller, owned faces first, and
+must include all faces of ghost cells.
+
+A step is taken as:
+
+.. code-block:: c++
+
+    subcycler.StartStep(wc);
+    while (t < t_new) {
+      int nlevels;
+      double dt_cycle = subcycler.ComputeLevels(t_new - t, &nlevels);
+      double dt_sub = dt_cycle / (1 << nlevels);
+      for (int k=0; k!=(1 << nlevels); ++k) {
+        // set boundary conditions at t + k*dt_sub
+        subcycler.Substep(k, nlevels, dt_sub);
+      }
+      t += dt_cycle;
+    }
+
+Faces are bucketed by level in ComputeLevels(), so that a substep visits only
+the faces due at it.
+
+*/
+
+#ifndef PK_FLOW_DIFFUSION_WAVE_SUBCYCLER_HH_
+#define PK_FLOW_DIFFUSION_WAVE_SUBCYCLER_HH_
+
+#include <vector>
+
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Epetra_Map.h"
+#include "Epetra_Import.h"
+#include "Epetra_MultiVector.h"
+#include "Epetra_Vector.h"
+#include "Epetra_IntVector.h"
+
+namespace Amanzi {
+namespace Flow {
+
+class ManningConductivityModel;
+
+class DiffusionWaveSubcycler {
+
+ public:
+  enum BCType {
+    BC_NONE = 0,
+    BC_HEAD,
+    BC_CRITICAL_DEPTH
+  };
+
+  // plist holds "CFL", "maximum levels", and the "overland conductivity
+  // model" sublist.
+  DiffusionWaveSubcycler(Teuchos::ParameterList& plist,
+                         const Epetra_Map& cell_map,
+                         const Epetra_Map& cell_map_ghosted,
+                         int nfaces, int nfaces_owned, double gz);
+
+  // Geometry of a face: its cells, the second -1 on the boundary, the
+  // direction of its normal relative to the first cell, its area, and area /
+  // distance between cell centers (or to the face, on the boundary).
+  void SetFace(int f, int c0, int c1, int dir, double area, double trans);
+
+  // Data held fixed over a step: n_l |V|, n_l, elevation, slope magnitude,
+  // Manning coefficient, and mobile (unfrozen) fraction.
+  void SetCellData(int c, double capacity, double nl, double elev,
+                   double slope, double coef, double mobile);
+  void SetFaceElevation(int f, double elev) { face_elev_[f] = elev; }
+
+  // Boundary condition of a face; the value of a head condition is a ponded
+  // depth.
+  void SetBoundaryCondition(int f, BCType type, double value=0.) {
+    face_bc_[f] = type;
+    face_bc_value_[f] = value;
+  }
+
+  // Starts a step from the owned water content, zeroing the flux sums.
+  void StartStep(const Epetra_MultiVector& wc);
+
+  // Assigns levels to cells and buckets faces by level, returning the size
+  // of the next cycle and setting nlevels to its number of levels.
+  // Collective.
+  double ComputeLevels(double dt_remaining, int* nlevels);
+
+  // Substep k of a cycle of 2^nlevels substeps, returning the number of
+  // face fluxes computed.  Collective.
+  int Substep(int k, int nlevels, double dt_sub);
+
+  // Water content, owned and ghost cells.
+  const Epetra_Vector& water_content() const { return *wc_; }
+
+  // Sum over the step of the amount moved across an owned face, in the
+  // direction of its normal, in [mol].
+  double flux_sum(int f) const { return flux_sum_[f]; }
+
+  // Upwinded two point flux, from the face's first cell to its second or out
+  // of the domain, in [mol s^-1], and the derivative of its magnitude with
+  // respect to the head of the upwind cell.
+  double FaceFlux(int f, double* rate) const;
+
+ protected:
+  bool IsDry_(int f) const;
+
+ protected:
+  double cfl_;
+  int max_levels_;
+  double gz_;
+  Teuchos::RCP<ManningConductivityModel> model_;
+
+  int nfaces_, nfaces_owned_;
+  int ncells_owned_;
+
+  // faces
+  std::vector<int> face_cells_;   // two per face
+  std::vector<int> face_dirs_;
+  std::vector<double> face_area_;
+  std::vector<double> face_trans_;
+  std::vector<double> face_elev_;
+  std::vector<int> face_bc_;
+  std::vector<double> face_bc_value_;
+  std::vector<std::vector<int> > level_faces_;
+
+  // faces due in a substep, and their amounts
+  std::vector<int> due_faces_;
+  std::vector<double> due_amounts_;
+
+  // cells, owned and ghost
+  std::vector<int> cell_nfaces_;
+  std::vector<double> cell_capacity_;
+  std::vector<double> cell_mobile_;
+  std::vector<double> cell_elev_, cell_slope_, cell_coef_, cell_nl_;
+
+  // ghosted vectors, and views of their owned entries
+  Epetra_Import importer_;
+  Teuchos::RCP<Epetra_Vector> wc_, wc_owned_;
+  Teuchos::RCP<Epetra_IntVector> level_, level_owned_;
+  std::vector<double> flux_sum_;
+};
+
+}  // namespace Flow
+}  // namespace Amanzi
+
+#endif
@@ -62,8 +62,7 @@ Interfrost::UpdatePreconditioner(double t,
   UpdatePermeabilityDerivativeData_(S_next_.ptr());
 
   // update boundary conditions
-  bc_pressure_->Compute(S_next_->time());
-  bc_flux_->Compute(S_next_->time());
+  ComputeBoundaryConditions_(S_next_->time());
   UpdateBoundaryConditions_(S_next_.ptr());
 
   Teuchos::RCP<const CompositeVector> rel_perm =
@@ -0,0 +1,297 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -----------------------------------------------------------------------------
+This is the explicit, locally time stepped, overland flow component of ATS.
+License: BSD
+Author: Ethan Coon (ecoon@lanl.gov)
+----------------------------------------------------------------------------- */
+
+#include <algorithm>
+
+#include "Epetra_MultiVector.h"
+
+#include "State.hh"
+
+#include "flow_bc_factory.hh"
+#include "meshed_elevation_evaluator.hh"
+#include "standalone_elevation_evaluator.hh"
+#include "diffusion_wave_subcycler.hh"
+#include "overland_diffusion_wave.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+OverlandDiffusionWave::OverlandDiffusionWave(Teuchos::ParameterList& pk_tree,
+                                             const Teuchos::RCP<Teuchos::ParameterList>& plist,
+                                             const Teuchos::RCP<State>& S,
+                                             const Teuchos::RCP<TreeVector>& solution) :
+    PK(pk_tree, plist, S, solution),
+    PK_Physical_Default(pk_tree, plist, S, solution)
+{
+  dt_max_ = plist_->get<double>("max time step [s]", 1.e99);
+
+  wc_key_ = Keys::readKey(*plist_, domain_, "conserved quantity", "water_content");
+  wc_bar_key_ = Keys::getKey(domain_, "water_content_bar");
+  cv_key_ = Keys::readKey(*plist_, domain_, "cell volume", "cell_volume");
+  nl_key_ = Keys::readKey(*plist_, domain_, "molar density liquid", "molar_density_liquid");
+  elev_key_ = Keys::readKey(*plist_, domain_, "elevation", "elevation");
+  slope_key_ = Keys::readKey(*plist_, domain_, "slope magnitude", "slope_magnitude");
+  coef_key_ = Keys::readKey(*plist_, domain_, "manning coefficient", "manning_coefficient");
+  uf_key_ = Keys::readKey(*plist_, domain_, "unfrozen fraction", "unfrozen_fraction");
+  flux_key_ = Keys::getKey(domain_, "mass_flux");
+}
+
+
+// -------------------------------------------------------------
+// Setup data
+// -------------------------------------------------------------
+void OverlandDiffusionWave::Setup(const Teuchos::Ptr<State>& S) {
+  PK_Physical_Default::Setup(S);
+
+  // boundary conditions
+  Teuchos::ParameterList bc_plist = plist_->sublist("boundary conditions");
+  for (const auto& entry : bc_plist) {
+    if (entry.first != "head" && entry.first != "critical depth") {
+      Errors::Message message;
+      message << name_ << ": boundary condition \"" << entry.first << "\" is not supported, "
+              << "only \"head\" and \"critical depth\" are.";
+      Exceptions::amanzi_throw(message);
+    }
+  }
+  FlowBCFactory bc_factory(mesh_, bc_plist);
+  bc_head_ = bc_factory.CreateHead();
+  bc_critical_depth_ = bc_factory.CreateCriticalDepth();
+
+  S->RequireGravity();
+  S->RequireScalar("atmospheric_pressure");
+
+  // primary variable
+  S->RequireField(key_, name_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1)
+      ->AddComponent("boundary_face", AmanziMesh::BOUNDARY_FACE, 1);
+
+  // water content, and water content bar (can be negative) for its
+  // derivative with respect to pressure
+  Teuchos::ParameterList wc_bar_list = S->FEList().sublist(wc_key_);
+  wc_bar_list.set("allow negative water content", true);
+  wc_bar_list.setName(wc_bar_key_);
+  S->FEList().set(wc_bar_key_, wc_bar_list);
+
+  S->RequireField(wc_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1);
+  S->RequireFieldEvaluator(wc_key_);
+  S->RequireField(wc_bar_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1);
+  S->RequireFieldEvaluator(wc_bar_key_);
+
+  // other data held fixed over the step
+  S->RequireField(cv_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1);
+  S->RequireFieldEvaluator(cv_key_);
+  S->RequireField(nl_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1);
+  S->RequireFieldEvaluator(nl_key_);
+  S->RequireField(coef_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1);
+  S->RequireFieldEvaluator(coef_key_);
+
+  std::vector<AmanziMesh::Entity_kind> locations2(2);
+  std::vector<std::string> names2(2);
+  std::vector<int> num_dofs2(2, 1);
+  locations2[0] = AmanziMesh::CELL;
+  locations2[1] = AmanziMesh::FACE;
+  names2[0] = "cell";
+  names2[1] = "face";
+
+  S->RequireField(elev_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponents(names2, locations2, num_dofs2);
+  S->RequireField(slope_key_)->SetMesh(mesh_)->SetGhosted()
+      ->AddComponent("cell", AmanziMesh::CELL, 1);
+  if (S->FEList().isSublist(elev_key_)) {
+    S->RequireFieldEvaluator(elev_key_);
+    S->RequireFieldEvaluator(slope_key_);
+  } else {
+    Teuchos::ParameterList elev_plist = plist_->sublist("elevation evaluator");
+    elev_plist.set("evaluator name", elev_key_);
+    Teuchos::RCP<ElevationEvaluator> elev_evaluator;
+    if (S->GetMesh() == mesh_) {
+      elev_evaluator = Teuchos::rcp(new StandaloneElevationEvaluator(elev_plist));
+    } else {
+      elev_evaluator = Teuchos::rcp(new MeshedElevationEvaluator(elev_plist));
+    }
+    S->SetFieldEvaluator(elev_key_, elev_evaluator);
+    S->SetFieldEvaluator(slope_key_, elev_evaluator);
+  }
+
+  // fluxes, averaged over the step
+  S->RequireField(flux_key_, name_)->SetMesh(mesh_)->SetGhosted()
+      ->SetComponent("face", AmanziMesh::FACE, 1);
+}
+
+
+// -------------------------------------------------------------
+// Initialize owned (dependent) variables.
+// -------------------------------------------------------------
+void OverlandDiffusionWave::Initialize(const Teuchos::Ptr<State>& S) {
+  PK_Physical_Default::Initialize(S);
+  DeriveFaceValuesFromCellValues_(S->GetFieldData(key_, name_).ptr());
+
+  S->GetFieldData(flux_key_, name_)->PutScalar(0.);
+  S->GetField(flux_key_, name_)->set_initialized();
+
+  double gz = -(*S->GetConstantVectorData("gravity"))[2];
+  int nfaces = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  subcycler_ = Teuchos::rcp(new DiffusionWaveSubcycler(*plist_, mesh_->cell_map(false),
+          mesh_->cell_map(true), nfaces, nfaces_owned, gz));
+  InitializeFaces_();
+}
+
+
+// -----------------------------------------------------------------------------
+// Two point flux geometry, computed once.
+// -----------------------------------------------------------------------------
+void OverlandDiffusionWave::InitializeFaces_() {
+  int nfaces = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+
+  AmanziMesh::Entity_ID_List cells;
+  for (int f=0; f!=nfaces; ++f) {
+    mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
+    std::sort(cells.begin(), cells.end());
+
+    int dir;
+    mesh_->face_normal(f, false, cells[0], &dir);
+    double area = mesh_->face_area(f);
+
+    const AmanziGeometry::Point& x0 = mesh_->cell_centroid(cells[0]);
+    double dist = cells.size() > 1 ?
+        AmanziGeometry::norm(mesh_->cell_centroid(cells[1]) - x0) :
+        AmanziGeometry::norm(mesh_->face_centroid(f) - x0);
+    subcycler_->SetFace(f, cells[0], cells.size() > 1 ? cells[1] : -1, dir, area, area / dist);
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Cell data, at the start of the step.
+// -----------------------------------------------------------------------------
+void OverlandDiffusionWave::UpdateCellData_(const Teuchos::Ptr<State>& S) {
+  std::vector<Key> keys = { cv_key_, nl_key_, elev_key_, slope_key_, coef_key_ };
+  for (const auto& key : keys) {
+    S->GetFieldEvaluator(key)->HasFieldChanged(S, name_);
+    S->GetFieldData(key)->ScatterMasterToGhosted();
+  }
+
+  const Epetra_MultiVector& cv = *S->GetFieldData(cv_key_)->ViewComponent("cell",true);
+  const Epetra_MultiVector& nl = *S->GetFieldData(nl_key_)->ViewComponent("cell",true);
+  const Epetra_MultiVector& elev = *S->GetFieldData(elev_key_)->ViewComponent("cell",true);
+  const Epetra_MultiVector& elev_f = *S->GetFieldData(elev_key_)->ViewComponent("face",true);
+  const Epetra_MultiVector& slope = *S->GetFieldData(slope_key_)->ViewComponent("cell",true);
+  const Epetra_MultiVector& coef = *S->GetFieldData(coef_key_)->ViewComponent("cell",true);
+
+  const Epetra_MultiVector* uf = nullptr;
+  if (S->HasField(uf_key_)) {
+    if (S->HasFieldEvaluator(uf_key_))
+      S->GetFieldEvaluator(uf_key_)->HasFieldChanged(S, name_);
+    S->GetFieldData(uf_key_)->ScatterMasterToGhosted("cell");
+    uf = S->GetFieldData(uf_key_)->ViewComponent("cell",true).get();
+  }
+
+  int ncells = cv.MyLength();
+  for (int c=0; c!=ncells; ++c) {
+    subcycler_->SetCellData(c, nl[0][c] * cv[0][c], nl[0][c], elev[0][c],
+                            slope[0][c], coef[0][c], uf ? (*uf)[0][c] : 1.);
+  }
+  for (int f=0; f!=elev_f.MyLength(); ++f) subcycler_->SetFaceElevation(f, elev_f[0][f]);
+}
+
+
+// -----------------------------------------------------------------------------
+// Boundary conditions at time t.  The faces of each condition do not change.
+// -----------------------------------------------------------------------------
+void OverlandDiffusionWave::UpdateBoundaryConditions_(double t) {
+  bc_head_->Compute(t);
+  for (const auto& bc : *bc_head_) {
+    subcycler_->SetBoundaryCondition(bc.first, DiffusionWaveSubcycler::BC_HEAD, bc.second);
+  }
+
+  bc_critical_depth_->Compute(t);
+  for (const auto& bc : *bc_critical_depth_) {
+    subcycler_->SetBoundaryCondition(bc.first, DiffusionWaveSubcycler::BC_CRITICAL_DEPTH);
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Advance from t_old to t_new.
+// -----------------------------------------------------------------------------
+bool OverlandDiffusionWave::AdvanceStep(double t_old, double t_new, bool reinit) {
+  double dt = t_new - t_old;
+  Teuchos::OSTab tab = vo_->getOSTab();
+  if (vo_->os_OK(Teuchos::VERB_HIGH))
+    *vo_->os() << "----------------------------------------------------------------" << std::endl
+               << "Advancing: t0 = " << t_old << " t1 = " << t_new << " h = " << dt << std::endl
+               << "----------------------------------------------------------------" << std::endl;
+
+  // data at the start of the step
+  UpdateCellData_(S_inter_.ptr());
+  S_inter_->GetFieldEvaluator(wc_key_)->HasFieldChanged(S_inter_.ptr(), name_);
+  subcycler_->StartStep(*S_inter_->GetFieldData(wc_key_)->ViewComponent("cell",false));
+
+  // cycles of substeps, with boundary conditions at the start of each
+  double t = t_old;
+  int ncycles = 0;
+  int max_nlevels = 0;
+  long nupdates = 0;
+  while (t_new - t > 1.e-10 * dt) {
+    UpdateBoundaryConditions_(t);
+    int nlevels = 0;
+    double dt_cycle = subcycler_->ComputeLevels(t_new - t, &nlevels);
+    int nsub = 1 << nlevels;
+    double dt_sub = dt_cycle / nsub;
+
+    for (int k=0; k!=nsub; ++k) {
+      if (k > 0) UpdateBoundaryConditions_(t + k * dt_sub);
+      nupdates += subcycler_->Substep(k, nlevels, dt_sub);
+    }
+
+    t += dt_cycle;
+    ncycles++;
+    max_nlevels = std::max(max_nlevels, nlevels);
+  }
+
+  if (vo_->os_OK(Teuchos::VERB_MEDIUM))
+    *vo_->os() << "  " << ncycles << " cycles, max level " << max_nlevels
+               << ", " << nupdates << " face updates" << std::endl;
+
+  // the average flux
+  Epetra_MultiVector& flux = *S_next_->GetFieldData(flux_key_, name_)->ViewComponent("face",false);
+  for (int f=0; f!=flux.MyLength(); ++f) flux[0][f] = subcycler_->flux_sum(f) / dt;
+
+  // pressure from the new water content, through dWC_bar/dp at the start of
+  // the step.  Cells that are dry at the end of the step keep their pressure
+  // if it was below atmospheric.
+  S_inter_->GetFieldEvaluator(wc_bar_key_)->HasFieldDerivativeChanged(S_inter_.ptr(), name_, key_);
+  const Epetra_MultiVector& dwc_dp = *S_inter_->GetFieldData(Keys::getDerivKey(wc_bar_key_, key_))
+      ->ViewComponent("cell",false);
+  const Epetra_MultiVector& pres_old = *S_inter_->GetFieldData(key_)->ViewComponent("cell",false);
+  const double& p_atm = *S_next_->GetScalarData("atmospheric_pressure");
+  const Epetra_Vector& wc = subcycler_->water_content();
+
+  Teuchos::RCP<CompositeVector> pres = S_next_->GetFieldData(key_, name_);
+  Epetra_MultiVector& pres_c = *pres->ViewComponent("cell",false);
+  for (int c=0; c!=pres_c.MyLength(); ++c) {
+    pres_c[0][c] = wc[c] > 0. ? p_atm + wc[c] / dwc_dp[0][c] : std::min(pres_old[0][c], p_atm);
+  }
+  DeriveFaceValuesFromCellValues_(pres.ptr());
+  solution_evaluator_->SetFieldAsChanged(S_next_.ptr());
+
+  if (debugging_) {
+    db_->WriteCellInfo(true);
+    db_->WriteVector("p_new", pres.ptr());
+  }
+  return false;
+}
+
+} // namespace Flow
+} // namespace Amanzi
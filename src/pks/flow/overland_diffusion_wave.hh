@@ -0,0 +1,176 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Overland flow using an explicit diffusion wave scheme with local time stepping.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+
+/*!
+
+Solves the same diffusion wave equation as the `Overland Flow PK`_, without
+sources,
+
+.. math::
+  \frac{\partial \Theta}{\partial t} - \nabla n_l k \nabla (h + z) = 0
+
+but explicitly, on water content, with a two point flux finite volume scheme
+and Manning's conductivity upwinded by the head :math:`h + z`.  This PK never
+fails; instead it subcycles within the step it is given, so it may replace an
+implicit overland flow solve that fails to converge, e.g. during snowmelt.
+It is not yet supported as the "star" system of the operator split couplers.
+
+The step is advanced in cycles.  Each cell has a stable step size
+:math:`\Delta t_c = CFL / \lambda_c`, where :math:`\lambda_c` is the rate of
+change of the cell's outgoing flux with its head, relative to its water
+content.  A cycle is at most :math:`2^{L}` times the smallest of these, for a
+maximum level :math:`L`.  Within a cycle, each cell is assigned the level
+:math:`l_c` such that :math:`\Delta t_{cycle} / 2^{l_c} \le \Delta t_c`, and
+each face takes the finer level of its two cells.  The cycle is taken in
+:math:`2^{max(l_c)}` substeps; the flux on a face of level :math:`l` is
+recomputed every :math:`2^{max(l_c) - l}` substeps and applied for that
+long.  Faces are kept in a list per level, so a substep visits only the faces
+due at it, and faces among slowly varying or dry cells are updated rarely or
+not at all.  Each face flux is added to one cell and removed from the other, so the
+scheme conserves water exactly, and the outflow across a face in a substep
+is limited to a share of the upwind cell's water, so water content stays
+non-negative.
+
+Ponded depth is water content divided by :math:`n_l |V|`, the liquid
+equivalent depth; if an unfrozen fraction is available, only that fraction of
+it is mobile.  At the end of the step the primary variable is set from the
+new water content through the derivative of `"water_content_bar`" at the
+start of the step, which is exact while the density does not change.  Cells
+that are dry at the end of the step keep their pressure if it was below
+atmospheric, and are set to atmospheric pressure if they drained.  The
+`"mass_flux`" on faces is the average over the step, and so may be used by a
+surface energy PK advecting energy.
+
+Boundary conditions are zero flux, except for `"head`" (Dirichlet) and
+`"critical depth`" (outflow) conditions.  They are evaluated at the start of
+each substep.
+
+.. _overland-diffusion-wave-spec:
+.. admonition:: overland-diffusion-wave-spec
+
+    * `"domain`" ``[string]`` **"surface"**
+
+    * `"primary variable`" ``[string]`` The primary variable associated with
+      this PK, typically `"DOMAIN-pressure`".
+
+    * `"boundary conditions`" ``[surface-flow-bc-spec]`` Only `"head`" and
+      `"critical depth`" conditions are supported.  Defaults to 0 normal flux.
+
+    * `"CFL`" ``[double]`` **0.5** Fraction of the stable step size of each
+      cell used.
+
+    * `"maximum levels`" ``[int]`` **8** Maximum number of times a cycle is
+      halved for the fastest cells.
+
+    * `"max time step [s]`" ``[double]`` **1.e99** Largest step size this PK
+      accepts.  As it subcycles, it does not usually limit the step size.
+
+    * `"overland conductivity model`" ``[list]`` Parameters of Manning's
+      model, `"Manning exponent`" **2/3** and `"slope regularization
+      epsilon`" **1.e-8**.
+
+    * `"unfrozen fraction key`" ``[string]`` **DOMAIN-unfrozen_fraction**
+      Used if it is a field of the state.
+
+    INCLUDES:
+
+    - ``[pk-physical-default-spec]`` A `PK: Physical`_ spec.
+
+    EVALUATORS:
+
+    - `"water_content`"
+    - `"water_content_bar`"
+    - `"molar_density_liquid`"
+    - `"cell_volume`"
+    - `"elevation`"
+    - `"slope_magnitude`"
+    - `"manning_coefficient`"
+
+*/
+
+
+#ifndef PK_FLOW_OVERLAND_DIFFUSION_WAVE_HH_
+#define PK_FLOW_OVERLAND_DIFFUSION_WAVE_HH_
+
+#include "BoundaryFunction.hh"
+
+#include "PK_Factory.hh"
+#include "pk_physical_default.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+class DiffusionWaveSubcycler;
+
+class OverlandDiffusionWave : public PK_Physical_Default {
+
+ public:
+
+  OverlandDiffusionWave(Teuchos::ParameterList& pk_tree,
+                        const Teuchos::RCP<Teuchos::ParameterList>& global_list,
+                        const Teuchos::RCP<State>& S,
+                        const Teuchos::RCP<TreeVector>& solution);
+
+  // Virtual destructor
+  virtual ~OverlandDiffusionWave() {}
+
+  // -- Setup data
+  virtual void Setup(const Teuchos::Ptr<State>& S);
+
+  // -- Initialize owned (dependent) variables.
+  virtual void Initialize(const Teuchos::Ptr<State>& S);
+
+  // -- Commit any secondary (dependent) variables.
+  virtual void CommitStep(double t_old, double t_new, const Teuchos::RCP<State>& S) {}
+
+  // -- Update diagnostics for vis.
+  virtual void CalculateDiagnostics(const Teuchos::RCP<State>& S) {}
+
+  // -- Advance from t_old to t_new, subcycling as needed.  Never fails.
+  virtual bool AdvanceStep(double t_old, double t_new, bool reinit);
+
+  virtual double get_dt() { return dt_max_; }
+  virtual void set_dt(double dt) {}
+
+ protected:
+  // geometry of all faces, including ghosts
+  void InitializeFaces_();
+
+  // physical data held fixed over a step
+  void UpdateCellData_(const Teuchos::Ptr<State>& S);
+
+  // boundary conditions, evaluated at each substep
+  void UpdateBoundaryConditions_(double t);
+
+ protected:
+  Key wc_key_, wc_bar_key_;
+  Key cv_key_, nl_key_;
+  Key elev_key_, slope_key_, coef_key_;
+  Key uf_key_;
+  Key flux_key_;
+
+  double dt_max_;
+
+  Teuchos::RCP<Functions::BoundaryFunction> bc_head_;
+  Teuchos::RCP<Functions::BoundaryFunction> bc_critical_depth_;
+
+  Teuchos::RCP<DiffusionWaveSubcycler> subcycler_;
+
+ private:
+  // factory registration
+  static RegisteredPKFactory<OverlandDiffusionWave> reg_;
+};
+
+}  // namespace Flow
+}  // namespace Amanzi
+
+#endif
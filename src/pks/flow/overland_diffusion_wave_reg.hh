@@ -0,0 +1,18 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -----------------------------------------------------------------------------
+This is the explicit, locally time stepped, overland flow component of ATS.
+License: BSD
+Author: Ethan Coon (ecoon@lanl.gov)
+----------------------------------------------------------------------------- */
+
+#include "overland_diffusion_wave.hh"
+
+namespace Amanzi {
+namespace Flow {
+
+RegisteredPKFactory<OverlandDiffusionWave> OverlandDiffusionWave::reg_("overland flow, explicit diffusion wave");
+
+
+} // namespace
+} // namespace
@@ -79,6 +79,16 @@ Solves the diffusion wave equation for overland flow with pressure as a primary
 
     * `"min ponded depth for tidal bc`" ``[double]`` **0.02** Control on the
       tidal boundary condition.  TODO: This should live in the BC spec?
+
+    * `"active set`" ``[bool]`` **false** Upwind the conductivity only on
+      faces next to a ponded cell, one with nonzero overland conductivity, or
+      on a boundary with nonzero conductivity.  Conductivity and its
+      derivative vanish on all other faces, so the result is the same as
+      upwinding on all faces, and is cheaper when most of the surface is dry.
+      The active set is recomputed whenever the ponded depth changes.  Only
+      the upwinding is restricted: the residual, the preconditioner, and the
+      linear solve still cover all cells, as the diffusion operators are
+      assembled on the full mesh.
       
     INCLUDES:
     
@@ -205,6 +215,9 @@ public:
                        Teuchos::RCP<const TreeVector> u,
                        Teuchos::RCP<TreeVector> du);
 
+  // -- storage used by operators, for memory reporting
+  virtual void OperatorMemory(std::map<std::string,double>& bytes) const override;
+
 protected:
   // setup methods
   virtual void SetupOverlandFlow_(const Teuchos::Ptr<State>& S);
@@ -225,6 +238,7 @@ protected:
   // -- builds tensor K, along with faced-based Krel if needed by the rel-perm method
   virtual bool UpdatePermeabilityDerivativeData_(const Teuchos::Ptr<State>& S);
   virtual bool UpdatePermeabilityData_(const Teuchos::Ptr<State>& S);
+  void UpdateActiveSet_(const Teuchos::Ptr<State>& S);
 
   // physical methods
   // -- diffusion term
@@ -279,6 +293,8 @@ protected:
   // work data space
   Teuchos::RCP<Operators::Upwinding> upwinding_;
   Teuchos::RCP<Operators::Upwinding> upwinding_dkdp_;
+  Teuchos::RCP<std::vector<int> > active_faces_;
+  int ncells_active_;
 
   // mathematical operators
   Teuchos::RCP<Operators::Operator> matrix_; // pc in PKPhysicalBDFBase
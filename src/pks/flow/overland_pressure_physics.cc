@@ -67,7 +67,7 @@ void OverlandPressureFlow::AddAccumulation_(const Teuchos::Ptr<CompositeVector>&
   Teuchos::RCP<const CompositeVector> wc0 =
       S_inter_->GetFieldData(conserved_key_);
 
-  if (vo_->os_OK(Teuchos::VERB_HIGH)) {
+  if (debugging_) {
     std::vector<std::string> vnames;
     std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
     vnames.push_back("  WC_old"); vnames.push_back("  WC_new");
@@ -89,7 +89,7 @@ void OverlandPressureFlow::AddSourceTerms_(const Teuchos::Ptr<CompositeVector>&
   Epetra_MultiVector& g_c = *g->ViewComponent("cell",false);
 
   const Epetra_MultiVector& cv1 =
-    *S_next_->GetFieldData(Keys::getKey(domain_,"cell_volume"))->ViewComponent("cell",false);
+    *S_next_->GetFieldData(cell_vol_key_)->ViewComponent("cell",false);
 
   if (is_source_term_) {
     // Add in external source term.
@@ -97,7 +97,7 @@ void OverlandPressureFlow::AddSourceTerms_(const Teuchos::Ptr<CompositeVector>&
         ->HasFieldChanged(S_next_.ptr(), name_);
     const Epetra_MultiVector& source1 =
         *S_next_->GetFieldData(source_key_)->ViewComponent("cell",false);
-    db_->WriteVector("mass source", S_next_->GetFieldData(source_key_).ptr(), false);
+    if (debugging_) db_->WriteVector("mass source", S_next_->GetFieldData(source_key_).ptr(), false);
 
     if (source_in_meters_) {
       // External source term is in [m water / s], not in [mols / s], so a
@@ -5,6 +5,8 @@ This is the overland flow component of ATS.
 License: BSD
 Author: Ethan Coon (ecoon@lanl.gov)
 ----------------------------------------------------------------------------- */
+#include <algorithm>
+
 #include "Teuchos_LAPACK.hpp"
 #include "Teuchos_SerialDenseMatrix.hpp"
 
@@ -38,6 +40,7 @@ Author: Ethan Coon (ecoon@lanl.gov)
 //#include "overland_source_from_subsurface_flux_evaluator.hh"
 
 #include "UpwindFluxFactory.hh"
+#include "mesh_topology.hh"
 
 #include "PDE_DiffusionFactory.hh"
 
@@ -67,7 +70,8 @@ OverlandPressureFlow::OverlandPressureFlow(Teuchos::ParameterList& pk_tree,
     jacobian_(false),
     jacobian_lag_(0),
     iter_(0),
-    iter_counter_time_(0.)
+    iter_counter_time_(0.),
+    ncells_active_(0)
 {
   if(!plist_->isParameter("conserved quantity key suffix"))
     plist_->set("conserved quantity key suffix", "water_content");
@@ -274,6 +278,13 @@ void OverlandPressureFlow::SetupOverlandFlow_(const Teuchos::Ptr<State>& S) {
     }
   }
 
+  // -- restrict upwinding to the faces next to ponded water
+  if (plist_->get<bool>("active set", false)) {
+    active_faces_ = Teuchos::rcp(new std::vector<int>());
+    upwinding_->SetActiveFaces(active_faces_);
+    if (upwinding_dkdp_ != Teuchos::null) upwinding_dkdp_->SetActiveFaces(active_faces_);
+  }
+
   // -- coupling to subsurface
   coupled_to_subsurface_via_flux_ =
       plist_->get<bool>("coupled to subsurface via flux", false);
@@ -758,16 +769,79 @@ bool OverlandPressureFlow::UpdatePermeabilityData_(const Teuchos::Ptr<State>& S)
     }
 
     // -- upwind
+    if (active_faces_ != Teuchos::null) UpdateActiveSet_(S);
     upwinding_->Update(S);
     uw_cond->ScatterMasterToGhosted("face");
   }
 
-  if (update_perm && vo_->os_OK(Teuchos::VERB_EXTREME))
+  if (update_perm && vo_->os_OK(Teuchos::VERB_EXTREME)) {
     *vo_->os() << " TRUE." << std::endl;
+    if (active_faces_ != Teuchos::null) {
+      int ncells_owned = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+      int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+      int counts_l[4] = { ncells_active_, ncells_owned,
+                          (int) active_faces_->size(), nfaces_owned };
+      int counts[4];
+      mesh_->get_comm()->SumAll(counts_l, counts, 4);
+      *vo_->os() << "    active set: " << counts[0] << " of " << counts[1] << " cells, "
+                 << counts[2] << " of " << counts[3] << " faces" << std::endl;
+    }
+  }
   return update_perm;
 }
 
 
+// -----------------------------------------------------------------------------
+// Find the faces on which the upwinded conductivity may be nonzero.
+//
+//   These are the faces of ponded cells, and boundary faces with nonzero
+//   conductivity.  Their cells, counted for reporting, are the ponded cells
+//   plus a one-cell halo; all other cells are dry and decoupled from their
+//   neighbors.
+// -----------------------------------------------------------------------------
+void OverlandPressureFlow::UpdateActiveSet_(const Teuchos::Ptr<State>& S) {
+  Teuchos::RCP<const CompositeVector> cond = S->GetFieldData(Keys::getKey(domain_,"overland_conductivity"));
+  cond->ScatterMasterToGhosted("cell");
+  const Epetra_MultiVector& cond_c = *cond->ViewComponent("cell",true);
+  const Epetra_MultiVector& cond_bf = *cond->ViewComponent("boundary_face",false);
+
+  const MeshTopology& topo = MeshTopology::Get(mesh_);
+  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  int ncells_owned = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::OWNED);
+
+  std::vector<int>& active = *active_faces_;
+  active.clear();
+  for (int f=0; f!=nfaces_owned; ++f) {
+    int bf = topo.face_boundary_face(f);
+    bool wet = bf >= 0 && cond_bf[0][bf] > 0.;
+
+    const AmanziMesh::Entity_ID* cells = topo.face_cells(f);
+    for (int n=0; n!=topo.face_num_cells(f); ++n) wet |= cond_c[0][cells[n]] > 0.;
+    if (wet) active.push_back(f);
+  }
+
+  // A cell is active if any of its faces is.  Faces owned by another rank
+  // are active if either of their cells is ponded.
+  std::vector<bool> active_cell(ncells_owned, false);
+  for (auto f : active) {
+    const AmanziMesh::Entity_ID* cells = topo.face_cells(f);
+    for (int n=0; n!=topo.face_num_cells(f); ++n)
+      if (cells[n] < ncells_owned) active_cell[cells[n]] = true;
+  }
+  int nfaces = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+  for (int f=nfaces_owned; f!=nfaces; ++f) {
+    const AmanziMesh::Entity_ID* cells = topo.face_cells(f);
+    bool wet = false;
+    for (int n=0; n!=topo.face_num_cells(f); ++n) wet |= cond_c[0][cells[n]] > 0.;
+    if (wet) {
+      for (int n=0; n!=topo.face_num_cells(f); ++n)
+        if (cells[n] < ncells_owned) active_cell[cells[n]] = true;
+    }
+  }
+  ncells_active_ = std::count(active_cell.begin(), active_cell.end(), true);
+}
+
+
 // -----------------------------------------------------------------------------
 // Derivatives of the overland conductivity, upwinded.
 // -----------------------------------------------------------------------------
@@ -1406,6 +1480,15 @@ OverlandPressureFlow::ModifyCorrection(double h, Teuchos::RCP<const TreeVector>
   return AmanziSolvers::FnBaseDefs::CORRECTION_NOT_MODIFIED;
 }
 
+// -----------------------------------------------------------------------------
+// Storage used by the forward operator and preconditioner.
+// -----------------------------------------------------------------------------
+void OverlandPressureFlow::OperatorMemory(std::map<std::string,double>& bytes) const {
+  PK_PhysicalBDF_Default::OperatorMemory(bytes);
+  if (matrix_ != Teuchos::null)
+    bytes[name_+" operator"] += OperatorBytes_(*matrix_);
+}
+
 } // namespace
 } // namespace
 
@@ -12,6 +12,7 @@ Authors: Ethan Coon (ecoon@lanl.gov)
 
 #include "overland_pressure.hh"
 #include "Op.hh"
+#include "timer_tree.hh"
 
 namespace Amanzi {
 namespace Flow {
@@ -29,6 +30,8 @@ void OverlandPressureFlow::FunctionalResidual( double t_old,
                         Teuchos::RCP<TreeVector> u_old,
                         Teuchos::RCP<TreeVector> u_new,
                         Teuchos::RCP<TreeVector> g ) {
+  TimerTree::Scope timer(name_, "FunctionalResidual");
+
   // VerboseObject stuff.
   Teuchos::OSTab tab = vo_->getOSTab();
   niter_++;
@@ -50,37 +53,38 @@ void OverlandPressureFlow::FunctionalResidual( double t_old,
                << "Residual calculation: t0 = " << t_old
                << " t1 = " << t_new << " h = " << h << std::endl;
 
-  // unnecessary here if not debeugging, but doesn't hurt either
-  S_next_->GetFieldEvaluator(Keys::getKey(domain_,"pres_elev"))->HasFieldChanged(S_next_.ptr(), name_);
-
   // dump u_old, u_new
-  db_->WriteCellInfo(true);
-  std::vector<std::string> vnames;
-  vnames.push_back("p_old");
-  vnames.push_back("p_new");
-  vnames.push_back("z");
-  vnames.push_back("h_old");
-  vnames.push_back("h_new");
-  vnames.push_back("h+z");
-  if (plist_->get<bool>("subgrid model", false)) {
-    vnames.push_back("pd - dd");
-    vnames.push_back("frac_cond"); 
-  }
+  if (debugging_) {
+    S_next_->GetFieldEvaluator(Keys::getKey(domain_,"pres_elev"))->HasFieldChanged(S_next_.ptr(), name_);
+
+    db_->WriteCellInfo(true);
+    std::vector<std::string> vnames;
+    vnames.push_back("p_old");
+    vnames.push_back("p_new");
+    vnames.push_back("z");
+    vnames.push_back("h_old");
+    vnames.push_back("h_new");
+    vnames.push_back("h+z");
+    if (plist_->get<bool>("subgrid model", false)) {
+      vnames.push_back("pd - dd");
+      vnames.push_back("frac_cond"); 
+    }
 
-  std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
-  vecs.push_back(S_inter_->GetFieldData(key_).ptr());
-  vecs.push_back(u.ptr());
+    std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+    vecs.push_back(S_inter_->GetFieldData(key_).ptr());
+    vecs.push_back(u.ptr());
 
-  vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"elevation")).ptr());
-  vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"ponded_depth")).ptr());
-  vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"ponded_depth")).ptr());
-  vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"pres_elev")).ptr());
+    vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"elevation")).ptr());
+    vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"ponded_depth")).ptr());
+    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"ponded_depth")).ptr());
+    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"pres_elev")).ptr());
 
-  if (plist_->get<bool>("subgrid model", false)) {
-    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"ponded_depth_minus_depression_depth")).ptr());
-    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"fractional_conductance")).ptr());
+    if (plist_->get<bool>("subgrid model", false)) {
+      vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"ponded_depth_minus_depression_depth")).ptr());
+      vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"fractional_conductance")).ptr());
+    }
+    db_->WriteVectors(vnames, vecs, true);
   }
-  db_->WriteVectors(vnames, vecs, true);
 
   // update boundary conditions
   bc_head_->Compute(S_next_->time());
@@ -99,29 +103,30 @@ void OverlandPressureFlow::FunctionalResidual( double t_old,
   // diffusion term, treated implicitly
   ApplyDiffusion_(S_next_.ptr(), res.ptr());
   
-  db_->WriteBoundaryConditions(bc_markers(), bc_values());
-  if (S_next_->HasField(Keys::getKey(domain_,"unfrozen_fraction"))) {
-    vnames.resize(2);
-    vecs.resize(2);
-    vnames[0] = "uf_frac_old";
-    vnames[1] = "uf_frac_new";
-    vecs[0] = S_inter_->GetFieldData(Keys::getKey(domain_,"unfrozen_fraction")).ptr();
-    vecs[1] = S_next_->GetFieldData(Keys::getKey(domain_,"unfrozen_fraction")).ptr();
-    db_->WriteVectors(vnames, vecs, false);
+  if (debugging_) {
+    db_->WriteBoundaryConditions(bc_markers(), bc_values());
+    if (S_next_->HasField(Keys::getKey(domain_,"unfrozen_fraction"))) {
+      std::vector<std::string> vnames;
+      vnames.push_back("uf_frac_old"); vnames.push_back("uf_frac_new");
+      std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+      vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"unfrozen_fraction")).ptr());
+      vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"unfrozen_fraction")).ptr());
+      db_->WriteVectors(vnames, vecs, false);
+    }
+    db_->WriteVector("uw_dir", S_next_->GetFieldData(Keys::getKey(domain_,"mass_flux_direction")).ptr(), true);
+    db_->WriteVector("k_s", S_next_->GetFieldData(Keys::getKey(domain_,"overland_conductivity")).ptr(), true);
+    db_->WriteVector("k_s_uw", S_next_->GetFieldData(Keys::getKey(domain_,"upwind_overland_conductivity")).ptr(), true);
+    db_->WriteVector("q_s", S_next_->GetFieldData(Keys::getKey(domain_,"mass_flux")).ptr(), true);
+    db_->WriteVector("res (diff)", res.ptr(), true);
   }
-  db_->WriteVector("uw_dir", S_next_->GetFieldData(Keys::getKey(domain_,"mass_flux_direction")).ptr(), true);
-  db_->WriteVector("k_s", S_next_->GetFieldData(Keys::getKey(domain_,"overland_conductivity")).ptr(), true);
-  db_->WriteVector("k_s_uw", S_next_->GetFieldData(Keys::getKey(domain_,"upwind_overland_conductivity")).ptr(), true);
-  db_->WriteVector("q_s", S_next_->GetFieldData(Keys::getKey(domain_,"mass_flux")).ptr(), true);
-  db_->WriteVector("res (diff)", res.ptr(), true);
 
   // accumulation term
   AddAccumulation_(res.ptr());
-  db_->WriteVector("res (acc)", res.ptr(), true);
+  if (debugging_) db_->WriteVector("res (acc)", res.ptr(), true);
 
   // add rhs load value
   AddSourceTerms_(res.ptr());
-  db_->WriteVector("res (src)", res.ptr(), true);
+  if (debugging_) db_->WriteVector("res (src)", res.ptr(), true);
 
 #if DEBUG_RES_FLAG
   if (niter_ < 23) {
@@ -146,15 +151,16 @@ void OverlandPressureFlow::FunctionalResidual( double t_old,
 // Apply the preconditioner to u and return the result in Pu.
 // -----------------------------------------------------------------------------
 int OverlandPressureFlow::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu) {
+  TimerTree::Scope timer(name_, "ApplyPreconditioner");
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_HIGH))
     *vo_->os() << "Precon application:" << std::endl;
 
 
   // apply the preconditioner
-  db_->WriteVector("h_res", u->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("h_res", u->Data().ptr(), true);
   int ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
-  db_->WriteVector("PC*h_res (h-coords)", Pu->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("PC*h_res (h-coords)", Pu->Data().ptr(), true);
 
   // tack on the variable change
   const Epetra_MultiVector& dh_dp =
@@ -166,7 +172,7 @@ int OverlandPressureFlow::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
     Pu_c[0][c] /= dh_dp[0][c];
   }
 
-  db_->WriteVector("PC*h_res (p-coords)", Pu->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("PC*h_res (p-coords)", Pu->Data().ptr(), true);
   return (ierr > 0) ? 0 : 1;
 };
 
@@ -175,6 +181,8 @@ int OverlandPressureFlow::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
 // Update the preconditioner at time t and u = up
 // -----------------------------------------------------------------------------
 void OverlandPressureFlow::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h) {
+  TimerTree::Scope timer(name_, "UpdatePreconditioner");
+
   // VerboseObject stuff.
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_EXTREME))
@@ -250,8 +258,8 @@ void OverlandPressureFlow::UpdatePreconditioner(double t, Teuchos::RCP<const Tre
   S_next_->GetFieldEvaluator(Keys::getKey(domain_,"water_content_bar"))
       ->HasFieldDerivativeChanged(S_next_.ptr(), name_, key_);
   auto dwc_dp = S_next_->GetFieldData(Keys::getDerivKey(Keys::getKey(domain_,"water_content_bar"),key_));
-  db_->WriteVector("    dwc_dp", dwc_dp.ptr());
-  db_->WriteVector("    dh_dp", dh_dp.ptr());
+  if (debugging_) db_->WriteVector("    dwc_dp", dwc_dp.ptr());
+  if (debugging_) db_->WriteVector("    dh_dp", dh_dp.ptr());
 
   CompositeVector dwc_dh(dwc_dp->Map());
   dwc_dh.ReciprocalMultiply(1./h, *dh_dp, *dwc_dp, 0.);
@@ -348,7 +356,7 @@ void OverlandPressureFlow::UpdatePreconditioner(double t, Teuchos::RCP<const Tre
     
     if (vo_->os_OK(Teuchos::VERB_EXTREME))
       *vo_->os() << "  Right scaling TPFA" << std::endl;
-    db_->WriteVector("    dh_dp", dh0_dp.ptr());
+    if (debugging_) db_->WriteVector("    dh_dp", dh0_dp.ptr());
   }
 
   /*
@@ -369,6 +377,7 @@ void OverlandPressureFlow::UpdatePreconditioner(double t, Teuchos::RCP<const Tre
 // -----------------------------------------------------------------------------
 double OverlandPressureFlow::ErrorNorm(Teuchos::RCP<const TreeVector> u,
                                Teuchos::RCP<const TreeVector> res) {
+  TimerTree::Scope timer(name_, "ErrorNorm");
 
   S_inter_->GetFieldEvaluator(conserved_key_)->HasFieldChanged(S_inter_.ptr(), name_);
   const Epetra_MultiVector& conserved = *S_inter_->GetFieldData(conserved_key_)
@@ -37,6 +37,14 @@ Solves Richards equation:
     * `"water retention evaluator`" ``[wrm-evaluator-spec]`` The water retention
       curve.  This needs to go away, and should get moved to State.
 
+    * `"fused water retention evaluator`" ``[bool]`` **false** If true, the
+      saturation evaluator built from the `"water retention evaluator`" list
+      is a WRMFusedEvaluator, which also computes rel perm and its derivative
+      in the same pass over the mesh, for the rel perm evaluator to copy.
+      Keys and dependencies are unchanged.  If saturation or rel perm already
+      have their own evaluators, this is not done, and this is reported at
+      `"low`" verbosity.
+
     IF
     
     * `"source term`" ``[bool]`` **false** Is there a source term?
@@ -62,6 +70,24 @@ Solves Richards equation:
       is only needed to set Jacobian options, as all others probably should
       match those in `"diffusion`", and default to those values.
 
+    * `"column preconditioner`" ``[column-preconditioner-spec]`` **optional**
+      If provided, the preconditioner solves each column of the mesh exactly,
+      optionally followed by the inverse of the diffusion preconditioner.  For
+      extruded meshes with thin cells, where vertical coupling dominates.
+      Requires a mesh built with columns and an FV discretization.  With
+      `"stage`" `"columns`", the `"preconditioner`" list is not used.  See
+      ColumnPreconditioner.
+
+    * `"Jacobian-free Newton-Krylov`" ``[jacobian-free-newton-krylov-spec]``
+      **optional** If provided, the correction uses finite difference Jacobian
+      actions, and the assembled operator only as the preconditioner.  See
+      JacobianFreeNewtonKrylov.
+
+    * `"preconditioner reuse`" ``[preconditioner-reuse-spec]`` **optional**
+      If provided, the assembled preconditioner is reused until the linear
+      iteration count or the nonlinear contraction rate degrades.  See
+      PreconditionerLag.
+
     * `"surface rel perm strategy`" ``[string]`` **none** Approach for
       specifying the relative permeabiilty on the surface face.  `"clobber`" is
       frequently used for cases where a surface rel perm will be provided.  One
@@ -224,7 +250,9 @@ namespace Amanzi {
 // forward declarations
 class MPCSubsurface;
 class PredictorDelegateBCFlux;
+class MeshTopology;
 namespace WhetStone { class Tensor; }
+namespace Operators { class ColumnPreconditioner; }
 
 namespace Flow {
 
@@ -265,6 +293,8 @@ public:
   // applies preconditioner to u and returns the result in Pu
   virtual int ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu);
 
+  virtual bool SupportsJacobianFree() const { return true; }
+
   // updates the preconditioner
   virtual void UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h);
 
@@ -277,12 +307,17 @@ public:
   // evaluating consistent faces for given BCs and cell values
   virtual void CalculateConsistentFaces(const Teuchos::Ptr<CompositeVector>& u);
 
+  // -- storage used by operators, for memory reporting
+  virtual void OperatorMemory(std::map<std::string,double>& bytes) const override;
+
 protected:
   // Create of physical evaluators.
   virtual void SetupPhysicalEvaluators_(const Teuchos::Ptr<State>& S);
   virtual void SetupRichardsFlow_(const Teuchos::Ptr<State>& S);
 
   // boundary condition members
+  void ComputeBoundaryConditions_(double t);
+  void UpdateStaticBoundaryConditions_(const Teuchos::Ptr<State>& S);
   virtual void UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr=true);
 
   // -- builds tensor K, along with faced-based Krel if needed by the rel-perm method
@@ -393,6 +428,7 @@ protected:
   Teuchos::RCP<Operators::PDE_DiffusionWithGravity> preconditioner_diff_;
   Teuchos::RCP<Operators::PDE_DiffusionWithGravity> face_matrix_diff_;
   Teuchos::RCP<Operators::PDE_Accumulation> preconditioner_acc_;
+  Teuchos::RCP<Operators::ColumnPreconditioner> column_preconditioner_;
 
   // flag to do jacobian and therefore coef derivs
   bool jacobian_;
@@ -413,6 +449,17 @@ protected:
   Teuchos::RCP<Functions::BoundaryFunction> bc_seepage_infilt_;
   Teuchos::RCP<Functions::BoundaryFunction> bc_infiltration_;
 
+  // -- boundary conditions that do not depend upon the state, rebuilt when
+  //    the functions are computed at a new time
+  double bc_time_;
+  bool bc_static_valid_;
+  std::vector<int> bc_markers_static_;
+  std::vector<double> bc_values_static_;
+  std::vector<int> bc_counts_static_;
+
+  // -- face to cell topology of mesh_, from the MeshTopology cache
+  const MeshTopology* topo_;
+
   // delegates
   bool modify_predictor_bc_flux_;
   bool modify_predictor_first_bc_flux_;
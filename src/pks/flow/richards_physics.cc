@@ -65,7 +65,7 @@ void Richards::AddAccumulation_(const Teuchos::Ptr<CompositeVector>& g) {
   g->ViewComponent("cell",false)->Update(1.0/dt, *wc1->ViewComponent("cell",false),
           -1.0/dt, *wc0->ViewComponent("cell",false), 1.0);
   
-  db_->WriteVector("res (acc)", g, true);
+  if (debugging_) db_->WriteVector("res (acc)", g, true);
 
 };
 
@@ -87,7 +87,7 @@ void Richards::AddSources_(const Teuchos::Ptr<State>& S,
         *S->GetFieldData(source_key_)->ViewComponent("cell",false);
 
     const Epetra_MultiVector& cv =
-      *S->GetFieldData(Keys::getKey(domain_,"cell_volume"))->ViewComponent("cell",false);
+      *S->GetFieldData(cell_vol_key_)->ViewComponent("cell",false);
 
     // Add into residual
     unsigned int ncells = g_c.MyLength();
@@ -97,9 +97,9 @@ void Richards::AddSources_(const Teuchos::Ptr<State>& S,
 
     if (vo_->os_OK(Teuchos::VERB_EXTREME)) {
       *vo_->os() << "Adding external source term" << std::endl;
-      db_->WriteVector("  Q_ext", S->GetFieldData(source_key_).ptr(), false);
+      if (debugging_) db_->WriteVector("  Q_ext", S->GetFieldData(source_key_).ptr(), false);
     }  
-    db_->WriteVector("res (src)", g, false);
+    if (debugging_) db_->WriteVector("res (src)", g, false);
   }
 }
 
@@ -7,6 +7,8 @@ Authors: Neil Carlson (version 1)
          Konstantin Lipnikov (version 2) (lipnikov@lanl.gov)
          Ethan Coon (ATS version) (ecoon@lanl.gov)
 ------------------------------------------------------------------------- */
+#include <limits>
+
 #include "boost/math/special_functions/fpclassify.hpp"
 
 #include "boost/algorithm/string/predicate.hpp"
@@ -31,6 +33,8 @@ Authors: Neil Carlson (version 1)
 #include "richards_water_content_evaluator.hh"
 #include "OperatorDefs.hh"
 #include "BoundaryFlux.hh"
+#include "mesh_topology.hh"
+#include "column_preconditioner.hh"
 
 #include "richards.hh"
 
@@ -65,7 +69,10 @@ Richards::Richards(Teuchos::ParameterList& pk_tree,
     jacobian_(false),
     jacobian_lag_(0),
     iter_(0),
-    iter_counter_time_(0.)
+    iter_counter_time_(0.),
+    bc_time_(std::numeric_limits<double>::quiet_NaN()),
+    bc_static_valid_(false),
+    topo_(nullptr)
 {
   if (!plist_->isParameter("conserved quantity key suffix"))
     plist_->set("conserved quantity key suffix", "water_content");
@@ -81,6 +88,7 @@ Richards::Richards(Teuchos::ParameterList& pk_tree,
 void Richards::Setup(const Teuchos::Ptr<State>& S) {
 
   PK_PhysicalBDF_Default::Setup(S);
+  topo_ = &MeshTopology::Get(mesh_);
 
   SetupRichardsFlow_(S);
   SetupPhysicalEvaluators_(S);
@@ -252,10 +260,17 @@ void Richards::SetupRichardsFlow_(const Teuchos::Ptr<State>& S) {
     }
   }
 
-  mfd_pc_plist.set("inverse", plist_->sublist("inverse"));
-  // old style... deprecate me!
-  mfd_pc_plist.sublist("inverse").setParameters(plist_->sublist("preconditioner"));
-  mfd_pc_plist.sublist("inverse").setParameters(plist_->sublist("linear solver"));
+  // -- the column preconditioner alone never uses the operator's inverse
+  bool columns_only = plist_->isSublist("column preconditioner") &&
+      plist_->sublist("column preconditioner").get<std::string>("stage", "columns") == "columns";
+  if (columns_only) {
+    mfd_pc_plist.remove("inverse", false);
+  } else {
+    mfd_pc_plist.set("inverse", plist_->sublist("inverse"));
+    // old style... deprecate me!
+    mfd_pc_plist.sublist("inverse").setParameters(plist_->sublist("preconditioner"));
+    mfd_pc_plist.sublist("inverse").setParameters(plist_->sublist("linear solver"));
+  }
 
   preconditioner_diff_ = opfactory.CreateWithGravity(mfd_pc_plist, mesh_, bc_);
   preconditioner_ = preconditioner_diff_->global_operator();
@@ -291,6 +306,12 @@ void Richards::SetupRichardsFlow_(const Teuchos::Ptr<State>& S) {
   acc_pc_plist.set<std::string>("entity kind", "cell");
   preconditioner_acc_ = Teuchos::rcp(new Operators::PDE_Accumulation(acc_pc_plist, preconditioner_));
 
+  // -- optional exact solves along mesh columns
+  if (plist_->isSublist("column preconditioner")) {
+    column_preconditioner_ = Teuchos::rcp(new Operators::ColumnPreconditioner(
+        plist_->sublist("column preconditioner"), preconditioner_));
+  }
+
   // // -- vapor diffusion terms
   // vapor_diffusion_ = plist_->get<bool>("include vapor diffusion", false);
   // if (vapor_diffusion_){
@@ -424,6 +445,20 @@ void Richards::SetupPhysicalEvaluators_(const Teuchos::Ptr<State>& S) {
       wrm_plist.set("field evaluator type", "WRM rel perm");
       S->FEList().set(coef_key_, wrm_plist);
     }
+
+    if (plist_->get<bool>("fused water retention evaluator", false)) {
+      // the saturation evaluator also computes rel perm for the rel perm evaluator
+      Teuchos::ParameterList& fe_list = S->FEList();
+      if (!S->HasFieldEvaluator(sat_key_) && !S->HasFieldEvaluator(coef_key_) &&
+          fe_list.sublist(sat_key_).get<std::string>("field evaluator type") == "WRM") {
+        fe_list.sublist(sat_key_).set("field evaluator type", "WRM fused");
+      } else if (vo_->os_OK(Teuchos::VERB_LOW)) {
+        Teuchos::OSTab tab = vo_->getOSTab();
+        *vo_->os() << "Fused water retention evaluator not used: " << sat_key_
+                   << " or " << coef_key_ << " already has its own evaluator."
+                   << std::endl;
+      }
+    }
   }
 
   // -- saturation
@@ -445,7 +480,9 @@ void Richards::SetupPhysicalEvaluators_(const Teuchos::Ptr<State>& S) {
   S->RequireField(coef_key_)->SetMesh(mesh_)->SetGhosted()
       ->AddComponents(names2, locations2, num_dofs2);
 
-  S->FEList().sublist(coef_key_).set<double>("permeability rescaling", perm_scale_);
+  if (S->FEList().isSublist(coef_key_)) {
+    S->FEList().sublist(coef_key_).set<double>("permeability rescaling", perm_scale_);
+  }
   S->RequireFieldEvaluator(coef_key_);
 
   // -- get the WRM models
@@ -851,32 +888,36 @@ bool Richards::UpdatePermeabilityDerivativeData_(const Teuchos::Ptr<State>& S) {
 
 
 // -----------------------------------------------------------------------------
-// Evaluate boundary conditions at the current time.
+// Compute the boundary condition functions at time t, if not already done.
 // -----------------------------------------------------------------------------
-void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
+void Richards::ComputeBoundaryConditions_(double t)
 {
-  Teuchos::OSTab tab = vo_->getOSTab();
-  if (vo_->os_OK(Teuchos::VERB_EXTREME))
-    *vo_->os() << "  Updating BCs." << std::endl;
-
-  auto& markers = bc_markers();
-  auto& values = bc_values();
+  if (t == bc_time_) return;
+  bc_pressure_->Compute(t);
+  bc_head_->Compute(t);
+  bc_flux_->Compute(t);
+  bc_time_ = t;
+  bc_static_valid_ = false;
+}
 
-  // initialize all to 0
-  for (unsigned int n=0; n!=markers.size(); ++n) {
-    markers[n] = Operators::OPERATOR_BC_NONE;
-    values[n] = 0.0;
-  }
 
-  // count for debugging
-  std::vector<int> bc_counts;
-  std::vector<std::string> bc_names;
+// -----------------------------------------------------------------------------
+// Build the part of the boundary conditions that does not depend upon the
+// state: Dirichlet pressure and head conditions and the default zero flux
+// condition.  Faces whose conditions depend upon the state are marked, to be
+// set on each update.
+// -----------------------------------------------------------------------------
+void Richards::UpdateStaticBoundaryConditions_(const Teuchos::Ptr<State>& S)
+{
+  int nfaces = bc_markers().size();
+  bc_markers_static_.assign(nfaces, Operators::OPERATOR_BC_NONE);
+  bc_values_static_.assign(nfaces, 0.);
+  bc_counts_static_.clear();
 
   // Dirichlet-type boundary conditions
   // -------------------------------------
   // pressure boundary conditions -- the primary
-  bc_counts.push_back(bc_pressure_->size());
-  bc_names.push_back(key_);
+  bc_counts_static_.push_back(bc_pressure_->size());
   for (const auto& bc : *bc_pressure_) {
     int f = bc.first;
 #ifdef ENABLE_DBC
@@ -884,13 +925,12 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
     mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
     AMANZI_ASSERT(cells.size() == 1);
 #endif
-    markers[f] = Operators::OPERATOR_BC_DIRICHLET;
-    values[f] = bc.second;
+    bc_markers_static_[f] = Operators::OPERATOR_BC_DIRICHLET;
+    bc_values_static_[f] = bc.second;
   }
 
   // head boundary conditions, like Dirichlet only require change of units
-  bc_counts.push_back(bc_head_->size());
-  bc_names.push_back("head");
+  bc_counts_static_.push_back(bc_head_->size());
   for (const auto& bc : *bc_head_) {
     int f = bc.first;
 #ifdef ENABLE_DBC
@@ -898,9 +938,74 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
     mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
     AMANZI_ASSERT(cells.size() == 1);
 #endif
-    markers[f] = Operators::OPERATOR_BC_DIRICHLET;
-    values[f] = bc.second;
+    bc_markers_static_[f] = Operators::OPERATOR_BC_DIRICHLET;
+    bc_values_static_[f] = bc.second;
+  }
+
+  // state-dependent conditions, set on each update
+  for (const auto& bc : *bc_flux_)
+    bc_markers_static_[bc.first] = Operators::OPERATOR_BC_NEUMANN;
+  for (const auto& bc : *bc_seepage_)
+    bc_markers_static_[bc.first] = Operators::OPERATOR_BC_NEUMANN;
+  for (const auto& bc : *bc_seepage_infilt_)
+    bc_markers_static_[bc.first] = Operators::OPERATOR_BC_NEUMANN;
+
+  std::vector<Key> surf_domains;
+  if (coupled_to_surface_via_head_) surf_domains.push_back("surface");
+  if (coupled_to_surface_via_flux_) surf_domains.push_back(Keys::getDomain(ss_flux_key_));
+  for (const auto& surf_domain : surf_domains) {
+    Teuchos::RCP<const AmanziMesh::Mesh> surface = S->GetMesh(surf_domain);
+    const MeshTopology& surf_topo = MeshTopology::Get(surface, mesh_);
+    unsigned int ncells_surface = surface->num_entities(AmanziMesh::CELL,
+            AmanziMesh::Parallel_type::OWNED);
+    for (unsigned int c=0; c!=ncells_surface; ++c)
+      bc_markers_static_[surf_topo.parent_face(c)] = Operators::OPERATOR_BC_NEUMANN;
+  }
+
+  // mark all remaining boundary conditions as zero flux conditions
+  int n_default = 0;
+  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
+  for (int f = 0; f < nfaces_owned; f++) {
+    if (bc_markers_static_[f] == Operators::OPERATOR_BC_NONE &&
+        topo_->face_num_cells(f) == 1) {
+      n_default++;
+      bc_markers_static_[f] = Operators::OPERATOR_BC_NEUMANN;
+    }
   }
+  bc_counts_static_.push_back(n_default);
+
+  bc_static_valid_ = true;
+}
+
+
+// -----------------------------------------------------------------------------
+// Evaluate boundary conditions at the current time.
+//
+// The state-independent conditions are rebuilt only when the boundary
+// condition functions have been recomputed; on each update they are copied,
+// and only the flux, seepage, and surface coupling faces are visited.
+// -----------------------------------------------------------------------------
+void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
+{
+  Teuchos::OSTab tab = vo_->getOSTab();
+  if (vo_->os_OK(Teuchos::VERB_EXTREME))
+    *vo_->os() << "  Updating BCs." << std::endl;
+
+  auto& markers = bc_markers();
+  auto& values = bc_values();
+
+  if (!bc_static_valid_ || bc_markers_static_.size() != markers.size())
+    UpdateStaticBoundaryConditions_(S);
+  markers = bc_markers_static_;
+  values = bc_values_static_;
+
+  // count for debugging
+  std::vector<int> bc_counts;
+  std::vector<std::string> bc_names;
+  bc_counts.push_back(bc_counts_static_[0]);
+  bc_names.push_back(key_);
+  bc_counts.push_back(bc_counts_static_[1]);
+  bc_names.push_back("head");
 
   // Neumann type boundary conditions
   // -------------------------------------
@@ -1090,24 +1195,8 @@ void Richards::UpdateBoundaryConditions_(const Teuchos::Ptr<State>& S, bool kr)
     }
   }
 
-  // mark all remaining boundary conditions as zero flux conditions
-  AmanziMesh::Entity_ID_List cells;
-  int n_default = 0;
-  int nfaces_owned = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::OWNED);
-  for (int f = 0; f < nfaces_owned; f++) {
-    if (markers[f] == Operators::OPERATOR_BC_NONE) {
-      mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-      int ncells = cells.size();
-
-      if (ncells == 1) {
-        n_default++;
-        markers[f] = Operators::OPERATOR_BC_NEUMANN;
-        values[f] = 0.0;
-      }
-    }
-  }
   bc_names.push_back("default (zero flux)");
-  bc_counts.push_back(n_default);
+  bc_counts.push_back(bc_counts_static_[2]);
 
   // report on counts
   if (vo_->os_OK(Teuchos::VERB_HIGH)) {
@@ -1131,9 +1220,7 @@ bool Richards::ModifyPredictor(double h, Teuchos::RCP<const TreeVector> u0,
     *vo_->os() << "Modifying predictor:" << std::endl;
 
   // update boundary conditions
-  bc_pressure_->Compute(S_next_->time());
-  bc_head_->Compute(S_next_->time());
-  bc_flux_->Compute(S_next_->time());
+  ComputeBoundaryConditions_(S_next_->time());
   UpdateBoundaryConditions_(S_next_.ptr());
   db_->WriteBoundaryConditions(bc_markers(), bc_values());
 
@@ -1542,9 +1629,7 @@ Richards::ModifyCorrection(double h, Teuchos::RCP<const TreeVector> res,
 ****************************************************************** */
 int Richards::BoundaryFaceGetCell(int f) const
 {
-  AmanziMesh::Entity_ID_List cells;
-  mesh_->face_get_cells(f, AmanziMesh::Parallel_type::GHOST, &cells);
-  return cells[0];
+  return topo_->face_cells(f)[0];
 }
 
 /* ******************************************************************
@@ -1628,5 +1713,14 @@ double Richards::BoundaryFaceValue(int f, const CompositeVector& u)
 
 
 
+// -----------------------------------------------------------------------------
+// Storage used by the forward operator and preconditioner.
+// -----------------------------------------------------------------------------
+void Richards::OperatorMemory(std::map<std::string,double>& bytes) const {
+  PK_PhysicalBDF_Default::OperatorMemory(bytes);
+  if (matrix_ != Teuchos::null)
+    bytes[name_+" operator"] += OperatorBytes_(*matrix_);
+}
+
 } // namespace
 } // namespace
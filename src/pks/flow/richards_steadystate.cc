@@ -35,8 +35,7 @@ void RichardsSteadyState::UpdatePreconditioner(double t, Teuchos::RCP<const Tree
 
   Teuchos::RCP<const CompositeVector> pres = S_next_ -> GetFieldData(key_);
   // update boundary conditions
-  bc_pressure_->Compute(S_next_->time());
-  bc_flux_->Compute(S_next_->time());
+  ComputeBoundaryConditions_(S_next_->time());
   UpdateBoundaryConditions_(S_next_.ptr());
 
   preconditioner_->Init();
@@ -166,8 +165,7 @@ void RichardsSteadyState::FunctionalResidual(double t_old, double t_new, Teuchos
 #endif
 
   // update boundary conditions
-  bc_pressure_->Compute(t_new);
-  bc_flux_->Compute(t_new);
+  ComputeBoundaryConditions_(t_new);
   UpdateBoundaryConditions_(S_next_.ptr());
 
   // zero out residual
@@ -213,6 +211,10 @@ void RichardsSteadyState::FunctionalResidual(double t_old, double t_new, Teuchos
     *S_next_->GetFieldData(solnstream.str(),name_) = *u;
   }
 #endif
+
+  // the point at which a Jacobian-free correction linearizes
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    jfnk_->SetBasePoint(t_old, t_new, u_old, u_new, *g);
 };
 
 } // namespace
@@ -11,6 +11,8 @@ Authors: Ethan Coon (ATS version) (ecoon@lanl.gov)
 #include "boost/math/special_functions/fpclassify.hpp"
 
 #include "Op.hh"
+#include "timer_tree.hh"
+#include "column_preconditioner.hh"
 #include "richards.hh"
 
 namespace Amanzi {
@@ -25,6 +27,8 @@ void Richards::FunctionalResidual(double t_old,
                    Teuchos::RCP<TreeVector> u_old,
                    Teuchos::RCP<TreeVector> u_new,
                    Teuchos::RCP<TreeVector> g) {
+  TimerTree::Scope timer(name_, "FunctionalResidual");
+
   // VerboseObject stuff.
   Teuchos::OSTab tab = vo_->getOSTab();
 
@@ -45,19 +49,19 @@ void Richards::FunctionalResidual(double t_old,
                << " t1 = " << t_new << " h = " << h << std::endl;
 
   // dump u_old, u_new
-  db_->WriteCellInfo(true);
-  std::vector<std::string> vnames;
-  vnames.push_back("p_old"); vnames.push_back("p_new");
-  std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
-  vecs.push_back(S_inter_->GetFieldData(key_).ptr()); vecs.push_back(u.ptr());
-  db_->WriteVectors(vnames, vecs, true);
+  if (debugging_) {
+    db_->WriteCellInfo(true);
+    std::vector<std::string> vnames;
+    vnames.push_back("p_old"); vnames.push_back("p_new");
+    std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+    vecs.push_back(S_inter_->GetFieldData(key_).ptr()); vecs.push_back(u.ptr());
+    db_->WriteVectors(vnames, vecs, true);
+  }
 
   // update boundary conditions
-  bc_pressure_->Compute(t_new);
-  bc_head_->Compute(t_new);
-  bc_flux_->Compute(t_new);
+  ComputeBoundaryConditions_(t_new);
   UpdateBoundaryConditions_(S_next_.ptr());
-  db_->WriteBoundaryConditions(bc_markers(), bc_values());
+  if (debugging_) db_->WriteBoundaryConditions(bc_markers(), bc_values());
 
   // zero out residual
   Teuchos::RCP<CompositeVector> res = g->Data();
@@ -68,31 +72,35 @@ void Richards::FunctionalResidual(double t_old,
   // if (vapor_diffusion_) AddVaporDiffusionResidual_(S_next_.ptr(), res.ptr());
 
   // dump s_old, s_new
-  vnames[0] = "sl_old"; vnames[1] = "sl_new";
-  vecs[0] = S_inter_->GetFieldData(sat_key_).ptr();
-  vecs[1] = S_next_->GetFieldData(sat_key_).ptr();
-
-  if (S_next_->HasField(sat_ice_key_)) {
-    vnames.push_back("si_old");
-    vnames.push_back("si_new");
-    vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"saturation_ice")).ptr());
-    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"saturation_ice")).ptr());
+  if (debugging_) {
+    std::vector<std::string> vnames;
+    std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+    vnames.push_back("sl_old"); vnames.push_back("sl_new");
+    vecs.push_back(S_inter_->GetFieldData(sat_key_).ptr());
+    vecs.push_back(S_next_->GetFieldData(sat_key_).ptr());
+
+    if (S_next_->HasField(sat_ice_key_)) {
+      vnames.push_back("si_old");
+      vnames.push_back("si_new");
+      vecs.push_back(S_inter_->GetFieldData(Keys::getKey(domain_,"saturation_ice")).ptr());
+      vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"saturation_ice")).ptr());
+    }
+    vnames.push_back("poro");
+    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"porosity")).ptr());
+    vnames.push_back("perm_K");
+    vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"permeability")).ptr());
+    vnames.push_back("k_rel");
+    vecs.push_back(S_next_->GetFieldData(coef_key_).ptr());
+    vnames.push_back("wind");
+    vecs.push_back(S_next_->GetFieldData(flux_dir_key_).ptr());
+    vnames.push_back("uw_k_rel");
+    vecs.push_back(S_next_->GetFieldData(uw_coef_key_).ptr());
+    vnames.push_back("flux");
+    vecs.push_back(S_next_->GetFieldData(flux_key_).ptr());
+    db_->WriteVectors(vnames,vecs,true);
+
+    db_->WriteVector("res (diff)", res.ptr(), true);
   }
-  vnames.push_back("poro");
-  vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"porosity")).ptr());
-  vnames.push_back("perm_K");
-  vecs.push_back(S_next_->GetFieldData(Keys::getKey(domain_,"permeability")).ptr());
-  vnames.push_back("k_rel");
-  vecs.push_back(S_next_->GetFieldData(coef_key_).ptr());
-  vnames.push_back("wind");
-  vecs.push_back(S_next_->GetFieldData(flux_dir_key_).ptr());
-  vnames.push_back("uw_k_rel");
-  vecs.push_back(S_next_->GetFieldData(uw_coef_key_).ptr());
-  vnames.push_back("flux");
-  vecs.push_back(S_next_->GetFieldData(flux_key_).ptr());
-  db_->WriteVectors(vnames,vecs,true);
-
-  db_->WriteVector("res (diff)", res.ptr(), true);
 
   // accumulation term
   AddAccumulation_(res.ptr());
@@ -105,22 +113,52 @@ void Richards::FunctionalResidual(double t_old,
       AddSources_(S_next_.ptr(), res.ptr());
     }
   }
+
+  // the point at which a Jacobian-free correction linearizes
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    jfnk_->SetBasePoint(t_old, t_new, u_old, u_new, *g);
 };
 
 // -----------------------------------------------------------------------------
 // Apply the preconditioner to u and return the result in Pu.
 // -----------------------------------------------------------------------------
 int Richards::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu) {
+  TimerTree::Scope timer(name_, "ApplyPreconditioner");
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_HIGH))
     *vo_->os() << "Precon application:" << std::endl;
 
-  db_->WriteVector("p_res", u->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("p_res", u->Data().ptr(), true);
+
+  // u is the nonlinear residual, unless this is a call back from the
+  // Jacobian-free correction's Krylov iteration
+  bool jfnk_active = jfnk_ != Teuchos::null && jfnk_->active();
+  if (precon_lag_ != Teuchos::null && !jfnk_active) {
+    double norm(0.);
+    u->Norm2(&norm);
+    precon_lag_->RecordResidualNorm(S_next_->time(), norm);
+  }
+
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_active) {
+    int ierr = jfnk_->ApplyInverse(u, Pu);
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  JFNK iterations: " << jfnk_->num_itrs() << std::endl;
+    return ierr;
+  }
 
   // Apply the preconditioner
-  int ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+  int ierr, itrs;
+  if (column_preconditioner_ != Teuchos::null) {
+    ierr = column_preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+    itrs = column_preconditioner_->num_itrs();
+  } else {
+    ierr = preconditioner_->ApplyInverse(*u->Data(), *Pu->Data());
+    itrs = preconditioner_->num_itrs();
+  }
+  if (precon_lag_ != Teuchos::null) precon_lag_->RecordLinearIterations(itrs);
 
-  db_->WriteVector("PC*p_res", Pu->Data().ptr(), true);
+  if (debugging_) db_->WriteVector("PC*p_res", Pu->Data().ptr(), true);
   
   return (ierr > 0) ? 0 : 1;
 };
@@ -130,11 +168,21 @@ int Richards::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP
 // Update the preconditioner at time t and u = up
 // -----------------------------------------------------------------------------
 void Richards::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h) {
+  TimerTree::Scope timer(name_, "UpdatePreconditioner");
+
   // VerboseObject stuff.
   Teuchos::OSTab tab = vo_->getOSTab();
   if (vo_->os_OK(Teuchos::VERB_HIGH))
     *vo_->os() << "Precon update at t = " << t << std::endl;
 
+  // keep the current preconditioner if it has not degraded
+  if (precon_lag_ != Teuchos::null && precon_lag_->Reuse(h)) {
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  reusing preconditioner" << std::endl;
+    iter_++;
+    return;
+  }
+
   // Recreate mass matrices
   if (dynamic_mesh_) {
     matrix_diff_->SetTensorCoefficient(K_);
@@ -154,9 +202,7 @@ void Richards::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up,
   if (jacobian_ && iter_ >= jacobian_lag_) UpdatePermeabilityDerivativeData_(S_next_.ptr());
 
   // update boundary conditions
-  bc_pressure_->Compute(S_next_->time());
-  bc_head_->Compute(S_next_->time());
-  bc_flux_->Compute(S_next_->time());
+  ComputeBoundaryConditions_(S_next_->time());
   UpdateBoundaryConditions_(S_next_.ptr());
 
   Teuchos::RCP<const CompositeVector> rel_perm =
@@ -200,14 +246,16 @@ void Richards::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up,
   Key dwc_dp_key = Keys::getDerivKey(conserved_key_, key_);
   Teuchos::RCP<const CompositeVector> dwc_dp = S_next_->GetFieldData(dwc_dp_key);
 
-  db_->WriteVector("    dwc_dp", dwc_dp.ptr());
+  if (debugging_) db_->WriteVector("    dwc_dp", dwc_dp.ptr());
 
   // -- update the cell-cell block  CompositeVector du(S_next_->GetFieldData(dwc_dp_key)->Map());
   preconditioner_acc_->AddAccumulationTerm(*dwc_dp, h, "cell", false);
 
   // -- update preconditioner with source term derivatives if needed
   AddSourcesToPrecon_(S_next_.ptr(), h);
-  
+
+  // -- factor the column systems
+  if (column_preconditioner_ != Teuchos::null) column_preconditioner_->Update();
 
   // increment the iterator count
   iter_++;
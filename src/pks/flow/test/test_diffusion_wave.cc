@@ -0,0 +1,147 @@
+#include <cmath>
+#include <vector>
+#include "UnitTest++.h"
+
+#include "Teuchos_ParameterList.hpp"
+#include "Epetra_SerialComm.h"
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+
+#include "diffusion_wave_subcycler.hh"
+
+using namespace Amanzi::Flow;
+
+namespace {
+
+const int N = 40;
+const double dx = 10.;
+const double nl = 55000.;
+
+// A row of cells sloping down in x, with face i on the left of cell i.
+Teuchos::RCP<DiffusionWaveSubcycler>
+createRow(const Epetra_Map& map, int max_levels)
+{
+  Teuchos::ParameterList plist;
+  plist.set<int>("maximum levels", max_levels);
+  auto sub = Teuchos::rcp(new DiffusionWaveSubcycler(plist, map, map, N+1, N+1, 9.80665));
+
+  sub->SetFace(0, 0, -1, -1, 1., 2./dx);
+  for (int f=1; f!=N; ++f) sub->SetFace(f, f-1, f, 1, 1., 1./dx);
+  sub->SetFace(N, N-1, -1, 1, 1., 2./dx);
+
+  for (int c=0; c!=N; ++c) sub->SetCellData(c, nl*dx, nl, 0.01*dx*(N-c), 0.01, 0.05, 1.);
+  for (int f=0; f!=N+1; ++f) sub->SetFaceElevation(f, 0.01*dx*(N-f+0.5));
+  return sub;
+}
+
+// A mound of water near the top of the row.
+void initialWaterContent(Epetra_MultiVector& wc)
+{
+  wc.PutScalar(0.);
+  for (int c=5; c!=10; ++c) wc[0][c] = 0.2 * nl * dx;
+}
+
+long advance(DiffusionWaveSubcycler& sub, double t0, double t1)
+{
+  long nupdates = 0;
+  double t = t0;
+  while (t1 - t > 1.e-10 * (t1 - t0)) {
+    int nlevels = 0;
+    double dt_cycle = sub.ComputeLevels(t1 - t, &nlevels);
+    int nsub = 1 << nlevels;
+    for (int k=0; k!=nsub; ++k) nupdates += sub.Substep(k, nlevels, dt_cycle / nsub);
+    t += dt_cycle;
+  }
+  return nupdates;
+}
+
+double total(const Epetra_Vector& wc)
+{
+  double sum = 0.;
+  for (int c=0; c!=N; ++c) sum += wc[c];
+  return sum;
+}
+
+} // namespace
+
+
+// With no flux boundaries, water is only moved between cells, and the
+// change in each cell is the sum of the fluxes across its faces.
+TEST(DIFFUSION_WAVE_CONSERVES_WATER) {
+  Epetra_SerialComm comm;
+  Epetra_Map map(N, 0, comm);
+  auto sub = createRow(map, 8);
+
+  Epetra_MultiVector wc0(map, 1);
+  initialWaterContent(wc0);
+  sub->StartStep(wc0);
+  advance(*sub, 0., 3600.);
+
+  const Epetra_Vector& wc = sub->water_content();
+  double total0 = 5 * 0.2 * nl * dx;
+  CHECK_CLOSE(total0, total(wc), 1.e-12 * total0);
+
+  std::vector<double> change(N, 0.);
+  change[0] += sub->flux_sum(0);
+  for (int f=1; f!=N; ++f) {
+    change[f-1] -= sub->flux_sum(f);
+    change[f] += sub->flux_sum(f);
+  }
+  change[N-1] -= sub->flux_sum(N);
+  for (int c=0; c!=N; ++c) {
+    CHECK(wc[c] >= 0.);
+    CHECK_CLOSE(wc[c] - wc0[0][c], change[c], 1.e-10 * total0);
+  }
+
+  // water has run downhill
+  CHECK(wc[15] > 0.);
+  CHECK(wc[2] < wc[15]);
+  CHECK_EQUAL(0., sub->flux_sum(0));
+  CHECK_EQUAL(0., sub->flux_sum(N));
+}
+
+
+// Water leaving through a critical depth boundary is the flux across it.
+TEST(DIFFUSION_WAVE_OUTFLOW) {
+  Epetra_SerialComm comm;
+  Epetra_Map map(N, 0, comm);
+  auto sub = createRow(map, 8);
+  sub->SetBoundaryCondition(N, DiffusionWaveSubcycler::BC_CRITICAL_DEPTH);
+
+  Epetra_MultiVector wc0(map, 1);
+  initialWaterContent(wc0);
+  sub->StartStep(wc0);
+  advance(*sub, 0., 6. * 3600.);
+
+  const Epetra_Vector& wc = sub->water_content();
+  double total0 = 5 * 0.2 * nl * dx;
+  double outflow = sub->flux_sum(N);
+  CHECK(outflow > 0.);
+  CHECK_CLOSE(total0, total(wc) + outflow, 1.e-12 * total0);
+}
+
+
+// Local time stepping updates fewer faces than a single level, for nearly
+// the same result.
+TEST(DIFFUSION_WAVE_LOCAL_TIME_STEPPING) {
+  Epetra_SerialComm comm;
+  Epetra_Map map(N, 0, comm);
+  Epetra_MultiVector wc0(map, 1);
+  initialWaterContent(wc0);
+
+  auto sub_global = createRow(map, 0);
+  sub_global->StartStep(wc0);
+  long nupdates_global = advance(*sub_global, 0., 3600.);
+
+  auto sub_local = createRow(map, 8);
+  sub_local->StartStep(wc0);
+  long nupdates_local = advance(*sub_local, 0., 3600.);
+
+  CHECK(nupdates_local < nupdates_global);
+
+  double total0 = 5 * 0.2 * nl * dx;
+  double diff = 0.;
+  for (int c=0; c!=N; ++c)
+    diff += std::abs(sub_local->water_content()[c] - sub_global->water_content()[c]);
+  CHECK(diff < 0.01 * total0);
+}
@@ -0,0 +1,178 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of the Jacobian-free Newton-Krylov correction, right
+preconditioned GMRES with finite difference Jacobian actions.
+------------------------------------------------------------------------- */
+
+#include <cmath>
+
+#include "dbc.hh"
+#include "jacobian_free_newton_krylov.hh"
+
+namespace Amanzi {
+
+JacobianFreeNewtonKrylov::JacobianFreeNewtonKrylov(Teuchos::ParameterList& plist,
+        BDFFnBase<TreeVector>* fn) :
+    fn_(fn),
+    active_(false),
+    num_itrs_(0),
+    t_old_(0.),
+    t_new_(0.),
+    u_norm_(0.)
+{
+  max_itrs_ = plist.get<int>("maximum iterations", 20);
+  tol_ = plist.get<double>("tolerance", 1.e-4);
+  fd_eps_ = plist.get<double>("finite difference epsilon", 1.e-8);
+
+  H_.resize((max_itrs_+1) * max_itrs_);
+  cs_.resize(max_itrs_);
+  sn_.resize(max_itrs_);
+  g_.resize(max_itrs_+1);
+}
+
+
+void JacobianFreeNewtonKrylov::SetBasePoint(double t_old, double t_new,
+        const Teuchos::RCP<TreeVector>& u_old,
+        const Teuchos::RCP<TreeVector>& u_new,
+        const TreeVector& r)
+{
+  t_old_ = t_old;
+  t_new_ = t_new;
+  u_old_ = u_old;
+  u_new_ = u_new;
+  u_norm_ = -1.;
+
+  // workspace, allocated once
+  if (r0_ == Teuchos::null) {
+    r0_ = Teuchos::rcp(new TreeVector(r));
+    u_pert_ = Teuchos::rcp(new TreeVector(*u_new));
+    z_ = Teuchos::rcp(new TreeVector(*u_new));
+    V_.resize(max_itrs_+1);
+    for (auto& v : V_) v = Teuchos::rcp(new TreeVector(r));
+  }
+  *r0_ = r;
+}
+
+
+// -----------------------------------------------------------------------------
+// Jv = (r(u + eps v) - r(u)) / eps
+// -----------------------------------------------------------------------------
+void JacobianFreeNewtonKrylov::JacobianAction_(const TreeVector& v,
+        const Teuchos::RCP<TreeVector>& Jv)
+{
+  double v_norm(0.);
+  v.Norm2(&v_norm);
+  if (v_norm == 0.) {
+    Jv->PutScalar(0.);
+    return;
+  }
+
+  if (u_norm_ < 0.) u_new_->Norm2(&u_norm_);
+  double eps = fd_eps_ * (1. + u_norm_) / v_norm;
+  u_pert_->Update(1., *u_new_, eps, v, 0.);
+  fn_->ChangedSolution();
+  fn_->FunctionalResidual(t_old_, t_new_, u_old_, u_pert_, Jv);
+  Jv->Update(-1./eps, *r0_, 1./eps);
+}
+
+
+// -----------------------------------------------------------------------------
+// GMRES, with Givens rotations, on J x = u; Pu = P^-1 x.
+// -----------------------------------------------------------------------------
+int JacobianFreeNewtonKrylov::ApplyInverse(const Teuchos::RCP<const TreeVector>& u,
+        const Teuchos::RCP<TreeVector>& Pu)
+{
+  AMANZI_ASSERT(r0_ != Teuchos::null);
+  active_ = true;
+  int m1 = max_itrs_ + 1;
+
+  double beta(0.);
+  u->Norm2(&beta);
+  num_itrs_ = 0;
+  if (beta == 0.) {
+    Pu->PutScalar(0.);
+    active_ = false;
+    return 0;
+  }
+
+  V_[0]->Update(1./beta, *u, 0.);
+  g_.assign(m1, 0.);
+  g_[0] = beta;
+
+  int ierr = 0;
+  bool converged = false;
+  bool perturbed = false;
+  int k = 0;
+  while (k < max_itrs_) {
+    // w = J P^-1 v_k
+    ierr = fn_->ApplyPreconditioner(V_[k], z_);
+    if (ierr) break;
+    perturbed = true;
+    JacobianAction_(*z_, V_[k+1]);
+
+    // modified Gram-Schmidt
+    for (int i=0; i<=k; ++i) {
+      double h;
+      V_[k+1]->Dot(*V_[i], &h);
+      H_[i + k*m1] = h;
+      V_[k+1]->Update(-h, *V_[i], 1.);
+    }
+    double h_next(0.);
+    V_[k+1]->Norm2(&h_next);
+    H_[k+1 + k*m1] = h_next;
+    if (h_next > 0.) V_[k+1]->Scale(1./h_next);
+
+    // apply the previous rotations, then eliminate the subdiagonal
+    for (int i=0; i<k; ++i) {
+      double tmp = cs_[i] * H_[i + k*m1] + sn_[i] * H_[i+1 + k*m1];
+      H_[i+1 + k*m1] = -sn_[i] * H_[i + k*m1] + cs_[i] * H_[i+1 + k*m1];
+      H_[i + k*m1] = tmp;
+    }
+    double denom = std::sqrt(H_[k + k*m1]*H_[k + k*m1] + h_next*h_next);
+    if (denom == 0.) break;
+    cs_[k] = H_[k + k*m1] / denom;
+    sn_[k] = h_next / denom;
+    H_[k + k*m1] = denom;
+    H_[k+1 + k*m1] = 0.;
+    g_[k+1] = -sn_[k] * g_[k];
+    g_[k] = cs_[k] * g_[k];
+    k++;
+
+    if (std::abs(g_[k]) <= tol_ * beta || h_next == 0.) {
+      converged = true;
+      break;
+    }
+  }
+  num_itrs_ = k;
+
+  if (!ierr) {
+    // y = H^-1 g, overwriting g
+    for (int i=k-1; i>=0; --i) {
+      for (int j=i+1; j<k; ++j) g_[i] -= H_[i + j*m1] * g_[j];
+      g_[i] /= H_[i + i*m1];
+    }
+
+    // Pu = P^-1 V y, with z as the sum
+    z_->PutScalar(0.);
+    for (int i=0; i<k; ++i) z_->Update(g_[i], *V_[i], 1.);
+    ierr = fn_->ApplyPreconditioner(z_, Pu);
+  }
+
+  // restore the state of the base point
+  if (perturbed) {
+    fn_->ChangedSolution();
+    fn_->FunctionalResidual(t_old_, t_new_, u_old_, u_new_, V_[0]);
+  }
+
+  active_ = false;
+  if (ierr) return ierr;
+  return converged ? 0 : 1;
+}
+
+} // namespace Amanzi
@@ -0,0 +1,124 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A Jacobian-free Newton-Krylov correction that uses a PK's assembled operator as the preconditioner.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+The Newton correction solves :math:`J \delta u = r`, where :math:`r` is the
+residual at the current iterate.  PKs normally replace :math:`J` by the
+approximate Jacobian they assemble, and so converge only as well as that
+approximation allows; couplers such as the `Subsurface MPC`_ assemble
+several off-diagonal blocks to improve it.
+
+In Jacobian-free mode, the correction is instead computed by right
+preconditioned GMRES on the true Jacobian, whose action is approximated by a
+finite difference of the residual:
+
+.. math::
+    J v \approx \frac{r(u + \epsilon v) - r(u)}{\epsilon}, \quad
+    \epsilon = \epsilon_{FD} \frac{1 + |u|}{|v|}
+
+The PK's assembled operator is only used as the preconditioner, so it may
+omit expensive terms; for the `Subsurface MPC`_, `"preconditioner type`" of
+`"block diagonal`" skips all off-diagonal assembly.  Each Krylov iteration
+costs one residual evaluation and one application of the assembled
+preconditioner.  Krylov and residual workspace is allocated on the first
+correction and reused after that.  If GMRES does not reach its tolerance
+within the maximum iterations, or the preconditioner fails, the correction
+reports the failure to the nonlinear solver.
+
+Use this with the `"Newton`" nonlinear solver in the time integrator.  Unlike
+the `"JFNK`" solver, which wraps the nonlinear solver, this lives inside the
+PK's ApplyPreconditioner(), so the time integrator's preconditioner lagging
+and the PK's preconditioner are used unchanged.
+
+.. _jacobian-free-newton-krylov-spec:
+.. admonition:: jacobian-free-newton-krylov-spec
+
+    * `"maximum iterations`" ``[int]`` **20** Maximum number of Krylov
+      iterations, which is also the size of the Krylov basis.
+
+    * `"tolerance`" ``[double]`` **1.e-4** Relative reduction of the linear
+      residual at which GMRES stops.
+
+    * `"finite difference epsilon`" ``[double]`` **1.e-8** Relative
+      perturbation, :math:`\epsilon_{FD}` above.
+
+*/
+
+#ifndef ATS_JACOBIAN_FREE_NEWTON_KRYLOV_HH_
+#define ATS_JACOBIAN_FREE_NEWTON_KRYLOV_HH_
+
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ParameterList.hpp"
+
+#include "TreeVector.hh"
+#include "BDFFnBase.hh"
+
+namespace Amanzi {
+
+class JacobianFreeNewtonKrylov {
+
+ public:
+  JacobianFreeNewtonKrylov(Teuchos::ParameterList& plist,
+                           BDFFnBase<TreeVector>* fn);
+
+  // Records the arguments and result of the most recent residual evaluation,
+  // the point at which the Jacobian is approximated.
+  void SetBasePoint(double t_old, double t_new,
+                    const Teuchos::RCP<TreeVector>& u_old,
+                    const Teuchos::RCP<TreeVector>& u_new,
+                    const TreeVector& r);
+
+  // Pu = J^-1 u, preconditioned by fn->ApplyPreconditioner().  Returns 0 if
+  // GMRES reached its tolerance, and nonzero if it did not or if the
+  // preconditioner failed.  Unless the preconditioner failed, Pu is the last
+  // GMRES iterate either way.
+  int ApplyInverse(const Teuchos::RCP<const TreeVector>& u,
+                   const Teuchos::RCP<TreeVector>& Pu);
+
+  // True while a correction is being computed.  The PK's residual and
+  // preconditioner must then behave as they would without this.
+  bool active() const { return active_; }
+
+  // Krylov iterations in the most recent correction.
+  int num_itrs() const { return num_itrs_; }
+
+ private:
+  void JacobianAction_(const TreeVector& v, const Teuchos::RCP<TreeVector>& Jv);
+
+ private:
+  BDFFnBase<TreeVector>* fn_;
+  int max_itrs_;
+  double tol_;
+  double fd_eps_;
+
+  bool active_;
+  int num_itrs_;
+
+  // base point
+  double t_old_, t_new_;
+  Teuchos::RCP<TreeVector> u_old_;
+  Teuchos::RCP<TreeVector> u_new_;
+  double u_norm_; // of u_new_, computed on first use, or -1
+
+  // workspace
+  Teuchos::RCP<TreeVector> r0_;
+  Teuchos::RCP<TreeVector> u_pert_;
+  Teuchos::RCP<TreeVector> z_;
+  std::vector<Teuchos::RCP<TreeVector> > V_;
+  std::vector<double> H_, cs_, sn_, g_;
+};
+
+} // namespace Amanzi
+
+#endif
@@ -146,7 +146,15 @@ int MPCCoupledCells::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuch
     vecs.push_back(u->SubVector(1)->Data().ptr()); 
     db_->WriteVectors(vnames, vecs, true);
   }
-  
+
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_->active()) {
+    int ierr = jfnk_->ApplyInverse(u, Pu);
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  JFNK iterations: " << jfnk_->num_itrs() << std::endl;
+    return ierr;
+  }
+
   int ierr = preconditioner_->ApplyInverse(*u, *Pu);
 
   if (vo_->os_OK(Teuchos::VERB_HIGH)) {
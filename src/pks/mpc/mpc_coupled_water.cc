@@ -131,6 +131,10 @@ MPCCoupledWater::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<Tre
 
   // All surface to subsurface fluxes have been taken by the subsurface.
   g->SubVector(1)->Data()->ViewComponent("cell",false)->PutScalar(0.);
+
+  // the point at which a Jacobian-free correction linearizes
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    jfnk_->SetBasePoint(t_old, t_new, u_old, u_new, *g);
 }
 
 // -- Apply preconditioner to u and returns the result in Pu.
@@ -140,6 +144,14 @@ int MPCCoupledWater::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
   if (vo_->os_OK(Teuchos::VERB_EXTREME))
     *vo_->os() << "Precon application:" << std::endl;
 
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_->active()) {
+    int ierr = jfnk_->ApplyInverse(u, Pu);
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  JFNK iterations: " << jfnk_->num_itrs() << std::endl;
+    return ierr;
+  }
+
   // call the precon's inverse
   if (vo_->os_OK(Teuchos::VERB_EXTREME))
     *vo_->os() << "Precon applying subsurface operator." << std::endl;
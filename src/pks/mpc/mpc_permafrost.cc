@@ -270,6 +270,10 @@ MPCPermafrost::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<TreeV
 
   // All energy fluxes have been taken by the subsurface.
   g->SubVector(3)->Data()->ViewComponent("cell",false)->PutScalar(0.);
+
+  // the point at which a Jacobian-free correction linearizes
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    jfnk_->SetBasePoint(t_old, t_new, u_old, u_new, *g);
 }
 
 // -- Apply preconditioner
@@ -298,6 +302,14 @@ int MPCPermafrost::ApplyPreconditioner(Teuchos::RCP<const TreeVector> r,
     domain_db_->WriteVectors(vnames, vecs, true);
   }
 
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_->active()) {
+    int ierr = jfnk_->ApplyInverse(r, Pr);
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  JFNK iterations: " << jfnk_->num_itrs() << std::endl;
+    return ierr;
+  }
+
   // make a new TreeVector that is just the subsurface values (by pointer).
   // -- note these const casts are necessary to create the new TreeVector, but
   // since the TreeVector COULD be const (it is only used in a single method,
@@ -700,11 +700,13 @@ void MPCSubsurface::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector
     dE_dp_->AddAccumulationTerm(*dE_dp, h, "cell", false);
 
     // write for debugging
-    std::vector<std::string> vnames;
-    vnames.push_back("  dwc_dT"); vnames.push_back("  de_dp");
-    std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
-    vecs.push_back(dWC_dT.ptr()); vecs.push_back(dE_dp.ptr());
-    db_->WriteVectors(vnames, vecs, false);
+    if (sub_pks_[0]->debugging()) {
+      std::vector<std::string> vnames;
+      vnames.push_back("  dwc_dT"); vnames.push_back("  de_dp");
+      std::vector< Teuchos::Ptr<const CompositeVector> > vecs;
+      vecs.push_back(dWC_dT.ptr()); vecs.push_back(dE_dp.ptr());
+      db_->WriteVectors(vnames, vecs, false);
+    }
 
   }
 
@@ -725,7 +727,7 @@ int MPCSubsurface::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
     *vo_->os() << "Precon application:" << std::endl;
 
   // write residuals
-  if (vo_->os_OK(Teuchos::VERB_HIGH)) {
+  if (vo_->os_OK(Teuchos::VERB_HIGH) && sub_pks_[0]->debugging()) {
     *vo_->os() << "Residuals:" << std::endl;
     std::vector<std::string> vnames;
     vnames.push_back("  r_p"); vnames.push_back("  r_T");
@@ -735,6 +737,14 @@ int MPCSubsurface::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
     db_->WriteVectors(vnames, vecs, true);
   }
 
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_->active()) {
+    int ierr = jfnk_->ApplyInverse(u, Pu);
+    if (vo_->os_OK(Teuchos::VERB_HIGH))
+      *vo_->os() << "  JFNK iterations: " << jfnk_->num_itrs() << std::endl;
+    return ierr;
+  }
+
   int ierr = 0;
   if (precon_type_ == PRECON_NONE) {
     *Pu = *u;
@@ -777,7 +787,7 @@ int MPCSubsurface::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u,
 
   }
 
-  if (vo_->os_OK(Teuchos::VERB_HIGH)) {
+  if (vo_->os_OK(Teuchos::VERB_HIGH) && sub_pks_[0]->debugging()) {
     *vo_->os() << "PC * residuals:" << std::endl;
     std::vector<std::string> vnames;
     vnames.push_back("  PC*r_p"); vnames.push_back("  PC*r_T");
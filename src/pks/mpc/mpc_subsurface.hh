@@ -104,6 +104,12 @@ except in expert cases or for comparison's sake, but the options are:
   hope.
 
 
+With a `"Jacobian-free Newton-Krylov`" sublist (see `PK: BDF`_), the
+correction uses finite difference actions of the full coupled Jacobian, and
+the preconditioner chosen here is only a preconditioner.  Then `"block
+diagonal`" is usually sufficient, and avoids assembling the off-diagonal
+blocks entirely.
+
 Note this "ewc" algorithm is just as valid, and more useful, in the predictor
 (where it is not deprecated/disabled).  There, we extrapolate a change in
 pressure and temperature, but often do better to extrapolate in water content
@@ -29,6 +29,7 @@ Globally implicit coupling solves all sub-PKs as a single system of equations.
 
 #include "mpc.hh"
 #include "pk_bdf_default.hh"
+#include "timer_tree.hh"
 
 namespace Amanzi {
 
@@ -60,6 +61,10 @@ public:
   void set_states(const Teuchos::RCP<State>& S,
                   const Teuchos::RCP<State>& S_inter,
                   const Teuchos::RCP<State>& S_next);
+
+  // -- Collect the sub-PKs stored time derivatives, for restart.
+  virtual void State_to_SolutionDot(const Teuchos::Ptr<State>& S,
+          TreeVector& soln_dot);
   
   // StrongMPC is a BDFFnBase
   // -- computes the non-linear functional g = g(t,u,udot)
@@ -76,6 +81,8 @@ public:
   // -- Apply preconditioner to u and returns the result in Pu.
   virtual int ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu);
 
+  virtual bool SupportsJacobianFree() const { return true; }
+
   // -- Update the preconditioner.
   virtual void UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h);
 
@@ -182,12 +189,24 @@ void StrongMPC<PK_t>::set_states(const Teuchos::RCP<State>& S,
   MPC<PK_t>::set_states(S,S_inter,S_next);
 } 
 
+// -----------------------------------------------------------------------------
+// Loop over sub-PKs, collecting their stored time derivatives.
+// -----------------------------------------------------------------------------
+template<class PK_t>
+void StrongMPC<PK_t>::State_to_SolutionDot(const Teuchos::Ptr<State>& S,
+        TreeVector& soln_dot) {
+  for (unsigned int i=0; i!=sub_pks_.size(); ++i) {
+    sub_pks_[i]->State_to_SolutionDot(S, *soln_dot.SubVector(i));
+  }
+}
+
 // -----------------------------------------------------------------------------
 // Compute the non-linear functional g = g(t,u,udot).
 // -----------------------------------------------------------------------------
 template<class PK_t>
 void StrongMPC<PK_t>::FunctionalResidual(double t_old, double t_new, Teuchos::RCP<TreeVector> u_old,
                     Teuchos::RCP<TreeVector> u_new, Teuchos::RCP<TreeVector> g) {
+  TimerTree::Scope timer(name_, "FunctionalResidual");
 
   Solution_to_State(*u_new, S_next_);
 
@@ -220,6 +239,10 @@ void StrongMPC<PK_t>::FunctionalResidual(double t_old, double t_new, Teuchos::RC
     // fill the nonlinear function with each sub-PKs contribution
     sub_pks_[i]->FunctionalResidual(t_old, t_new, pk_u_old, pk_u_new, pk_g);
   }
+
+  // the point at which a Jacobian-free correction linearizes
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    jfnk_->SetBasePoint(t_old, t_new, u_old, u_new, *g);
 };
 
 
@@ -228,6 +251,12 @@ void StrongMPC<PK_t>::FunctionalResidual(double t_old, double t_new, Teuchos::RC
 // -----------------------------------------------------------------------------
 template<class PK_t>
 int StrongMPC<PK_t>::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu) {
+  TimerTree::Scope timer(name_, "ApplyPreconditioner");
+
+  // Jacobian-free correction, which calls back into this method
+  if (jfnk_ != Teuchos::null && !jfnk_->active())
+    return jfnk_->ApplyInverse(u, Pu);
+
   // loop over sub-PKs
   int ierr = 0;
   for (unsigned int i=0; i!=sub_pks_.size(); ++i) {
@@ -264,6 +293,7 @@ int StrongMPC<PK_t>::ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuch
 template<class PK_t>
 double StrongMPC<PK_t>::ErrorNorm(Teuchos::RCP<const TreeVector> u,
                         Teuchos::RCP<const TreeVector> du){
+  TimerTree::Scope timer(name_, "ErrorNorm");
   double norm = 0.0;
 
   // loop over sub-PKs
@@ -295,7 +325,8 @@ double StrongMPC<PK_t>::ErrorNorm(Teuchos::RCP<const TreeVector> u,
 // -----------------------------------------------------------------------------
 template<class PK_t>
 void StrongMPC<PK_t>::UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h) {
-  
+  TimerTree::Scope timer(name_, "UpdatePreconditioner");
+
   Solution_to_State(*up, S_next_);
 
   // loop over sub-PKs
@@ -12,6 +12,7 @@ sub-PKs, calling their advance() methods and returning failure if any fail.
 See additional documentation in the base class src/pks/mpc/MPC.hh
 ------------------------------------------------------------------------- */
 
+#include "timer_tree.hh"
 #include "weak_mpc.hh"
 
 namespace Amanzi {
@@ -53,6 +54,7 @@ void WeakMPC::set_dt( double dt) {
 // Advance each sub-PK individually.
 // -----------------------------------------------------------------------------
 bool WeakMPC::AdvanceStep(double t_old, double t_new, bool reinit) {
+  TimerTree::Scope timer(name_, "AdvanceStep");
   bool fail = false;
   for (MPC<PK>::SubPKList::iterator pk = sub_pks_.begin();
        pk != sub_pks_.end(); ++pk) {
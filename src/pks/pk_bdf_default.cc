@@ -14,6 +14,8 @@ BDF.
 #include "BDF1_TI.hh"
 #include "pk_bdf_default.hh"
 #include "State.hh"
+#include "errors.hh"
+#include "timer_tree.hh"
 
 namespace Amanzi {
 
@@ -29,6 +31,19 @@ void PK_BDF_Default::Setup(const Teuchos::Ptr<State>& S)
   // preconditioner assembly
   assemble_preconditioner_ = plist_->get<bool>("assemble preconditioner", true);
 
+  if (plist_->isSublist("Jacobian-free Newton-Krylov")) {
+    if (!SupportsJacobianFree()) {
+      Errors::Message msg;
+      msg << "PK \"" << name_ << "\" does not support the \"Jacobian-free Newton-Krylov\" correction.";
+      Exceptions::amanzi_throw(msg);
+    }
+    if (plist_->get<bool>("strongly coupled PK", false)) {
+      Errors::Message msg;
+      msg << "PK \"" << name_ << "\" is strongly coupled: the \"Jacobian-free Newton-Krylov\" correction must be provided to the coupling MPC.";
+      Exceptions::amanzi_throw(msg);
+    }
+  }
+
   if (!plist_->get<bool>("strongly coupled PK", false)) {
     Teuchos::ParameterList& bdf_plist = plist_->sublist("time integrator");
     // -- check if continuation method
@@ -36,6 +51,16 @@ void PK_BDF_Default::Setup(const Teuchos::Ptr<State>& S)
     if (bdf_plist.isSublist("continuation parameters")) {
       S->RequireScalar("continuation_parameter", name_);
     }
+
+    // -- time step size, checkpointed for restart
+    dt_key_ = Keys::getKey(name_, "dt");
+    S->RequireScalar(dt_key_, name_);
+
+    // -- Jacobian-free correction
+    if (plist_->isSublist("Jacobian-free Newton-Krylov")) {
+      jfnk_ = Teuchos::rcp(new JacobianFreeNewtonKrylov(
+          plist_->sublist("Jacobian-free Newton-Krylov"), this));
+    }
   }
 };
 
@@ -64,6 +89,20 @@ void PK_BDF_Default::Initialize(const Teuchos::Ptr<State>& S)
     Teuchos::RCP<TreeVector> solution_dot = Teuchos::rcp(new TreeVector(*solution_));
     solution_dot->PutScalar(0.0);
 
+    // -- if restarting, the time step size and time derivative were read
+    //    from the checkpoint
+    Teuchos::RCP<Field> dt_field = S->GetField(dt_key_, name_);
+    if (dt_field->initialized()) {
+      double dt_restart = *dt_field->GetScalarData();
+      if (dt_restart > 0.) {
+        dt_ = dt_restart;
+        State_to_SolutionDot(S, *solution_dot);
+      }
+    } else {
+      *S->GetScalarData(dt_key_, name_) = dt_;
+      dt_field->set_initialized();
+    }
+
     // -- set initial state
     time_stepper_->SetInitialState(S->time(), solution_, solution_dot);
   }
@@ -91,8 +130,12 @@ void PK_BDF_Default::set_dt(double dt) {dt_ = dt;}
 void PK_BDF_Default::CommitStep(double t_old, double t_new, const Teuchos::RCP<State>& S) \
 {
   double dt = t_new -t_old;
-  if (dt > 0. && time_stepper_ != Teuchos::null)
+  if (dt > 0. && time_stepper_ != Teuchos::null) {
     time_stepper_->CommitSolution(dt, solution_, true);
+
+    // store the recommended next step size for restart
+    *S->GetScalarData(dt_key_, name_) = dt_;
+  }
 }
 
 void PK_BDF_Default::set_states(const Teuchos::RCP<State>& S,
@@ -110,6 +153,7 @@ void PK_BDF_Default::set_states(const Teuchos::RCP<State>& S,
 // -----------------------------------------------------------------------------
 bool PK_BDF_Default::AdvanceStep(double t_old, double t_new, bool reinit)
 {
+  TimerTree::Scope timer(name_, "AdvanceStep");
   double dt = t_new -t_old;
   Teuchos::OSTab out = vo_->getOSTab();
 
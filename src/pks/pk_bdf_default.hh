@@ -32,6 +32,19 @@ PKs.
     * `"inverse`" ``[inverse-typed-spec]`` **optional** A Preconditioner_.
       Note that this is only used if this PK is not strongly coupled to other PKs.
 
+    * `"Jacobian-free Newton-Krylov`" ``[jacobian-free-newton-krylov-spec]``
+      **optional** If provided, and this PK is not strongly coupled to other
+      PKs, the correction uses finite difference Jacobian actions and this
+      PK's preconditioner only as a preconditioner.  See
+      JacobianFreeNewtonKrylov.  Supported by the Richards, energy, and
+      strong MPC families of PKs; it is an error to provide it to any other
+      PK, or to a strongly coupled PK.
+
+The time step size and the time derivative of the solution from the most
+recent step are stored in checkpoints.  On restart, these restore the time
+integrator's predictor history and the step size, so that the restarted run
+continues as if it had not been interrupted.
+
     INCLUDES:
 
     - ``[pk-spec]`` This *is a* PK_.
@@ -45,9 +58,11 @@ PKs.
 
 #include "Teuchos_TimeMonitor.hpp"
 
+#include "Key.hh"
 #include "BDFFnBase.hh"
 #include "BDF1_TI.hh"
 #include "PK_BDF.hh"
+#include "jacobian_free_newton_krylov.hh"
 
 
 
@@ -80,6 +95,12 @@ class PK_BDF_Default : public PK_BDF {
 
   virtual void set_dt(double dt_);
 
+  // -- Nonlinear iterations taken by the most recent step, or -1 if this PK
+  //    is not integrated by its own time integrator.
+  int number_nonlinear_steps() {
+    return time_stepper_ == Teuchos::null ? -1 : time_stepper_->number_nonlinear_steps();
+  }
+
   // -- Advance from state S0 to state S1 at time S0.time + dt.
   virtual bool AdvanceStep(double t_old, double t_new, bool reinit);
 
@@ -116,12 +137,22 @@ class PK_BDF_Default : public PK_BDF {
 
   virtual void ResetTimeStepper(double time);
 
+  // -- Copy the time derivative of the solution, as stored in State for
+  //    restart, into soln_dot.  By default, leaves soln_dot unchanged.
+  virtual void State_to_SolutionDot(const Teuchos::Ptr<State>& S,
+          TreeVector& soln_dot) {}
+
   // experimental approach -- calling this indicates that the time
   // integration scheme is changing the value of the solution in
   // state.
   virtual void ChangedSolution() = 0;
   virtual void ChangedSolution(const Teuchos::Ptr<State>& S) = 0;
 
+  // -- Does this PK's correction use the Jacobian-free Newton-Krylov
+  //    correction when one is given?  PKs which override FunctionalResidual()
+  //    or ApplyPreconditioner() must opt in, as they must call it.
+  virtual bool SupportsJacobianFree() const { return false; }
+
  
  protected: // data
   // preconditioner assembly control
@@ -129,8 +160,12 @@ class PK_BDF_Default : public PK_BDF {
 
   // timestep control
   double dt_;
+  Key dt_key_;
   Teuchos::RCP<BDF1_TI<TreeVector, TreeVectorSpace> > time_stepper_;
 
+  // Jacobian-free correction, if used
+  Teuchos::RCP<JacobianFreeNewtonKrylov> jfnk_;
+
   // timing
   Teuchos::RCP<Teuchos::Time> step_walltime_;
 
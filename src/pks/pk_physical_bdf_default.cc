@@ -13,6 +13,7 @@ PKPhysicalBase and BDF methods of PK_BDF_Default.
 #include "boost/math/special_functions/fpclassify.hpp"
 
 #include "pk_physical_bdf_default.hh"
+#include "timer_tree.hh"
 
 namespace Amanzi {
 
@@ -44,10 +45,23 @@ void PK_PhysicalBDF_Default::Setup(const Teuchos::Ptr<State>& S) {
   S->RequireField(cell_vol_key_)->SetMesh(mesh_)
       ->AddComponent("cell",AmanziMesh::CELL,true);
   S->RequireFieldEvaluator(cell_vol_key_);
+
+  // time derivative of the primary variable, checkpointed for restart
+  dudt_key_ = Keys::getKey(domain_, Keys::getVarName(key_)+"_bdf_time_derivative");
+  S->RequireField(dudt_key_, name_)->SetMesh(mesh_)->SetGhosted(false)
+      ->AddComponent("cell",AmanziMesh::CELL,1);
+  S->GetField(dudt_key_, name_)->set_io_vis(false);
   
   atol_ = plist_->get<double>("absolute error tolerance",1.0);
   rtol_ = plist_->get<double>("relative error tolerance",1.0);
   fluxtol_ = plist_->get<double>("flux error tolerance",1.0);
+
+  // reuse of the preconditioner across iterations
+  if (plist_->isSublist("preconditioner reuse") &&
+      !plist_->get<bool>("strongly coupled PK", false)) {
+    precon_lag_ = Teuchos::rcp(new PreconditionerLag(plist_->sublist("preconditioner reuse")));
+    deformable_mesh_ = S->IsDeformableMesh(domain_);
+  }
 };
 
 
@@ -62,8 +76,72 @@ void PK_PhysicalBDF_Default::Initialize(const Teuchos::Ptr<State>& S) {
 
 
   PK_Physical_Default::Initialize(S);
+
+  // The time derivative is initialized if it was read from a checkpoint.
+  // Checkpoints written before it was stored lack it, in which case the
+  // restart starts from a zero time derivative, as it always did.
+  Teuchos::RCP<Field> dudt_field = S->GetField(dudt_key_, name_);
+  if (!dudt_field->initialized()) {
+    // the step size, stored alongside, was read if this is a restart
+    if (!dt_key_.empty() && S->GetField(dt_key_)->initialized() &&
+        vo_->os_OK(Teuchos::VERB_LOW)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      *vo_->os() << "Checkpoint has no \"" << dudt_key_
+                 << "\", restarting with a zero time derivative." << std::endl;
+    }
+    dudt_field->GetFieldData()->PutScalar(0.);
+    dudt_field->set_initialized();
+  }
+
   PK_BDF_Default::Initialize(S);
 
+  u_committed_ = Teuchos::rcp(new Epetra_MultiVector(
+      *S->GetFieldData(key_)->ViewComponent("cell",false)));
+}
+
+
+// -----------------------------------------------------------------------------
+// Commit the step, and store the time derivative of the primary variable.
+// This is used to restore the time integrator's history on restart.
+//
+// The derivative is differenced from the solution at the previous commit,
+// kept by the PK, rather than from S_inter_, which is not the start of the
+// step when the coordinator subcycles or the PK is substepped by an MPC.
+// -----------------------------------------------------------------------------
+void PK_PhysicalBDF_Default::CommitStep(double t_old, double t_new,
+        const Teuchos::RCP<State>& S) {
+  PK_BDF_Default::CommitStep(t_old, t_new, S);
+
+  const Epetra_MultiVector& u_new = *S->GetFieldData(key_)->ViewComponent("cell",false);
+  if (u_committed_ != Teuchos::null) {
+    double dt = t_new - t_old;
+    if (dt > 0.) {
+      Epetra_MultiVector& dudt = *S->GetFieldData(dudt_key_, name_)->ViewComponent("cell",false);
+      dudt.Update(1./dt, u_new, -1./dt, *u_committed_, 0.);
+    }
+    *u_committed_ = u_new;
+  }
+
+  if (precon_lag_ != Teuchos::null) {
+    if (vo_->os_OK(Teuchos::VERB_MEDIUM)) {
+      Teuchos::OSTab tab = vo_->getOSTab();
+      *vo_->os() << "Preconditioner rebuilds: " << precon_lag_->step_rebuilds()
+                 << ", reuses: " << precon_lag_->step_reuses() << " this step ("
+                 << precon_lag_->rebuilds() << ", " << precon_lag_->reuses()
+                 << " in total)" << std::endl;
+    }
+    precon_lag_->ResetStepCounts();
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+// Copy the stored time derivative into the cell component of soln_dot.
+// -----------------------------------------------------------------------------
+void PK_PhysicalBDF_Default::State_to_SolutionDot(const Teuchos::Ptr<State>& S,
+        TreeVector& soln_dot) {
+  *soln_dot.Data()->ViewComponent("cell",false) =
+      *S->GetFieldData(dudt_key_)->ViewComponent("cell",false);
 }
 
 
@@ -72,6 +150,8 @@ void PK_PhysicalBDF_Default::Initialize(const Teuchos::Ptr<State>& S) {
 // -----------------------------------------------------------------------------
 double PK_PhysicalBDF_Default::ErrorNorm(Teuchos::RCP<const TreeVector> u,
         Teuchos::RCP<const TreeVector> res) {
+  TimerTree::Scope timer(name_, "ErrorNorm");
+
   // Abs tol based on old conserved quantity -- we know these have been vetted
   // at some level whereas the new quantity is some iterate, and may be
   // anything from negative to overflow.
@@ -167,6 +247,7 @@ double PK_PhysicalBDF_Default::ErrorNorm(Teuchos::RCP<const TreeVector> u,
   int ierr;
   ierr = MPI_Allreduce(&enorm_val_l, &enorm_val, 1, MPI_DOUBLE, MPI_MAX, comm);
   AMANZI_ASSERT(!ierr);
+
   return enorm_val;
 };
 
@@ -305,6 +386,37 @@ void PK_PhysicalBDF_Default::ChangedSolution(const Teuchos::Ptr<State>& S) {
 // -----------------------------------------------------------------------------
 void PK_PhysicalBDF_Default::ChangedSolution() {
   solution_evaluator_->SetFieldAsChanged(S_next_.ptr());
+  if (precon_lag_ != Teuchos::null)
+    precon_lag_->ChangedSolution(S_inter_->time(), S_next_->time(), deformable_mesh_);
+};
+
+
+// -----------------------------------------------------------------------------
+// Storage used by the preconditioner, for memory reporting.  Storage internal
+// to the preconditioner's inverse (e.g. AMG hierarchies) is not included.
+// -----------------------------------------------------------------------------
+void PK_PhysicalBDF_Default::OperatorMemory(std::map<std::string,double>& bytes) const {
+  if (preconditioner_ != Teuchos::null)
+    bytes[name_+" preconditioner"] += OperatorBytes_(*preconditioner_);
+};
+
+
+double PK_PhysicalBDF_Default::OperatorBytes_(Operators::Operator& op) {
+  double bytes = 0.;
+  for (auto lop = op.begin(); lop != op.end(); ++lop) {
+    for (const auto& m : (*lop)->matrices) {
+      bytes += m.NumRows() * m.NumCols() * sizeof(double);
+    }
+    if ((*lop)->diag != Teuchos::null) {
+      bytes += (*lop)->diag->MyLength() * (*lop)->diag->NumVectors() * sizeof(double);
+    }
+  }
+
+  // assembled matrix: values and column indices
+  if (op.A() != Teuchos::null) {
+    bytes += op.A()->NumMyNonzeros() * (sizeof(double) + sizeof(int));
+  }
+  return bytes;
 };
   
 
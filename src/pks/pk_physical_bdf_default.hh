@@ -46,6 +46,12 @@ code, so usually are not supplied by the user.
       flux.  Note that this default is often overridden by PKs with more physical
       values, and very rarely are these set by the user.
 
+    * `"preconditioner reuse`" ``[preconditioner-reuse-spec]`` **optional** If
+      provided, and the PK is not strongly coupled, the assembled
+      preconditioner is reused across nonlinear iterations and time steps
+      until it degrades.  See PreconditionerLag.  Only used by PKs which
+      assemble a preconditioner.
+
     INCLUDES:
 
     - ``[pk-bdf-default-spec]`` *Is a* `PK: BDF`_
@@ -58,9 +64,12 @@ code, so usually are not supplied by the user.
 #ifndef ATS_PK_PHYSICAL_BDF_BASE_HH_
 #define ATS_PK_PHYSICAL_BDF_BASE_HH_
 
+#include <map>
+
 #include "errors.hh"
 #include "pk_bdf_default.hh"
 #include "pk_physical_default.hh"
+#include "preconditioner_lag.hh"
 
 #include "BCs.hh"
 #include "Operator.hh"
@@ -78,7 +87,8 @@ class PK_PhysicalBDF_Default : public PK_BDF_Default,
                           const Teuchos::RCP<TreeVector>& solution):
     PK_BDF_Default(pk_tree, glist, S, solution),
     PK_Physical_Default(pk_tree, glist, S, solution),
-    PK(pk_tree, glist, S, solution)
+    PK(pk_tree, glist, S, solution),
+    deformable_mesh_(false)
   {}
 
 
@@ -111,6 +121,13 @@ class PK_PhysicalBDF_Default : public PK_BDF_Default,
   virtual bool ValidStep() override {
     return PK_Physical_Default::ValidStep() && PK_BDF_Default::ValidStep();
   }
+
+  // -- Commit the step, storing the time derivative for restart.
+  virtual void CommitStep(double t_old, double t_new, const Teuchos::RCP<State>& S) override;
+
+  // -- Copy the stored time derivative of the primary variable.
+  virtual void State_to_SolutionDot(const Teuchos::Ptr<State>& S,
+          TreeVector& soln_dot) override;
   
   // -- Experimental approach -- calling this indicates that the time
   //    integration scheme is changing the value of the solution in
@@ -127,18 +144,31 @@ class PK_PhysicalBDF_Default : public PK_BDF_Default,
   // PC operator access
   Teuchos::RCP<Operators::Operator> preconditioner() { return preconditioner_; }
 
+  // Storage used by operators, in bytes by name, for memory reporting.
+  virtual void OperatorMemory(std::map<std::string,double>& bytes) const;
+
   // BC access
   std::vector<int>& bc_markers() { return bc_->bc_model(); }
   std::vector<double>& bc_values() { return bc_->bc_value(); }
   Teuchos::RCP<Operators::BCs> BCs() { return bc_; }
 
+ protected:
+  static double OperatorBytes_(Operators::Operator& op);
+
  protected:
   // PC
   Teuchos::RCP<Operators::Operator> preconditioner_;
+  Teuchos::RCP<PreconditionerLag> precon_lag_;
+  bool deformable_mesh_;
 
   // BCs
   Teuchos::RCP<Operators::BCs> bc_;
 
+  // time derivative of the primary variable, for restart, and the cells of
+  // the primary variable at the last committed step it is differenced from
+  Key dudt_key_;
+  Teuchos::RCP<Epetra_MultiVector> u_committed_;
+
   // error criteria
   Key conserved_key_;
   Key cell_vol_key_;
@@ -18,7 +18,8 @@ PK_Physical_Default::PK_Physical_Default(Teuchos::ParameterList& pk_tree,
                                          const Teuchos::RCP<State>& S,
                                          const Teuchos::RCP<TreeVector>& solution) :
     PK(pk_tree, glist, S, solution),
-    PK_Physical(pk_tree, glist, S, solution)
+    PK_Physical(pk_tree, glist, S, solution),
+    debugging_(false)
 {
   domain_ = plist_->get<std::string>("domain name", "domain");
   key_ = Keys::readKey(*plist_, domain_, "primary variable");
@@ -51,6 +52,11 @@ void PK_Physical_Default::Setup(const Teuchos::Ptr<State>& S) {
   // set up the debugger
   db_ = Teuchos::rcp(new Debugger(mesh_, name_, *plist_));
 
+  // the debugger only writes for debug cells or faces at high verbosity;
+  // otherwise debug output need not be collected at all
+  debugging_ = (plist_->isParameter("debug cells") || plist_->isParameter("debug faces"))
+      && vo_->getVerbLevel() >= Teuchos::VERB_HIGH;
+
   // require primary variable evaluator
   S->RequireFieldEvaluator(key_);
   Teuchos::RCP<FieldEvaluator> fm = S->GetFieldEvaluator(key_);
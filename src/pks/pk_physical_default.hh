@@ -34,7 +34,9 @@ all leaves of the PK tree will inherit from `PKPhysicalBase`.
     INCLUDES:
 
     - ``[pk-spec]`` This *is a* PK_.
-    - ``[debugger-spec]`` Uses a Debugger_
+    - ``[debugger-spec]`` Uses a Debugger_.  Debug output is only collected
+      when `"debug cells`" or `"debug faces`" is given and the verbosity is
+      `"high`" or more.
 
 */
 
@@ -92,6 +94,10 @@ class PK_Physical_Default : public PK_Physical {
   // -- initialize
   virtual void Initialize(const Teuchos::Ptr<State>& S);
 
+  // -- True if the debugger writes anything.  Names and vectors for debug
+  //    output should only be collected when this is true.
+  bool debugging() const { return debugging_; }
+
  protected: // methods
 
   void DeriveFaceValuesFromCellValues_(const Teuchos::Ptr<CompositeVector>& cv);
@@ -101,6 +107,9 @@ class PK_Physical_Default : public PK_Physical {
   // step validity
   double max_valid_change_;
 
+  // debug output is written
+  bool debugging_;
+
   // ENORM struct
   typedef struct ENorm_t {
     double value;
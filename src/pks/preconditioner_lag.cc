@@ -0,0 +1,108 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of the PreconditionerLag policy.
+------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <cmath>
+
+#include "preconditioner_lag.hh"
+
+namespace Amanzi {
+
+PreconditionerLag::PreconditionerLag(Teuchos::ParameterList& plist) :
+    built_(false),
+    h_built_(0.),
+    uses_(0),
+    base_itrs_(-1),
+    last_itrs_(-1),
+    t_old_(-1.),
+    t_new_(-1.),
+    t_(-1.),
+    last_norm_(-1.),
+    contraction_(0.),
+    rebuilds_(0),
+    reuses_(0),
+    step_rebuilds_(0),
+    step_reuses_(0)
+{
+  max_reuses_ = plist.get<int>("maximum reuses", 10);
+  max_dh_ = plist.get<double>("maximum relative time step change", 0.25);
+  itrs_growth_ = plist.get<double>("linear iteration growth factor", 2.0);
+  max_contraction_ = plist.get<double>("maximum contraction rate", 0.5);
+}
+
+
+// -----------------------------------------------------------------------------
+// Decide whether the current preconditioner is still good enough.
+// -----------------------------------------------------------------------------
+bool PreconditionerLag::Reuse(double h)
+{
+  bool reuse = built_
+      && std::abs(h - h_built_) <= max_dh_ * h_built_
+      && uses_ < max_reuses_
+      && (base_itrs_ < 0 || last_itrs_ <= itrs_growth_ * std::max(base_itrs_, 1))
+      && contraction_ <= max_contraction_;
+
+  if (reuse) {
+    uses_++;
+    reuses_++;
+    step_reuses_++;
+  } else {
+    built_ = true;
+    h_built_ = h;
+    uses_ = 0;
+    base_itrs_ = -1;
+    last_itrs_ = -1;
+    contraction_ = 0.;
+    rebuilds_++;
+    step_rebuilds_++;
+  }
+  return reuse;
+}
+
+
+void PreconditionerLag::RecordLinearIterations(int itrs)
+{
+  if (base_itrs_ < 0) base_itrs_ = itrs;
+  last_itrs_ = itrs;
+}
+
+
+// -----------------------------------------------------------------------------
+// The preconditioner was built on the geometry, and at the step size, of an
+// earlier step.
+// -----------------------------------------------------------------------------
+void PreconditionerLag::ChangedSolution(double t_old, double t_new, bool mesh_deforms)
+{
+  if (t_old == t_old_ && t_new == t_new_) return;
+
+  bool retried = t_old == t_old_;
+  if (mesh_deforms || retried) Invalidate();
+  t_old_ = t_old;
+  t_new_ = t_new;
+}
+
+
+// -----------------------------------------------------------------------------
+// Contraction is only measured within a nonlinear solve; a new step time
+// starts a new solve.
+// -----------------------------------------------------------------------------
+void PreconditionerLag::RecordResidualNorm(double t, double norm)
+{
+  if (t != t_) {
+    t_ = t;
+    contraction_ = 0.;
+  } else if (last_norm_ > 0.) {
+    contraction_ = norm / last_norm_;
+  }
+  last_norm_ = norm;
+}
+
+} // namespace Amanzi
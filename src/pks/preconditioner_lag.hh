@@ -0,0 +1,131 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A policy for reusing an assembled preconditioner across nonlinear iterations and time steps.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+Assembling the preconditioner and setting up its inverse (AMG hierarchies,
+incomplete factorizations) often dominates the cost of a nonlinear iteration.
+When the solution changes slowly, a preconditioner built at an earlier iterate,
+or an earlier time step, remains a good approximation to the Jacobian.  With
+this policy, a PK's UpdatePreconditioner() keeps the current preconditioner
+until one of the following indicates it has degraded:
+
+- the time step size has changed by more than a relative tolerance since the
+  preconditioner was built, as the accumulation term scales with 1/h;
+- the preconditioner has been reused a maximum number of times;
+- the linear iteration count of its inverse has grown past a factor of the
+  count measured just after it was built;
+- the contraction rate of the nonlinear residual between successive
+  iterations, :math:`\|r_{k}\| / \|r_{k-1}\|`, exceeds a maximum;
+- a new step starts on a deforming mesh, whose geometry changed with the
+  previous step;
+- a step is retried with a different size, after a failure.
+
+The residual norm is taken from the residual passed to ApplyPreconditioner(),
+which the nonlinear solvers call once per iteration, so that the norms of
+updates or of time error estimates do not enter the rate.
+
+This works across time steps, complementing the lag within a step of the time
+integrator's `"max preconditioner lag iterations`".  The number of rebuilds and
+reuses since the last committed step, and in total, is written at the end of
+each step at verbosity `"medium`" or higher.
+
+This is only used by PKs that are not strongly coupled; a strongly coupled
+PK's preconditioner is a block of the coupler's operator, which is assembled
+by the coupler.
+
+.. _preconditioner-reuse-spec:
+.. admonition:: preconditioner-reuse-spec
+
+    * `"maximum reuses`" ``[int]`` **10** Rebuild after this many reuses.
+
+    * `"maximum relative time step change`" ``[double]`` **0.25** Rebuild if
+      :math:`|h - h_{built}| / h_{built}` exceeds this.
+
+    * `"linear iteration growth factor`" ``[double]`` **2.0** Rebuild if the
+      linear iteration count exceeds this factor times the count just after
+      the last rebuild.
+
+    * `"maximum contraction rate`" ``[double]`` **0.5** Rebuild if the
+      residual norm decreased by less than this factor over the last
+      nonlinear iteration.
+
+*/
+
+#ifndef ATS_PRECONDITIONER_LAG_HH_
+#define ATS_PRECONDITIONER_LAG_HH_
+
+#include "Teuchos_ParameterList.hpp"
+
+namespace Amanzi {
+
+class PreconditionerLag {
+
+ public:
+  explicit PreconditionerLag(Teuchos::ParameterList& plist);
+
+  // Returns true if the preconditioner may be reused at step size h.
+  // Otherwise the caller must rebuild it, and the rebuild is recorded.
+  bool Reuse(double h);
+
+  // Linear iterations taken by the most recent application of the inverse.
+  void RecordLinearIterations(int itrs);
+
+  // Norm of the nonlinear residual in the solve for the step ending at t.
+  void RecordResidualNorm(double t, double norm);
+
+  // The solution changed in the step from t_old to t_new.  Invalidates the
+  // preconditioner at the first change in a new step if the mesh deforms,
+  // and at the first change in a step retried with a different size.
+  void ChangedSolution(double t_old, double t_new, bool mesh_deforms);
+
+  // Forces a rebuild on the next call to Reuse().
+  void Invalidate() { built_ = false; }
+
+  // Counts in total, and since the last ResetStepCounts().
+  int rebuilds() const { return rebuilds_; }
+  int reuses() const { return reuses_; }
+  int step_rebuilds() const { return step_rebuilds_; }
+  int step_reuses() const { return step_reuses_; }
+  void ResetStepCounts() { step_rebuilds_ = 0; step_reuses_ = 0; }
+
+ private:
+  // parameters
+  int max_reuses_;
+  double max_dh_;
+  double itrs_growth_;
+  double max_contraction_;
+
+  // state of the current preconditioner
+  bool built_;
+  double h_built_;
+  int uses_;
+  int base_itrs_;
+  int last_itrs_;
+
+  // the current step
+  double t_old_, t_new_;
+
+  // contraction of the current nonlinear solve
+  double t_;
+  double last_norm_;
+  double contraction_;
+
+  // counters
+  int rebuilds_;
+  int reuses_;
+  int step_rebuilds_;
+  int step_reuses_;
+};
+
+} // namespace Amanzi
+
+#endif
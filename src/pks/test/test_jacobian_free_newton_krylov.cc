@@ -0,0 +1,161 @@
+#include <cmath>
+#include "UnitTest++.h"
+
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "AmanziComm.hh"
+#include "MeshFactory.hh"
+#include "CompositeVector.hh"
+#include "TreeVector.hh"
+
+#include "jacobian_free_newton_krylov.hh"
+
+using namespace Amanzi;
+
+// r_c = u_c^3 - b_c, preconditioned by the inverse of the diagonal Jacobian
+// at u0.
+class CubicFn : public BDFFnBase<TreeVector> {
+ public:
+  CubicFn() :
+      jfnk(Teuchos::null),
+      precon_err(0) {}
+
+  void FunctionalResidual(double t_old, double t_new, Teuchos::RCP<TreeVector> u_old,
+                          Teuchos::RCP<TreeVector> u_new, Teuchos::RCP<TreeVector> g) {
+    const Epetra_MultiVector& u_c = *u_new->Data()->ViewComponent("cell", false);
+    Epetra_MultiVector& g_c = *g->Data()->ViewComponent("cell", false);
+    for (int c=0; c!=u_c.MyLength(); ++c) {
+      g_c[0][c] = std::pow(u_c[0][c], 3) - b(c);
+    }
+    if (jfnk != Teuchos::null && !jfnk->active())
+      jfnk->SetBasePoint(t_old, t_new, u_old, u_new, *g);
+  }
+
+  int ApplyPreconditioner(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> Pu) {
+    if (precon_err) return precon_err;
+    const Epetra_MultiVector& u_c = *u->Data()->ViewComponent("cell", false);
+    Epetra_MultiVector& Pu_c = *Pu->Data()->ViewComponent("cell", false);
+    for (int c=0; c!=u_c.MyLength(); ++c) {
+      Pu_c[0][c] = u_c[0][c] / dr(c);
+    }
+    return 0;
+  }
+
+  double ErrorNorm(Teuchos::RCP<const TreeVector> u, Teuchos::RCP<const TreeVector> du) {
+    double norm(0.);
+    du->NormInf(&norm);
+    return norm;
+  }
+
+  void UpdatePreconditioner(double t, Teuchos::RCP<const TreeVector> up, double h) {}
+  bool IsAdmissible(Teuchos::RCP<const TreeVector> up) { return true; }
+  bool ModifyPredictor(double h, Teuchos::RCP<const TreeVector> u0,
+                       Teuchos::RCP<TreeVector> u) { return false; }
+  AmanziSolvers::FnBaseDefs::ModifyCorrectionResult
+      ModifyCorrection(double h, Teuchos::RCP<const TreeVector> res,
+                       Teuchos::RCP<const TreeVector> u, Teuchos::RCP<TreeVector> du) {
+    return AmanziSolvers::FnBaseDefs::CORRECTION_NOT_MODIFIED;
+  }
+  void ChangedSolution() {}
+  void UpdateContinuationParameter(double lambda) {}
+
+  double b(int c) const { return 1. + 0.1 * (c % 7); }
+  double u0(int c) const { return 0.5 + 0.05 * (c % 11); }
+  double dr(int c) const { return 3. * u0(c) * u0(c); }
+
+  Teuchos::RCP<JacobianFreeNewtonKrylov> jfnk;
+  int precon_err;
+};
+
+
+struct CubicProblem {
+  CubicProblem(int max_itrs) {
+    auto comm = getDefaultComm();
+    AmanziMesh::MeshFactory meshfactory(comm);
+    Teuchos::RCP<const AmanziMesh::Mesh> mesh = meshfactory.create(0.0, 0.0, 1.0, 1.0, 8, 8);
+
+    CompositeVectorSpace cell_space;
+    cell_space.SetMesh(mesh)->SetGhosted(false)->SetComponent("cell", AmanziMesh::CELL, 1);
+
+    u_old = Teuchos::rcp(new TreeVector());
+    u_old->SetData(Teuchos::rcp(new CompositeVector(cell_space)));
+    u_old->PutScalar(0.);
+    u = Teuchos::rcp(new TreeVector(*u_old));
+    Epetra_MultiVector& u_c = *u->Data()->ViewComponent("cell", false);
+    for (int c=0; c!=u_c.MyLength(); ++c) u_c[0][c] = fn.u0(c);
+    r = Teuchos::rcp(new TreeVector(*u_old));
+    du = Teuchos::rcp(new TreeVector(*u_old));
+
+    Teuchos::ParameterList plist;
+    plist.set<int>("maximum iterations", max_itrs);
+    plist.set<double>("tolerance", 1.e-6);
+    plist.set<double>("finite difference epsilon", 1.e-7);
+    fn.jfnk = Teuchos::rcp(new JacobianFreeNewtonKrylov(plist, &fn));
+
+    fn.FunctionalResidual(0., 1., u_old, u, r);
+  }
+
+  // moves the base point away from u0, where the preconditioner is exact
+  void Perturb() {
+    Epetra_MultiVector& u_c = *u->Data()->ViewComponent("cell", false);
+    for (int c=0; c!=u_c.MyLength(); ++c) u_c[0][c] = fn.u0(c) * (1. + 0.3 * (c % 3));
+    fn.FunctionalResidual(0., 1., u_old, u, r);
+  }
+
+  CubicFn fn;
+  Teuchos::RCP<TreeVector> u_old, u, r, du;
+};
+
+
+// With an exact preconditioner, the finite difference Jacobian action makes
+// P^-1 J the identity up to the differencing error, and one Krylov
+// iteration gives the Newton correction.
+TEST(JFNK_EXACT_PRECONDITIONER) {
+  CubicProblem prob(5);
+  int ierr = prob.fn.jfnk->ApplyInverse(prob.r, prob.du);
+  CHECK_EQUAL(0, ierr);
+  CHECK_EQUAL(1, prob.fn.jfnk->num_itrs());
+  CHECK(!prob.fn.jfnk->active());
+
+  const Epetra_MultiVector& r_c = *prob.r->Data()->ViewComponent("cell", false);
+  const Epetra_MultiVector& du_c = *prob.du->Data()->ViewComponent("cell", false);
+  for (int c=0; c!=du_c.MyLength(); ++c) {
+    CHECK_CLOSE(r_c[0][c] / prob.fn.dr(c), du_c[0][c], 1.e-5);
+  }
+}
+
+// An inexact preconditioner takes more iterations, to the Newton correction
+// at the new base point.
+TEST(JFNK_INEXACT_PRECONDITIONER) {
+  CubicProblem prob(20);
+  prob.Perturb();
+  int ierr = prob.fn.jfnk->ApplyInverse(prob.r, prob.du);
+  CHECK_EQUAL(0, ierr);
+  CHECK(prob.fn.jfnk->num_itrs() > 1);
+
+  const Epetra_MultiVector& u_c = *prob.u->Data()->ViewComponent("cell", false);
+  const Epetra_MultiVector& r_c = *prob.r->Data()->ViewComponent("cell", false);
+  const Epetra_MultiVector& du_c = *prob.du->Data()->ViewComponent("cell", false);
+  for (int c=0; c!=du_c.MyLength(); ++c) {
+    CHECK_CLOSE(r_c[0][c] / (3. * u_c[0][c] * u_c[0][c]), du_c[0][c], 1.e-5);
+  }
+}
+
+// Too few iterations for the inexact preconditioner are reported as failure.
+TEST(JFNK_NOT_CONVERGED) {
+  CubicProblem prob(1);
+  prob.Perturb();
+  int ierr = prob.fn.jfnk->ApplyInverse(prob.r, prob.du);
+  CHECK(ierr != 0);
+  CHECK_EQUAL(1, prob.fn.jfnk->num_itrs());
+  CHECK(!prob.fn.jfnk->active());
+}
+
+// A failed preconditioner is reported.
+TEST(JFNK_PRECONDITIONER_FAILED) {
+  CubicProblem prob(5);
+  prob.fn.precon_err = 2;
+  int ierr = prob.fn.jfnk->ApplyInverse(prob.r, prob.du);
+  CHECK_EQUAL(2, ierr);
+  CHECK(!prob.fn.jfnk->active());
+}
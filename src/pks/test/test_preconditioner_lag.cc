@@ -0,0 +1,112 @@
+#include "UnitTest++.h"
+
+#include "Teuchos_ParameterList.hpp"
+#include "preconditioner_lag.hh"
+
+using namespace Amanzi;
+
+TEST(PRECONDITIONER_LAG_MAX_REUSES) {
+  Teuchos::ParameterList plist;
+  plist.set<int>("maximum reuses", 2);
+  PreconditionerLag lag(plist);
+
+  CHECK(!lag.Reuse(1.));  // nothing built yet
+  CHECK(lag.Reuse(1.));
+  CHECK(lag.Reuse(1.));
+  CHECK(!lag.Reuse(1.));
+  CHECK_EQUAL(2, lag.rebuilds());
+  CHECK_EQUAL(2, lag.reuses());
+}
+
+TEST(PRECONDITIONER_LAG_STEP_SIZE) {
+  Teuchos::ParameterList plist;
+  PreconditionerLag lag(plist);
+
+  CHECK(!lag.Reuse(1.));
+  CHECK(lag.Reuse(1.2));
+  CHECK(!lag.Reuse(0.5));
+  CHECK(lag.Reuse(0.5));
+}
+
+TEST(PRECONDITIONER_LAG_LINEAR_ITERATIONS) {
+  Teuchos::ParameterList plist;
+  PreconditionerLag lag(plist);
+
+  CHECK(!lag.Reuse(1.));
+  lag.RecordLinearIterations(5);
+  lag.RecordLinearIterations(10);
+  CHECK(lag.Reuse(1.));
+  lag.RecordLinearIterations(11);
+  CHECK(!lag.Reuse(1.));
+
+  // a direct solve reports no iterations, and is never rebuilt for it
+  lag.RecordLinearIterations(0);
+  lag.RecordLinearIterations(0);
+  CHECK(lag.Reuse(1.));
+}
+
+TEST(PRECONDITIONER_LAG_CONTRACTION) {
+  Teuchos::ParameterList plist;
+  PreconditionerLag lag(plist);
+
+  CHECK(!lag.Reuse(1.));
+  lag.RecordResidualNorm(1., 1.);
+  lag.RecordResidualNorm(1., 0.1);
+  CHECK(lag.Reuse(1.));
+  lag.RecordResidualNorm(1., 0.09);
+  CHECK(!lag.Reuse(1.));
+
+  // the rate is only measured within the solve for one step
+  lag.RecordResidualNorm(1., 1.);
+  lag.RecordResidualNorm(2., 2.);
+  CHECK(lag.Reuse(1.));
+}
+
+TEST(PRECONDITIONER_LAG_STEP_COUNTS) {
+  Teuchos::ParameterList plist;
+  PreconditionerLag lag(plist);
+
+  lag.Reuse(1.);
+  lag.Reuse(1.);
+  CHECK_EQUAL(1, lag.step_rebuilds());
+  CHECK_EQUAL(1, lag.step_reuses());
+
+  lag.ResetStepCounts();
+  lag.Reuse(1.);
+  CHECK_EQUAL(0, lag.step_rebuilds());
+  CHECK_EQUAL(1, lag.step_reuses());
+  CHECK_EQUAL(1, lag.rebuilds());
+  CHECK_EQUAL(2, lag.reuses());
+}
+
+TEST(PRECONDITIONER_LAG_NEW_STEP) {
+  Teuchos::ParameterList plist;
+  PreconditionerLag lag(plist);
+
+  // kept across steps on a fixed mesh
+  lag.ChangedSolution(0., 1., false);
+  CHECK(!lag.Reuse(1.));
+  lag.ChangedSolution(0., 1., false);
+  CHECK(lag.Reuse(1.));
+  lag.ChangedSolution(1., 2., false);
+  CHECK(lag.Reuse(1.));
+
+  // rebuilt when a step is retried, even at a similar size
+  lag.ChangedSolution(1., 1.9, false);
+  CHECK(!lag.Reuse(0.9));
+  CHECK(lag.Reuse(0.9));
+}
+
+TEST(PRECONDITIONER_LAG_DEFORMING_MESH) {
+  Teuchos::ParameterList plist;
+  PreconditionerLag lag(plist);
+
+  lag.ChangedSolution(0., 1., true);
+  CHECK(!lag.Reuse(1.));
+  lag.ChangedSolution(0., 1., true);
+  CHECK(lag.Reuse(1.));
+
+  // the geometry changed with the last step
+  lag.ChangedSolution(1., 2., true);
+  CHECK(!lag.Reuse(1.));
+}
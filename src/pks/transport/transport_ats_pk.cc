@@ -37,6 +37,7 @@
 #include "TransportSourceFunction_Alquimia.hh"
 #include "TransportDomainFunction_UnitConversion.hh"
 
+#include "mesh_topology.hh"
 #include "transport_ats.hh"
 
 namespace Amanzi {
@@ -1046,12 +1047,10 @@ void Transport_ATS :: Advance_Dispersion_Diffusion(double t_old, double t_new)
         if (tcc_tmp->HasComponent("boundary_face")){
           Epetra_MultiVector& tcc_tmp_bf = *tcc_tmp->ViewComponent("boundary_face",false);
           Epetra_MultiVector& sol_faces = *sol.ViewComponent("face",false);
-          const Epetra_Map& vandalay_map = mesh_->exterior_face_map(false);
-          const Epetra_Map& face_map = mesh_->face_map(false);
+          const MeshTopology& topo = MeshTopology::Get(mesh_);
           int nbfaces = tcc_tmp_bf.MyLength();
           for (int bf=0; bf!=nbfaces; ++bf) {
-            AmanziMesh::Entity_ID f = face_map.LID(vandalay_map.GID(bf));
-            tcc_tmp_bf[i][bf] =  sol_faces[i][f];
+            tcc_tmp_bf[i][bf] =  sol_faces[i][topo.boundary_face_face(bf)];
           }
         }
       }
@@ -1791,10 +1790,9 @@ bool Transport_ATS::PopulateBoundaryData(
     bc_value[i] = 0.0;
   }
 
-  AmanziMesh::Entity_ID_List cells;
+  const MeshTopology& topo = MeshTopology::Get(mesh_);
   for (int f = 0; f < nfaces_wghost; f++) {
-    mesh_->face_get_cells(f, AmanziMesh::Parallel_type::ALL, &cells);
-    if (cells.size() == 1) bc_model[f] = Operators::OPERATOR_BC_NEUMANN;
+    if (topo.face_num_cells(f) == 1) bc_model[f] = Operators::OPERATOR_BC_NEUMANN;
   }
 
   for (int m = 0; m < bcs_.size(); m++) {
@@ -0,0 +1,234 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A dual number for forward mode automatic differentiation of constitutive models.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+A Dual<N> carries a value and its partial derivatives with respect to N
+independent variables.  Arithmetic and the elementary functions propagate
+the derivatives by the chain rule, so a model written once, as a template on
+its scalar type, evaluates as a plain function of doubles or, on Dual<N>, as
+the function along with its gradient:
+
+.. code-block:: c++
+
+    template<class T> T Model_(const T& x, const T& y) const {
+      using std::pow;
+      return pow(x, n_) * y;
+    }
+
+    double Model(double x, double y) { return Model_(x, y); }
+
+    double ModelAndDerivatives(double x, double y, double* dx, double* dy) {
+      Dual<2> f = Model_(Dual<2>::Variable(x, 0), Dual<2>::Variable(y, 1));
+      *dx = f.d(0);
+      *dy = f.d(1);
+      return f.value();
+    }
+
+Each elementary function is evaluated once, with its derivative taken from
+its value where possible, so that the value and all partials together cost
+about the same number of transcendental calls as the value alone.
+
+Comparisons act on the value, so branches in a model select the same piece
+as they would for doubles.  Where a piece is held constant, Constant() drops
+the derivatives; value() gives the value of either a double or a Dual.
+
+*/
+
+#ifndef ATS_DUAL_HH_
+#define ATS_DUAL_HH_
+
+#include <cmath>
+
+namespace Amanzi {
+
+template<int N>
+class Dual {
+
+ public:
+  Dual() : v_(0.) {
+    for (int i=0; i!=N; ++i) d_[i] = 0.;
+  }
+
+  // constants convert implicitly, so that models mix them freely with Duals
+  Dual(double v) : v_(v) {
+    for (int i=0; i!=N; ++i) d_[i] = 0.;
+  }
+
+  // The i-th independent variable, with value v.
+  static Dual Variable(double v, int i) {
+    Dual x(v);
+    x.d_[i] = 1.;
+    return x;
+  }
+
+  double value() const { return v_; }
+  double d(int i) const { return d_[i]; }
+  double& d(int i) { return d_[i]; }
+
+  // x = f(x), given f(x) and f'(x)
+  Dual& Chain(double f, double df) {
+    v_ = f;
+    for (int i=0; i!=N; ++i) d_[i] *= df;
+    return *this;
+  }
+
+  Dual& operator+=(const Dual& o) {
+    v_ += o.v_;
+    for (int i=0; i!=N; ++i) d_[i] += o.d_[i];
+    return *this;
+  }
+  Dual& operator-=(const Dual& o) {
+    v_ -= o.v_;
+    for (int i=0; i!=N; ++i) d_[i] -= o.d_[i];
+    return *this;
+  }
+  Dual& operator*=(const Dual& o) {
+    for (int i=0; i!=N; ++i) d_[i] = d_[i] * o.v_ + v_ * o.d_[i];
+    v_ *= o.v_;
+    return *this;
+  }
+  Dual& operator/=(const Dual& o) {
+    double inv = 1. / o.v_;
+    v_ *= inv;
+    for (int i=0; i!=N; ++i) d_[i] = (d_[i] - v_ * o.d_[i]) * inv;
+    return *this;
+  }
+
+  Dual& operator+=(double o) { v_ += o; return *this; }
+  Dual& operator-=(double o) { v_ -= o; return *this; }
+  Dual& operator*=(double o) {
+    v_ *= o;
+    for (int i=0; i!=N; ++i) d_[i] *= o;
+    return *this;
+  }
+  Dual& operator/=(double o) {
+    v_ /= o;
+    for (int i=0; i!=N; ++i) d_[i] /= o;
+    return *this;
+  }
+
+ private:
+  double v_;
+  double d_[N];
+};
+
+
+// -----------------------------------------------------------------------------
+// Arithmetic
+// -----------------------------------------------------------------------------
+template<int N> inline Dual<N> operator+(const Dual<N>& a) { return a; }
+template<int N> inline Dual<N> operator-(const Dual<N>& a) { Dual<N> r(a); r *= -1.; return r; }
+
+template<int N> inline Dual<N> operator+(Dual<N> a, const Dual<N>& b) { return a += b; }
+template<int N> inline Dual<N> operator-(Dual<N> a, const Dual<N>& b) { return a -= b; }
+template<int N> inline Dual<N> operator*(Dual<N> a, const Dual<N>& b) { return a *= b; }
+template<int N> inline Dual<N> operator/(Dual<N> a, const Dual<N>& b) { return a /= b; }
+
+template<int N> inline Dual<N> operator+(Dual<N> a, double b) { return a += b; }
+template<int N> inline Dual<N> operator-(Dual<N> a, double b) { return a -= b; }
+template<int N> inline Dual<N> operator*(Dual<N> a, double b) { return a *= b; }
+template<int N> inline Dual<N> operator/(Dual<N> a, double b) { return a /= b; }
+
+template<int N> inline Dual<N> operator+(double a, Dual<N> b) { return b += a; }
+template<int N> inline Dual<N> operator-(double a, const Dual<N>& b) { return Dual<N>(a) -= b; }
+template<int N> inline Dual<N> operator*(double a, Dual<N> b) { return b *= a; }
+template<int N> inline Dual<N> operator/(double a, const Dual<N>& b) {
+  double inv = 1. / b.value();
+  Dual<N> r(b);
+  return r.Chain(a * inv, -a * inv * inv);
+}
+
+
+// -----------------------------------------------------------------------------
+// Comparisons, on the value
+// -----------------------------------------------------------------------------
+template<int N> inline bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.value() < b.value(); }
+template<int N> inline bool operator>(const Dual<N>& a, const Dual<N>& b) { return a.value() > b.value(); }
+template<int N> inline bool operator<=(const Dual<N>& a, const Dual<N>& b) { return a.value() <= b.value(); }
+template<int N> inline bool operator>=(const Dual<N>& a, const Dual<N>& b) { return a.value() >= b.value(); }
+
+template<int N> inline bool operator<(const Dual<N>& a, double b) { return a.value() < b; }
+template<int N> inline bool operator>(const Dual<N>& a, double b) { return a.value() > b; }
+template<int N> inline bool operator<=(const Dual<N>& a, double b) { return a.value() <= b; }
+template<int N> inline bool operator>=(const Dual<N>& a, double b) { return a.value() >= b; }
+template<int N> inline bool operator==(const Dual<N>& a, double b) { return a.value() == b; }
+template<int N> inline bool operator!=(const Dual<N>& a, double b) { return a.value() != b; }
+
+template<int N> inline bool operator<(double a, const Dual<N>& b) { return a < b.value(); }
+template<int N> inline bool operator>(double a, const Dual<N>& b) { return a > b.value(); }
+template<int N> inline bool operator<=(double a, const Dual<N>& b) { return a <= b.value(); }
+template<int N> inline bool operator>=(double a, const Dual<N>& b) { return a >= b.value(); }
+
+
+// -----------------------------------------------------------------------------
+// Elementary functions, found by argument dependent lookup next to the std::
+// versions, each evaluating one transcendental.  The std:: versions are
+// brought in alongside so that these do not hide them from unqualified calls
+// on doubles elsewhere in the namespace.
+// -----------------------------------------------------------------------------
+using std::exp;
+using std::log;
+using std::sqrt;
+using std::pow;
+using std::fabs;
+
+template<int N> inline Dual<N> exp(Dual<N> x) {
+  double f = std::exp(x.value());
+  return x.Chain(f, f);
+}
+
+template<int N> inline Dual<N> log(Dual<N> x) {
+  return x.Chain(std::log(x.value()), 1. / x.value());
+}
+
+template<int N> inline Dual<N> sqrt(Dual<N> x) {
+  double f = std::sqrt(x.value());
+  return x.Chain(f, 0.5 / f);
+}
+
+template<int N> inline Dual<N> pow(Dual<N> x, double p) {
+  double v = x.value();
+  double f = std::pow(v, p);
+  // at 0 the derivative cannot be taken from the value
+  double df = v != 0. ? p * f / v : (p == 1. ? 1. : p * std::pow(v, p - 1.));
+  return x.Chain(f, df);
+}
+
+template<int N> inline Dual<N> pow(double a, Dual<N> x) {
+  double f = std::pow(a, x.value());
+  return x.Chain(f, f * std::log(a));
+}
+
+template<int N> inline Dual<N> pow(const Dual<N>& x, const Dual<N>& p) {
+  return exp(p * log(x));
+}
+
+template<int N> inline Dual<N> fabs(Dual<N> x) {
+  return x.value() < 0. ? x *= -1. : x;
+}
+
+template<int N> inline Dual<N> max(const Dual<N>& a, const Dual<N>& b) { return a < b ? b : a; }
+template<int N> inline Dual<N> min(const Dual<N>& a, const Dual<N>& b) { return b < a ? b : a; }
+
+
+// -----------------------------------------------------------------------------
+// Helpers for models templated on double or Dual
+// -----------------------------------------------------------------------------
+inline double value(double x) { return x; }
+template<int N> inline double value(const Dual<N>& x) { return x.value(); }
+
+// x with its derivatives dropped
+template<class T> inline T Constant(const T& x) { return T(value(x)); }
+
+} // namespace Amanzi
+
+#endif
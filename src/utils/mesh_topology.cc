@@ -0,0 +1,156 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of the MeshTopology cache.
+------------------------------------------------------------------------- */
+
+#include "dbc.hh"
+#include "mesh_topology.hh"
+
+namespace Amanzi {
+
+std::map<const AmanziMesh::Mesh*, std::unique_ptr<MeshTopology> > MeshTopology::cache_;
+
+
+MeshTopology::MeshTopology(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh) :
+    mesh_(mesh.create_weak()),
+    parent_(nullptr),
+    stale_(true) {}
+
+
+// -----------------------------------------------------------------------------
+// Find the cached topology, building or rebuilding it as needed.
+// -----------------------------------------------------------------------------
+MeshTopology& MeshTopology::Find_(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh)
+{
+  std::unique_ptr<MeshTopology>& entry = cache_[mesh.get()];
+  if (entry != nullptr && !entry->mesh_.shares_resource(mesh)) {
+    // the cached mesh was destroyed, and this one reuses its address
+    for (auto& other : cache_) {
+      if (other.second != nullptr && other.second->parent_ == entry.get()) {
+        other.second->parent_ = nullptr;
+      }
+    }
+    entry.reset();
+  }
+  if (entry == nullptr) entry.reset(new MeshTopology(mesh));
+  if (entry->stale_) {
+    entry->Build_();
+    if (entry->parent_ && entry->parent_->mesh_.is_valid_ptr()) {
+      entry->BuildParent_(Find_(entry->parent_->mesh_));
+    } else {
+      entry->parent_ = nullptr;
+    }
+  }
+  return *entry;
+}
+
+
+const MeshTopology& MeshTopology::Get(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh)
+{
+  return Find_(mesh);
+}
+
+
+const MeshTopology& MeshTopology::Get(const Teuchos::RCP<const AmanziMesh::Mesh>& surf_mesh,
+                                      const Teuchos::RCP<const AmanziMesh::Mesh>& parent)
+{
+  const MeshTopology& parent_topo = Find_(parent);
+  MeshTopology& topo = Find_(surf_mesh);
+  if (topo.parent_ != &parent_topo) topo.BuildParent_(parent_topo);
+  return topo;
+}
+
+
+void MeshTopology::Invalidate(const AmanziMesh::Mesh& mesh)
+{
+  auto entry = cache_.find(&mesh);
+  if (entry == cache_.end()) return;
+
+  entry->second->stale_ = true;
+  for (auto& other : cache_) {
+    if (other.second->parent_ == entry->second.get()) other.second->stale_ = true;
+  }
+}
+
+
+void MeshTopology::Clear()
+{
+  cache_.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+// Build the face to cell and boundary face maps.
+// -----------------------------------------------------------------------------
+void MeshTopology::Build_()
+{
+  int nfaces = mesh_->num_entities(AmanziMesh::FACE, AmanziMesh::Parallel_type::ALL);
+  int ncells = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::ALL);
+
+  // faces to cells, counting and then filling each row
+  AmanziMesh::Entity_ID_List faces;
+  std::vector<int> dirs;
+  face_offsets_.assign(nfaces+1, 0);
+  for (int c=0; c!=ncells; ++c) {
+    mesh_->cell_get_faces_and_dirs(c, &faces, &dirs);
+    for (auto f : faces) face_offsets_[f+1]++;
+  }
+  for (int f=0; f!=nfaces; ++f) face_offsets_[f+1] += face_offsets_[f];
+
+  face_cells_.resize(face_offsets_[nfaces]);
+  face_dirs_.resize(face_offsets_[nfaces]);
+  std::vector<int> next(face_offsets_.begin(), face_offsets_.end()-1);
+  for (int c=0; c!=ncells; ++c) {
+    mesh_->cell_get_faces_and_dirs(c, &faces, &dirs);
+    for (int i=0; i!=faces.size(); ++i) {
+      face_cells_[next[faces[i]]] = c;
+      face_dirs_[next[faces[i]]++] = dirs[i];
+    }
+  }
+
+  // boundary faces
+  const Epetra_Map& vandelay_map = mesh_->exterior_face_map(false);
+  const Epetra_Map& face_map = mesh_->face_map(false);
+  int nbfaces = vandelay_map.NumMyElements();
+  bf_face_.resize(nbfaces);
+  bf_cell_.resize(nbfaces);
+  face_bf_.assign(nfaces, -1);
+  for (int bf=0; bf!=nbfaces; ++bf) {
+    AmanziMesh::Entity_ID f = face_map.LID(vandelay_map.GID(bf));
+    AMANZI_ASSERT(face_num_cells(f) == 1);
+    bf_face_[bf] = f;
+    bf_cell_[bf] = face_cells(f)[0];
+    face_bf_[f] = bf;
+  }
+
+  stale_ = false;
+}
+
+
+// -----------------------------------------------------------------------------
+// Build the maps from surface cells to the parent mesh.
+// -----------------------------------------------------------------------------
+void MeshTopology::BuildParent_(const MeshTopology& parent)
+{
+  parent_ = &parent;
+
+  int nsurf_cells = mesh_->num_entities(AmanziMesh::CELL, AmanziMesh::Parallel_type::ALL);
+  parent_face_.resize(nsurf_cells);
+  parent_cell_.resize(nsurf_cells);
+  parent_bf_.resize(nsurf_cells);
+  for (int sc=0; sc!=nsurf_cells; ++sc) {
+    AmanziMesh::Entity_ID f = mesh_->entity_get_parent(AmanziMesh::CELL, sc);
+    AMANZI_ASSERT(parent.face_num_cells(f) == 1);
+    parent_face_[sc] = f;
+    parent_cell_[sc] = parent.face_cells(f)[0];
+    parent_bf_[sc] = parent.face_boundary_face(f);
+  }
+}
+
+} // namespace Amanzi
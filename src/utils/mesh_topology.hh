@@ -0,0 +1,134 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A per-mesh cache of the adjacencies used by boundary and coupling loops.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+Many evaluators and PKs map boundary faces to their interior cell, and surface
+cells to the subsurface face and cell below them, on every evaluation.  Done
+through the mesh, each lookup is two map conversions and a face_get_cells()
+call that fills a newly allocated list.  MeshTopology computes these maps once
+per mesh and stores them in flat arrays:
+
+- boundary face (indexed as in exterior_face_map(false)) to face and to
+  interior cell, and face to boundary face;
+- face to cells and the direction of the face relative to each cell, in
+  compressed row storage over all faces, including ghosts;
+- for a surface mesh, surface cell to parent face, to the subsurface cell
+  below, and to the parent's boundary face.
+
+The cache is shared by everything that uses the mesh:
+
+.. code-block:: c++
+
+    const MeshTopology& topo = MeshTopology::Get(mesh);
+    for (int bf=0; bf!=topo.num_boundary_faces(); ++bf) {
+      AmanziMesh::Entity_ID c = topo.boundary_face_cell(bf);
+      ...
+    }
+
+Topology does not change as a mesh deforms, but deforming PKs call
+Invalidate() so that nothing cached can go stale; the maps are rebuilt on the
+next Get().  References returned by Get() remain valid across rebuilds, but
+should not be held across a deformation by code that also caches array
+pointers.
+
+The cache refers to meshes weakly, so it does not keep a mesh, or the
+communicator under it, alive: an entry whose mesh has been destroyed is
+rebuilt if another mesh is later created at the same address.  Clear()
+drops all entries, and is called when a simulation is torn down.
+
+*/
+
+#ifndef ATS_MESH_TOPOLOGY_HH_
+#define ATS_MESH_TOPOLOGY_HH_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "Mesh.hh"
+
+namespace Amanzi {
+
+class MeshTopology {
+
+ public:
+  // Cached topology of a mesh, built on first use.
+  static const MeshTopology& Get(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh);
+
+  // Cached topology of a surface mesh, including the maps to its parent.
+  static const MeshTopology& Get(const Teuchos::RCP<const AmanziMesh::Mesh>& surf_mesh,
+                                 const Teuchos::RCP<const AmanziMesh::Mesh>& parent);
+
+  // Marks the topology of a mesh, and of any surface meshes whose parent it
+  // is, to be rebuilt.
+  static void Invalidate(const AmanziMesh::Mesh& mesh);
+
+  // Drops the topology of all meshes.
+  static void Clear();
+
+  // Boundary faces.
+  int num_boundary_faces() const { return bf_face_.size(); }
+  AmanziMesh::Entity_ID boundary_face_face(int bf) const { return bf_face_[bf]; }
+  AmanziMesh::Entity_ID boundary_face_cell(int bf) const { return bf_cell_[bf]; }
+
+  // Boundary face of an owned face, or -1 if it is not on the boundary.
+  int face_boundary_face(AmanziMesh::Entity_ID f) const { return face_bf_[f]; }
+
+  // Cells of a face, and the direction of the face's normal relative to the
+  // outward normal of each cell, over all faces.
+  int face_num_cells(AmanziMesh::Entity_ID f) const {
+    return face_offsets_[f+1] - face_offsets_[f];
+  }
+  const AmanziMesh::Entity_ID* face_cells(AmanziMesh::Entity_ID f) const {
+    return &face_cells_[face_offsets_[f]];
+  }
+  const int* face_dirs(AmanziMesh::Entity_ID f) const {
+    return &face_dirs_[face_offsets_[f]];
+  }
+
+  // Surface meshes only, when built with a parent: the parent face, the
+  // parent cell below it, and the parent's boundary face of a surface cell.
+  AmanziMesh::Entity_ID parent_face(AmanziMesh::Entity_ID sc) const { return parent_face_[sc]; }
+  AmanziMesh::Entity_ID parent_cell(AmanziMesh::Entity_ID sc) const { return parent_cell_[sc]; }
+  int parent_boundary_face(AmanziMesh::Entity_ID sc) const { return parent_bf_[sc]; }
+
+ private:
+  explicit MeshTopology(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh);
+
+  static MeshTopology& Find_(const Teuchos::RCP<const AmanziMesh::Mesh>& mesh);
+  void Build_();
+  void BuildParent_(const MeshTopology& parent);
+
+ private:
+  Teuchos::RCP<const AmanziMesh::Mesh> mesh_; // weak
+  const MeshTopology* parent_;
+  bool stale_;
+
+  std::vector<AmanziMesh::Entity_ID> bf_face_;
+  std::vector<AmanziMesh::Entity_ID> bf_cell_;
+  std::vector<int> face_bf_;
+
+  std::vector<int> face_offsets_;
+  std::vector<AmanziMesh::Entity_ID> face_cells_;
+  std::vector<int> face_dirs_;
+
+  std::vector<AmanziMesh::Entity_ID> parent_face_;
+  std::vector<AmanziMesh::Entity_ID> parent_cell_;
+  std::vector<int> parent_bf_;
+
+  static std::map<const AmanziMesh::Mesh*, std::unique_ptr<MeshTopology> > cache_;
+};
+
+} // namespace Amanzi
+
+#endif
@@ -0,0 +1,139 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! Partial derivatives computed along with an evaluator's value, kept while their arguments are unchanged.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+Models that differentiate themselves automatically return their value and
+all partial derivatives from one call, at about the cost of the value alone.
+State, however, asks an evaluator for its value and for each partial
+derivative separately.  An evaluator of such a model computes the partials
+along with its value, when they are likely to be wanted, and keeps them
+here, together with a copy of the dependencies they were computed from:
+
+.. code-block:: c++
+
+    void EvaluateField_(S, result) {
+      // calls partials_.Record() if computing the partials
+      EvaluateFieldAndPartials_(S, result, partials_.TakeRequest());
+    }
+
+    void EvaluateFieldPartialDerivative_(S, wrt_key, result) {
+      partials_.Request();
+      if (!partials_.IsCurrent(deps)) EvaluateFieldAndPartials_(S, Teuchos::null, true);
+      *result = *partials_[k];  // k, the index of wrt_key
+    }
+
+Partials are computed with the value only if a derivative was requested
+since the previous value evaluation.  A PK that updates its preconditioner
+every nonlinear iteration asks for derivatives at the iterate at which the
+residual, and so the value, was just evaluated, and these are served from
+the cache.  A PK that reuses its preconditioner asks for none, and its
+residual evaluations compute only values, neither computing the partials
+nor copying the dependencies.  The first derivative request after such a
+stretch recomputes all partials in one sweep.  The comparison of the
+dependencies is local to each process, and is only made on derivative
+requests.
+
+Copies of an evaluator start with an empty cache rather than sharing one.
+
+*/
+
+#ifndef ATS_PARTIALS_CACHE_HH_
+#define ATS_PARTIALS_CACHE_HH_
+
+#include <vector>
+
+#include "Teuchos_RCP.hpp"
+#include "CompositeVector.hh"
+
+namespace Amanzi {
+
+class PartialsCache {
+
+ public:
+  PartialsCache() : current_(false), requested_(false) {}
+  PartialsCache(const PartialsCache& other) : current_(false), requested_(false) {}
+
+  // Notes a derivative request.
+  void Request() { requested_ = true; }
+
+  // True if a derivative was requested since the last call, i.e. the
+  // partials should be computed along with the value.
+  bool TakeRequest() {
+    bool requested = requested_;
+    requested_ = false;
+    return requested;
+  }
+
+  // Copies deps, the arguments of the partials about to be computed, and
+  // sizes n partials like result.  The partials are then written through
+  // operator[].
+  void Record(const std::vector<Teuchos::RCP<const CompositeVector> >& deps,
+              int n, const CompositeVector& result) {
+    Record(deps, std::vector<Teuchos::Ptr<const CompositeVector> >(n, Teuchos::ptr(&result)));
+  }
+
+  // As above, for evaluators of several fields: partial i is sized like
+  // spaces[i].
+  void Record(const std::vector<Teuchos::RCP<const CompositeVector> >& deps,
+              const std::vector<Teuchos::Ptr<const CompositeVector> >& spaces) {
+    partials_.resize(spaces.size());
+    for (int i=0; i!=spaces.size(); ++i) {
+      if (partials_[i] == Teuchos::null) partials_[i] = Teuchos::rcp(new CompositeVector(*spaces[i]));
+    }
+
+    deps_.resize(deps.size());
+    for (int i=0; i!=deps.size(); ++i) {
+      if (deps_[i] == Teuchos::null) {
+        deps_[i] = Teuchos::rcp(new CompositeVector(*deps[i]));
+      } else {
+        *deps_[i] = *deps[i];
+      }
+    }
+    current_ = true;
+  }
+
+  // True if the partials were recorded from values equal to those of deps.
+  bool IsCurrent(const std::vector<Teuchos::RCP<const CompositeVector> >& deps) const {
+    if (!current_ || deps.size() != deps_.size()) return false;
+    for (int i=0; i!=deps.size(); ++i) {
+      for (CompositeVector::name_iterator comp=deps_[i]->begin();
+           comp!=deps_[i]->end(); ++comp) {
+        if (!deps[i]->HasComponent(*comp)) return false;
+        const Epetra_MultiVector& old_v = *deps_[i]->ViewComponent(*comp,false);
+        const Epetra_MultiVector& new_v = *deps[i]->ViewComponent(*comp,false);
+        if (old_v.MyLength() != new_v.MyLength()) return false;
+        for (int j=0; j!=old_v.NumVectors(); ++j) {
+          for (int c=0; c!=old_v.MyLength(); ++c) {
+            if (old_v[j][c] != new_v[j][c]) return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  // The partials become stale, e.g. when the model changes.
+  void Invalidate() { current_ = false; }
+
+  Teuchos::RCP<CompositeVector> operator[](int i) { return partials_[i]; }
+  Teuchos::RCP<const CompositeVector> operator[](int i) const { return partials_[i]; }
+
+ private:
+  bool current_;
+  bool requested_;
+  std::vector<Teuchos::RCP<CompositeVector> > deps_;
+  std::vector<Teuchos::RCP<CompositeVector> > partials_;
+};
+
+} // namespace Amanzi
+
+#endif
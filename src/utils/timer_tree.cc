@@ -0,0 +1,233 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+
+/* -------------------------------------------------------------------------
+ATS
+
+License: see $ATS_DIR/COPYRIGHT
+Author: Ethan Coon
+
+Implementation of the TimerTree.
+------------------------------------------------------------------------- */
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include "dbc.hh"
+#include "timer_tree.hh"
+
+namespace Amanzi {
+
+bool TimerTree::enabled_ = false;
+TimerTree::Node TimerTree::root_;
+TimerTree::Node* TimerTree::current_ = &TimerTree::root_;
+
+
+// -----------------------------------------------------------------------------
+// Find or create the child of the current node, and start its clock.
+// -----------------------------------------------------------------------------
+TimerTree::Node* TimerTree::Start_(const std::string& name, const char* label)
+{
+  Node* node = nullptr;
+  for (auto& child : current_->children) {
+    if ((child->label == label || std::strcmp(child->label, label) == 0) &&
+        child->name == name) {
+      node = child.get();
+      break;
+    }
+  }
+
+  if (node == nullptr) {
+    current_->children.emplace_back(new Node());
+    node = current_->children.back().get();
+    node->name = name;
+    node->label = label;
+    node->parent = current_;
+  }
+
+  current_ = node;
+  node->start = std::chrono::steady_clock::now();
+  return node;
+}
+
+
+void TimerTree::Stop_(Node* node)
+{
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - node->start;
+  node->total += elapsed.count();
+  node->count++;
+  current_ = node->parent;
+}
+
+
+void TimerTree::Reset()
+{
+  AMANZI_ASSERT(current_ == &root_);
+  root_.children.clear();
+}
+
+
+// -----------------------------------------------------------------------------
+// Flatten the tree, depth first, and reduce times across ranks.  Trees are
+// only comparable if every rank called the same methods in the same nesting;
+// this is checked on a hash of the flattened names and depths.  If not, local
+// times are reported.
+// -----------------------------------------------------------------------------
+std::vector<TimerTree::Entry>
+TimerTree::Gather_(const Comm_ptr_type& comm, bool& consistent)
+{
+  std::vector<Entry> entries;
+  std::vector<std::pair<const Node*,int> > stack;
+  for (auto child = root_.children.rbegin(); child != root_.children.rend(); ++child)
+    stack.emplace_back(child->get(), 0);
+
+  while (!stack.empty()) {
+    Entry entry;
+    entry.node = stack.back().first;
+    entry.depth = stack.back().second;
+    stack.pop_back();
+    entries.push_back(entry);
+
+    for (auto child = entry.node->children.rbegin();
+         child != entry.node->children.rend(); ++child)
+      stack.emplace_back(child->get(), entry.depth+1);
+  }
+
+  // FNV-1a, truncated to a positive int for the reduction
+  unsigned int hash = 2166136261u;
+  auto hash_in = [&hash](const char* s, std::size_t len) {
+    for (std::size_t i=0; i!=len; ++i) {
+      hash ^= static_cast<unsigned char>(s[i]);
+      hash *= 16777619u;
+    }
+  };
+  for (const auto& entry : entries) {
+    hash_in(entry.node->name.c_str(), entry.node->name.size() + 1);
+    hash_in(entry.node->label, std::strlen(entry.node->label) + 1);
+    hash_in(reinterpret_cast<const char*>(&entry.depth), sizeof(int));
+  }
+
+  int local_id[2] = { static_cast<int>(entries.size()), static_cast<int>(hash & 0x7fffffff) };
+  int id_min[2], id_max[2];
+  comm->MinAll(local_id, id_min, 2);
+  comm->MaxAll(local_id, id_max, 2);
+  consistent = id_min[0] == id_max[0] && id_min[1] == id_max[1];
+
+  int n = entries.size();
+  std::vector<double> local(n), min(n), max(n), sum(n);
+  std::vector<int> count(n), count_max(n);
+  for (int i=0; i!=n; ++i) {
+    local[i] = entries[i].node->total;
+    count[i] = entries[i].node->count;
+  }
+
+  if (consistent && n > 0) {
+    comm->MinAll(&local[0], &min[0], n);
+    comm->MaxAll(&local[0], &max[0], n);
+    comm->SumAll(&local[0], &sum[0], n);
+    comm->MaxAll(&count[0], &count_max[0], n);
+    for (int i=0; i!=n; ++i) {
+      entries[i].min = min[i];
+      entries[i].max = max[i];
+      entries[i].mean = sum[i] / comm->NumProc();
+      entries[i].count = count_max[i];
+    }
+  } else {
+    for (int i=0; i!=n; ++i) {
+      entries[i].min = local[i];
+      entries[i].max = local[i];
+      entries[i].mean = local[i];
+      entries[i].count = count[i];
+    }
+  }
+  return entries;
+}
+
+
+void TimerTree::Report(std::ostream& os, const Comm_ptr_type& comm)
+{
+  bool consistent;
+  std::vector<Entry> entries = Gather_(comm, consistent);
+  if (comm->MyPID() != 0 || entries.empty()) return;
+
+  std::ios::fmtflags flags(os.flags());
+  std::streamsize precision(os.precision());
+  os << "Timer tree" << (consistent ? "" : " (rank 0 only, ranks called different methods)")
+     << ":" << std::endl
+     << std::setw(58) << std::left << "  method" << std::right
+     << std::setw(10) << "calls"
+     << std::setw(12) << "min [s]"
+     << std::setw(12) << "mean [s]"
+     << std::setw(12) << "max [s]" << std::endl;
+
+  for (const auto& entry : entries) {
+    std::string label = std::string(2*(entry.depth+1), ' ')
+                        + entry.node->name + "::" + entry.node->label;
+    os << std::setw(58) << std::left << label << std::right
+       << std::setw(10) << entry.count
+       << std::setw(12) << std::setprecision(4) << entry.min
+       << std::setw(12) << std::setprecision(4) << entry.mean
+       << std::setw(12) << std::setprecision(4) << entry.max << std::endl;
+  }
+  os.flags(flags);
+  os.precision(precision);
+}
+
+
+// -----------------------------------------------------------------------------
+// JSON output, in the name/value/children format of d3-flame-graph.  Values
+// are the max across ranks.
+// -----------------------------------------------------------------------------
+void TimerTree::WriteJSON(const std::string& filename, const Comm_ptr_type& comm)
+{
+  bool consistent;
+  std::vector<Entry> entries = Gather_(comm, consistent);
+  if (comm->MyPID() != 0) return;
+
+  double total = 0.;
+  for (const auto& entry : entries) {
+    if (entry.depth == 0) total += entry.max;
+  }
+
+  std::ofstream os(filename.c_str());
+  os << std::setprecision(8);
+  os << "{" << std::endl
+     << "  \"name\": \"ats\"," << std::endl
+     << "  \"value\": " << total << "," << std::endl
+     << "  \"consistent\": " << (consistent ? "true" : "false") << "," << std::endl
+     << "  \"children\": [";
+  std::size_t i = 0;
+  while (i < entries.size()) {
+    os << (i == 0 ? "" : ",") << std::endl;
+    WriteJSONNode_(os, entries, i, 4);
+  }
+  os << std::endl << "  ]" << std::endl
+     << "}" << std::endl;
+}
+
+
+void TimerTree::WriteJSONNode_(std::ostream& os, const std::vector<Entry>& entries,
+                               std::size_t& i, int indent)
+{
+  const Entry& entry = entries[i];
+  std::string pad(indent, ' ');
+  os << pad << "{ \"name\": \"" << entry.node->name << "::" << entry.node->label << "\","
+     << " \"value\": " << entry.max << ","
+     << " \"count\": " << entry.count << ","
+     << " \"min\": " << entry.min << ","
+     << " \"mean\": " << entry.mean << ","
+     << " \"max\": " << entry.max << ","
+     << " \"children\": [";
+
+  bool first = true;
+  ++i;
+  while (i < entries.size() && entries[i].depth > entry.depth) {
+    os << (first ? "" : ",") << std::endl;
+    first = false;
+    WriteJSONNode_(os, entries, i, indent+2);
+  }
+  if (!first) os << std::endl << pad;
+  os << "] }";
+}
+
+} // namespace Amanzi
@@ -0,0 +1,117 @@
+/* -*-  mode: c++; indent-tabs-mode: nil -*- */
+//! A hierarchical timer for PK and evaluator methods.
+
+/*
+  ATS is released under the three-clause BSD License.
+  The terms of use and "as is" disclaimer for this license are
+  provided in the top-level COPYRIGHT file.
+
+  Authors: Ethan Coon (ecoon@lanl.gov)
+*/
+
+/*!
+
+The TimerTree records wallclock time spent in PK methods (AdvanceStep,
+FunctionalResidual, UpdatePreconditioner, ApplyPreconditioner, ErrorNorm) and
+in evaluator updates.  Timers nest following the call stack, so time spent in
+a sub-PK's residual appears beneath the MPC's residual, which appears beneath
+the AdvanceStep that called the nonlinear solver.
+
+Timing is turned on by the coordinator's `"timer tree`" option.  When off, a
+timed scope costs a single branch.
+
+A method is timed by creating a scope at its top:
+
+.. code-block:: c++
+
+    TimerTree::Scope timer(name_, "FunctionalResidual");
+
+At the end of the simulation, the tree is reported with call counts and the
+min and max time across ranks, and written as a JSON file in the format read
+by flamegraph viewers such as d3-flame-graph and speedscope.
+
+*/
+
+#ifndef ATS_TIMER_TREE_HH_
+#define ATS_TIMER_TREE_HH_
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AmanziComm.hh"
+
+namespace Amanzi {
+
+class TimerTree {
+
+ private:
+  struct Node {
+    Node() : label(nullptr), parent(nullptr), count(0), total(0.) {}
+
+    std::string name;
+    const char* label;
+    Node* parent;
+    std::vector<std::unique_ptr<Node> > children;
+
+    int count;
+    double total;
+    std::chrono::steady_clock::time_point start;
+  };
+
+ public:
+  // RAII timer for one call of a method.
+  class Scope {
+   public:
+    Scope(const std::string& name, const char* label) : node_(nullptr) {
+      if (enabled_) node_ = Start_(name, label);
+    }
+    ~Scope() {
+      if (node_) Stop_(node_);
+    }
+
+    Scope(const Scope& other) = delete;
+    Scope& operator=(const Scope& other) = delete;
+
+   private:
+    Node* node_;
+  };
+
+  static void Enable(bool enabled) { enabled_ = enabled; }
+  static bool enabled() { return enabled_; }
+
+  // Discards all timers, e.g. between runs sharing a process.  No scope may
+  // be open.
+  static void Reset();
+
+  // Collective.  Writes the tree, with counts and min/max across ranks, to os.
+  static void Report(std::ostream& os, const Comm_ptr_type& comm);
+
+  // Collective.  Writes the tree as JSON to filename on rank 0.
+  static void WriteJSON(const std::string& filename, const Comm_ptr_type& comm);
+
+ private:
+  struct Entry {
+    const Node* node;
+    int depth;
+    double min, max, mean;
+    int count;
+  };
+
+  static Node* Start_(const std::string& name, const char* label);
+  static void Stop_(Node* node);
+  static std::vector<Entry> Gather_(const Comm_ptr_type& comm, bool& consistent);
+  static void WriteJSONNode_(std::ostream& os, const std::vector<Entry>& entries,
+                             std::size_t& i, int indent);
+
+ private:
+  static bool enabled_;
+  static Node root_;
+  static Node* current_;
+};
+
+} // namespace Amanzi
+
+#endif
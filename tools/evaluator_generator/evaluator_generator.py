@@ -1,4 +1,5 @@
 import sys,os
+import sympy
 from sympy.printing import ccode
 
 _template_directory = os.path.dirname(os.path.abspath(__file__))
@@ -98,41 +99,59 @@ class EvalGen(object):
     def renderMyMethodDeclarationArgs(self):
         return ", ".join(["double %s"%var for var in self.vars])
 
+    def renderMyKernelArgs(self):
+        return ", ".join(["%s_v[0]"%var for var in self.vars])
+
     def renderEvaluateModel(self):
         d = dict()
         d['keyEpetraVectorList'] = self.renderKeyEpetraVector()
         d['myKeyMethod'] = self.d['myKeyMethod']
         d['myMethodArgs'] = self.renderMyMethodArgs()
+        if self.expression is not None:
+            d['myKernelArgs'] = self.renderMyKernelArgs()
+            return render('evaluator_evaluateModelKernel.cc', d)
         return render('evaluator_evaluateModel.cc', d)
 
-    def renderEvaluateDerivs(self):
-        wrt_list = []
+    def renderEvaluateAllDerivs(self):
+        def wrtMethod(arg):
+            return ''.join([word[0].upper()+word[1:] for word in arg.split("_")])
+
+        d = dict()
+        d['keyEpetraVectorList'] = self.renderKeyEpetraVector()
+        d['myKeyMethod'] = self.d['myKeyMethod']
+        d['myMethodArgs'] = self.renderMyMethodArgs()
+        d['derivPointerList'] = '\n'.join([render('evaluator_derivPointer.cc', dict(var=var)) for var in self.vars])
+
+        assigns = []
+        for k,var in enumerate(self.vars):
+            if k == 0:
+                assigns.append(render('evaluator_ifWRT.cc', dict(var=var)))
+            else:
+                assigns.append(render('evaluator_elseifWRT.cc', dict(var=var)))
+        d['derivAssignList'] = '\n'.join(assigns)
+
+        if self.expression is None:
+            d['derivEvaluateList'] = '\n'.join([render('evaluator_derivEvaluate.cc',
+                                                       dict(var=var, myKeyMethod=self.d['myKeyMethod'],
+                                                            wrtMethod=wrtMethod(arg),
+                                                            myMethodArgs=d['myMethodArgs']))
+                                                for arg,var in zip(self.args,self.vars)])
+            return render('evaluator_evaluateAllDerivs.cc', d)
+
+        # kernel mode: pointers to the data rather than to the vectors
+        d['myKernelArgs'] = self.renderMyKernelArgs()
+        d['nOutputs'] = len(self.vars) + 1
+        d['derivPointerList'] = '\n'.join([render('evaluator_derivPointerKernel.cc', dict(var=var)) for var in self.vars])
+        d['derivAssignList'] = d['derivAssignList'].replace("_v = dresult_v;", "_p = dresult_p;")
+        d['derivSingleKernelList'] = '\n'.join([render('evaluator_derivSingleKernel.cc',
+                                                       dict(var=var, myKeyMethod=self.d['myKeyMethod'],
+                                                            wrtMethod=wrtMethod(arg),
+                                                            myKernelArgs=d['myKernelArgs']))
+                                                for arg,var in zip(self.args,self.vars)])
+        d['derivScratchList'] = '\n'.join([render('evaluator_derivScratchKernel.cc', dict(var=var)) for var in self.vars])
+        d['derivKernelOutputs'] = ", ".join(["d%s_p"%var for var in self.vars])
+        return render('evaluator_evaluateAllDerivsKernel.cc', d)
 
-        def getDict(arg,var):
-            d = dict(arg=arg,var=var)
-            d['keyEpetraVectorList'] = self.renderKeyEpetraVectorIndented()
-            d['myKeyMethod'] = self.d['myKeyMethod']
-            d['wrtMethod'] = ''.join([word[0].upper()+word[1:] for word in arg.split("_")])
-            d['myMethodArgs'] = self.renderMyMethodArgs()
-            return d
-        
-        if len(self.args) > 0:
-            d = getDict(self.args[0], self.vars[0])
-            d['if_elseif'] = render('evaluator_ifWRT.cc', d)
-            wrt_list.append(render('evaluator_evaluateDerivs.cc', d))
-
-        if len(self.args) > 1:
-            for arg,var in zip(self.args[1:],self.vars[1:]):
-                d = getDict(arg,var)
-                d['if_elseif'] = render('evaluator_elseifWRT.cc', d)
-                wrt_list.append(render('evaluator_evaluateDerivs.cc', d))
-
-        wrt_list.append('\n'.join(["  } else {",
-                                   "    ASSERT(0);",
-                                   "  }"]))
-
-        return "\n\n".join(wrt_list)
-                            
     def renderModelMethodDeclaration(self):
         return render('model_declaration.hh', dict(myMethod=self.d['myKeyMethod'],
                                                    myMethodDeclarationArgs=self.d['myMethodDeclarationArgs']))
@@ -168,6 +187,60 @@ class EvalGen(object):
                                      myMethodImplementation=implementation)))
         return '\n\n'.join(impls)
     
+    def kernelOutputs(self):
+        """List of (method name, output names, expressions) for the array kernels."""
+        if self.expression is None:
+            return []
+
+        # the i-th entry of each argument array
+        entries = dict((sympy.Symbol(var), sympy.Symbol("%s[i]"%var)) for var in self.vars)
+        value = self.expression.subs(entries)
+        derivs = [self.expression.diff(var).subs(entries) for var in self.vars]
+
+        kernels = [("%sKernel"%self.d['myKeyMethod'], ["result"], [value])]
+        for arg,deriv in zip(self.args,derivs):
+            kernels.append(("D%sD%sKernel"%(self.d['myKeyMethod'],''.join([word[0].upper()+word[1:] for word in arg.split("_")])),
+                            ["result"], [deriv]))
+        kernels.append(("%sAllKernel"%self.d['myKeyMethod'],
+                        ["result"]+["d%s"%var for var in self.vars], [value]+derivs))
+        return kernels
+
+    def renderKernelDeclarationArgs(self, outputs):
+        return ", ".join(["int n"] +
+                         ["const double* __restrict__ %s"%var for var in self.vars] +
+                         ["double* __restrict__ %s"%out for out in outputs])
+
+    def renderModelKernelDeclarations(self):
+        kernels = self.kernelOutputs()
+        if len(kernels) == 0:
+            return ""
+        decls = '\n'.join([render('model_kernelDeclaration.hh',
+                                  dict(myMethod=name,
+                                       kernelDeclarationArgs=self.renderKernelDeclarationArgs(outputs)))
+                           for name,outputs,exprs in kernels])
+        return render('model_kernelDeclarationList.hh', dict(kernelDeclarationList=decls))
+
+    def renderModelKernelImplementations(self):
+        impls = []
+        for name,outputs,exprs in self.kernelOutputs():
+            # common subexpressions are shared by all outputs of a kernel
+            cses, reduced = sympy.cse(exprs, symbols=sympy.numbered_symbols("cse"))
+            body = ['    const double %s = %s;'%(ccode(sym), ccode(expr)) for sym,expr in cses]
+            body.extend(['    %s[i] = %s;'%(out, ccode(expr)) for out,expr in zip(outputs,reduced)])
+            impls.append(render('model_kernelImplementation.cc',
+                                dict(evalClassName=self.d['evalClassName'],
+                                     myMethod=name,
+                                     kernelDeclarationArgs=self.renderKernelDeclarationArgs(outputs),
+                                     kernelBody='\n'.join(body))))
+        if len(impls) == 0:
+            return ""
+        return render('model_kernelImplementationList.cc', dict(kernelImplementationList='\n\n'.join(impls)))
+
+    def renderKernelWorkspaceDeclaration(self):
+        if self.expression is None:
+            return ""
+        return render('evaluator_kernelWorkspaceDeclaration.hh', dict())
+
     def renderModelParamDeclarations(self):
         return '\n'.join(['  %s %s;'%p for p in self.pars])
 
@@ -191,7 +264,7 @@ class EvalGen(object):
         self.d['myMethodArgs'] = self.renderMyMethodArgs()
         self.d['myMethodDeclarationArgs'] = self.renderMyMethodDeclarationArgs()
         self.d['evaluateModel'] = self.renderEvaluateModel()
-        self.d['evaluateDerivs'] = self.renderEvaluateDerivs()
+        self.d['evaluateAllDerivs'] = self.renderEvaluateAllDerivs()
 
         self.d['modelMethodDeclaration'] = self.renderModelMethodDeclaration()
         self.d['modelDerivDeclarationList'] = self.renderModelDerivDeclarations()
@@ -199,6 +272,9 @@ class EvalGen(object):
 
         self.d['modelMethodImplementation'] = self.renderModelMethodImplementation()
         self.d['modelDerivImplementationList'] = self.renderModelDerivImplementations()
+        self.d['modelKernelDeclarationList'] = self.renderModelKernelDeclarations()
+        self.d['modelKernelImplementationList'] = self.renderModelKernelImplementations()
+        self.d['kernelWorkspaceDeclaration'] = self.renderKernelWorkspaceDeclaration()
         self.d['modelInitializeParamsList'] = self.renderModelParamInitializations()
 
 def generate_evaluator(name, namespace, descriptor, my_key, dependencies, parameters, **kwargs):
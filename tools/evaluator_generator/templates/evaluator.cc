@@ -63,9 +63,82 @@ void
 {evalClassName}Evaluator::EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
         Key wrt_key, const Teuchos::Ptr<CompositeVector>& result)
 {{
+  std::vector<Key> wrt_keys(1, wrt_key);
+  std::vector<Teuchos::Ptr<CompositeVector> > dresults(1, result);
+  EvaluateFieldPartialDerivatives_(S, Teuchos::null, wrt_keys, dresults);
+}}
+
+
+// Value and partial derivatives in one sweep, so that the dependencies are
+// fetched and read only once.
+void
+{evalClassName}Evaluator::EvaluateFieldPartialDerivatives_(const Teuchos::Ptr<State>& S,
+        const Teuchos::Ptr<CompositeVector>& result,
+        const std::vector<Key>& wrt_keys,
+        const std::vector<Teuchos::Ptr<CompositeVector> >& dresults)
+{{
+  AMANZI_ASSERT(wrt_keys.size() == dresults.size());
+  if (result == Teuchos::null && wrt_keys.size() == 0) return;
+  const CompositeVector& space = result != Teuchos::null ? *result : *dresults[0];
+
 {keyCompositeVectorList}
 
-{evaluateDerivs}
+{evaluateAllDerivs}
+}}
+
+
+// The chain rule over all dependencies that depend upon wrt_key, with the
+// partial derivatives with respect to all of them computed at once.
+void
+{evalClassName}Evaluator::UpdateFieldDerivative_(const Teuchos::Ptr<State>& S,
+        Key wrt_key)
+{{
+  Key dmy_key = Keys::getDerivKey(my_key_, wrt_key);
+
+  Teuchos::RCP<CompositeVector> dmy;
+  if (S->HasField(dmy_key)) {{
+    // Get the field...
+    dmy = S->GetFieldData(dmy_key, my_key_);
+  }} else {{
+    // or create the field.  Note we have to do extra work that is normally
+    // done by State in initialize.
+    Teuchos::RCP<CompositeVectorSpace> my_fac = S->RequireField(my_key_);
+    Teuchos::RCP<CompositeVectorSpace> new_fac =
+      S->RequireField(dmy_key, my_key_);
+    new_fac->Update(*my_fac);
+    dmy = Teuchos::rcp(new CompositeVector(*my_fac));
+    S->SetData(dmy_key, my_key_, dmy);
+    S->GetField(dmy_key,my_key_)->set_initialized();
+    S->GetField(dmy_key,my_key_)->set_io_vis(false);
+    S->GetField(dmy_key,my_key_)->set_io_checkpoint(false);
+  }}
+
+  // partial F / partial dep for every dep on the path to wrt_key
+  std::vector<Key> wrt_keys;
+  std::vector<Teuchos::Ptr<CompositeVector> > dresults;
+  for (KeySet::const_iterator dep=dependencies_.begin();
+       dep!=dependencies_.end(); ++dep) {{
+    if (wrt_key == *dep || S->GetFieldEvaluator(*dep)->IsDependency(S, wrt_key)) {{
+      if (partials_.size() == wrt_keys.size())
+        partials_.push_back(Teuchos::rcp(new CompositeVector(*dmy)));
+      dresults.push_back(partials_[wrt_keys.size()].ptr());
+      wrt_keys.push_back(*dep);
+    }}
+  }}
+  EvaluateFieldPartialDerivatives_(S, Teuchos::null, wrt_keys, dresults);
+
+  dmy->PutScalar(0.);
+  for (int k=0; k!=wrt_keys.size(); ++k) {{
+    if (wrt_keys[k] == wrt_key) {{
+      // partial F / partial x
+      dmy->Update(1., *dresults[k], 1.);
+    }} else {{
+      // partial F / partial dep * ddep/dx
+      Teuchos::RCP<const CompositeVector> ddep =
+          S->GetFieldData(Keys::getDerivKey(wrt_keys[k], wrt_key));
+      dmy->Multiply(1., *ddep, *dresults[k], 1.);
+    }}
+  }}
 }}
 
 
@@ -10,6 +10,8 @@
 #ifndef AMANZI_{namespaceCaps}_{evalNameCaps}_EVALUATOR_HH_
 #define AMANZI_{namespaceCaps}_{evalNameCaps}_EVALUATOR_HH_
 
+#include <vector>
+
 #include "Factory.hh"
 #include "secondary_variable_field_evaluator.hh"
 
@@ -34,6 +36,16 @@ class {evalClassName}Evaluator : public SecondaryVariableFieldEvaluator {{
   virtual void EvaluateFieldPartialDerivative_(const Teuchos::Ptr<State>& S,
           Key wrt_key, const Teuchos::Ptr<CompositeVector>& result);
 
+  // Evaluates, in one sweep over the cells, the value (if result is not
+  // null) and the partial derivatives with respect to each of wrt_keys.
+  void EvaluateFieldPartialDerivatives_(const Teuchos::Ptr<State>& S,
+          const Teuchos::Ptr<CompositeVector>& result,
+          const std::vector<Key>& wrt_keys,
+          const std::vector<Teuchos::Ptr<CompositeVector> >& dresults);
+
+  // Computes all partial derivatives needed by the chain rule at once.
+  virtual void UpdateFieldDerivative_(const Teuchos::Ptr<State>& S, Key wrt_key);
+
   Teuchos::RCP<{evalClassName}Model> get_model() {{ return model_; }}
 
  protected:
@@ -43,6 +55,10 @@ class {evalClassName}Evaluator : public SecondaryVariableFieldEvaluator {{
 
   Teuchos::RCP<{evalClassName}Model> model_;
 
+  // workspace for the partial derivatives, one per dependency
+  std::vector<Teuchos::RCP<CompositeVector> > partials_;
+{kernelWorkspaceDeclaration}
+
  private:
   static Utils::RegisteredFactory<FieldEvaluator,{evalClassName}Evaluator> reg_;
 
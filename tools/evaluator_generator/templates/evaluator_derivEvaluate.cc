@@ -0,0 +1 @@
+      if (d{var}_v) (*d{var}_v)[0][i] = model_->D{myKeyMethod}D{wrtMethod}({myMethodArgs});
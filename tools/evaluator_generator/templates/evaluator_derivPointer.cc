@@ -0,0 +1 @@
+    Epetra_MultiVector* d{var}_v = NULL;
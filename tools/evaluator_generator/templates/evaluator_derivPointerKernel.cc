@@ -0,0 +1 @@
+    double* d{var}_p = NULL;
@@ -0,0 +1 @@
+      if (!d{var}_p) d{var}_p = &scratch_[ncomp * nscratch++];
@@ -0,0 +1 @@
+      else if (d{var}_p) model_->D{myKeyMethod}D{wrtMethod}Kernel(ncomp, {myKernelArgs}, d{var}_p);
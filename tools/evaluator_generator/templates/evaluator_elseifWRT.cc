@@ -1 +1,2 @@
-  }} else if (wrt_key == {var}_key_) {{
+      }} else if (wrt_keys[k] == {var}_key_) {{
+        d{var}_v = dresult_v;
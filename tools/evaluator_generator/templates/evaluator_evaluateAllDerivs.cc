@@ -0,0 +1,22 @@
+  for (CompositeVector::name_iterator comp=space.begin();
+       comp!=space.end(); ++comp) {{
+{keyEpetraVectorList}
+    Epetra_MultiVector* result_v = result != Teuchos::null ?
+        result->ViewComponent(*comp,false).get() : NULL;
+
+    // requested partial derivatives, NULL if not requested
+{derivPointerList}
+    for (int k=0; k!=wrt_keys.size(); ++k) {{
+      Epetra_MultiVector* dresult_v = dresults[k]->ViewComponent(*comp,false).get();
+{derivAssignList}
+      }} else {{
+        AMANZI_ASSERT(0);
+      }}
+    }}
+
+    int ncomp = space.size(*comp, false);
+    for (int i=0; i!=ncomp; ++i) {{
+      if (result_v) (*result_v)[0][i] = model_->{myKeyMethod}({myMethodArgs});
+{derivEvaluateList}
+    }}
+  }}
@@ -0,0 +1,33 @@
+  for (CompositeVector::name_iterator comp=space.begin();
+       comp!=space.end(); ++comp) {{
+    int ncomp = space.size(*comp, false);
+    if (ncomp == 0) continue;
+
+{keyEpetraVectorList}
+
+    // requested outputs, NULL if not requested
+    double* result_p = result != Teuchos::null ?
+        (*result->ViewComponent(*comp,false))[0] : NULL;
+{derivPointerList}
+    for (int k=0; k!=wrt_keys.size(); ++k) {{
+      double* dresult_p = (*dresults[k]->ViewComponent(*comp,false))[0];
+{derivAssignList}
+      }} else {{
+        AMANZI_ASSERT(0);
+      }}
+    }}
+
+    if (wrt_keys.size() + (result_p ? 1 : 0) == 1) {{
+      // a single output, from its own kernel
+      if (result_p) model_->{myKeyMethod}Kernel(ncomp, {myKernelArgs}, result_p);
+{derivSingleKernelList}
+    }} else {{
+      // all outputs from one kernel, which shares common subexpressions
+      // between them, with those not requested written to workspace
+      scratch_.resize({nOutputs} * ncomp);
+      int nscratch = 0;
+      if (!result_p) result_p = &scratch_[ncomp * nscratch++];
+{derivScratchList}
+      model_->{myKeyMethod}AllKernel(ncomp, {myKernelArgs}, result_p, {derivKernelOutputs});
+    }}
+  }}
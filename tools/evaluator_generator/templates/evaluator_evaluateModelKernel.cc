@@ -0,0 +1,8 @@
+  for (CompositeVector::name_iterator comp=result->begin();
+       comp!=result->end(); ++comp) {{
+{keyEpetraVectorList}
+    Epetra_MultiVector& result_v = *result->ViewComponent(*comp,false);
+
+    int ncomp = result->size(*comp, false);
+    model_->{myKeyMethod}Kernel(ncomp, {myKernelArgs}, result_v[0]);
+  }}
@@ -1 +1,2 @@
-  if (wrt_key == {var}_key_) {{
+      if (wrt_keys[k] == {var}_key_) {{
+        d{var}_v = dresult_v;
@@ -0,0 +1,2 @@
+  // workspace for outputs of the array kernels that were not requested
+  std::vector<double> scratch_;
@@ -34,6 +34,7 @@ void
 {modelMethodImplementation}
 
 {modelDerivImplementationList}
+{modelKernelImplementationList}
 
 }} //namespace
 }} //namespace
@@ -23,6 +23,7 @@ class {evalClassName}Model {{
 {modelMethodDeclaration}
 
 {modelDerivDeclarationList}
+{modelKernelDeclarationList}
   
  protected:
   void InitializeFromPlist_(Teuchos::ParameterList& plist);
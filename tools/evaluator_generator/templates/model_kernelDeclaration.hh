@@ -0,0 +1 @@
+  void {myMethod}({kernelDeclarationArgs}) const;
@@ -0,0 +1,4 @@
+
+  // Array kernels over n entries of each argument, free of branches so that
+  // they vectorize.  The outputs may not alias the arguments.
+{kernelDeclarationList}
@@ -0,0 +1,7 @@
+void
+{evalClassName}Model::{myMethod}({kernelDeclarationArgs}) const
+{{
+  for (int i=0; i!=n; ++i) {{
+{kernelBody}
+  }}
+}}
@@ -0,0 +1,3 @@
+
+// array kernels
+{kernelImplementationList}